@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace benchmarks
+{
+    /**
+     *  Timings of a repeatedly measured operation in microseconds.
+     */
+    struct measurement
+    {
+        std::string name;
+        std::vector <double> samples;
+
+        double percentile(double p) const
+        {
+            if (samples.empty())
+                return 0.;
+
+            auto sorted = samples;
+            std::sort(std::begin(sorted), std::end(sorted));
+            auto index = static_cast <std::size_t> (p / 100. * static_cast <double> (sorted.size() - 1));
+            return sorted[index];
+        }
+
+        double mean() const
+        {
+            if (samples.empty())
+                return 0.;
+
+            double sum = 0.;
+            for (auto const& s : samples)
+                sum += s;
+            return sum / static_cast <double> (samples.size());
+        }
+    };
+
+    /**
+     *  Runs fn the given amount of times and records every run.
+     */
+    template <typename FunctionT>
+    measurement measure(std::string name, std::size_t iterations, FunctionT&& fn)
+    {
+        measurement result{std::move(name), {}};
+        result.samples.reserve(iterations);
+
+        for (std::size_t i = 0; i != iterations; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            fn(i);
+            auto end = std::chrono::steady_clock::now();
+            result.samples.push_back(std::chrono::duration <double, std::micro> (end - start).count());
+        }
+        return result;
+    }
+
+    inline void report(measurement const& m)
+    {
+        std::cout
+            << std::left << std::setw(48) << m.name
+            << std::right << std::fixed << std::setprecision(2)
+            << " mean " << std::setw(12) << m.mean() << "us"
+            << " p50 " << std::setw(12) << m.percentile(50) << "us"
+            << " p99 " << std::setw(12) << m.percentile(99) << "us"
+            << "\n"
+        ;
+    }
+
+    /**
+     *  Reports how fast bytes were processed in total.
+     */
+    inline void report_throughput(std::string const& name, std::size_t bytes, double microseconds)
+    {
+        std::cout
+            << std::left << std::setw(48) << name
+            << std::right << std::fixed << std::setprecision(2)
+            << " " << std::setw(12) << static_cast <double> (bytes) / microseconds << "MB/s"
+            << " total " << std::setw(12) << microseconds / 1000. << "ms"
+            << "\n"
+        ;
+    }
+}
@@ -0,0 +1,16 @@
+#include "render_benchmarks.hpp"
+#include "styler_benchmarks.hpp"
+
+#include <string_view>
+
+int main(int argc, char** argv)
+{
+    // --large adds a 1 GB corpus to the styler benchmarks.
+    bool large = false;
+    for (int i = 1; i < argc; ++i)
+        large = large || std::string_view{argv[i]} == "--large";
+
+    benchmarks::run_render_benchmarks();
+    benchmarks::run_styler_benchmarks(large);
+    return 0;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "benchmark_base.hpp"
+
+#include <nana-source-view/skeleton/text_renderer.hpp>
+#include <nana-source-view/skeleton/paint_sink.hpp>
+
+#include <string>
+
+namespace benchmarks
+{
+    inline std::string make_render_corpus(std::size_t lines)
+    {
+        std::string text;
+        for (std::size_t i = 0; i != lines; ++i)
+        {
+            text += std::string(i % 5 * 4, ' ');
+            text += "auto value_" + std::to_string(i) + " = compute(left, right) * factor; // comment\n";
+        }
+        return text;
+    }
+
+    /**
+     *  Renders full frames headlessly. The recording sink measures with fixed glyph sizes,
+     *  so the amount of draw calls is deterministic and comparable between runs.
+     */
+    inline void run_render_benchmarks()
+    {
+        using namespace nana_source_view;
+
+        for (std::size_t lines : {1'000u, 100'000u, 1'000'000u})
+        {
+            data_store store{make_render_corpus(lines)};
+            skeletons::text_renderer renderer{&store};
+            skeletons::recording_paint_sink sink{{8, 16}};
+
+            renderer.text_area({0, 0, 1920, 1080});
+
+            auto m = measure("render frame, " + std::to_string(lines) + " lines", 200, [&](std::size_t i)
+            {
+                renderer.update_scroll(static_cast <data_store::index_type> ((i * 7919) % lines));
+                renderer.render(sink);
+            });
+            report(m);
+
+            std::cout
+                << "    draw calls/frame: " << sink.stats().draw_calls / 200
+                << ", text runs/frame: " << sink.stats().text_runs / 200
+                << ", text bytes/frame: " << sink.stats().text_bytes / 200
+                << "\n"
+            ;
+        }
+
+        // one selected word per line, selection rendering must only sweep the visible carets.
+        {
+            constexpr std::size_t lines = 1'000'000;
+            data_store store{make_render_corpus(lines)};
+            store.remove_caret(store.caret_begin());
+            for (std::size_t line = 0; line != lines; ++line)
+            {
+                auto const start = store.index_from_line(static_cast <data_store::index_type> (line));
+                store.add_caret(start + 5, 10);
+                store.add_caret(start + 15, 4);
+            }
+
+            skeletons::text_renderer renderer{&store};
+            skeletons::recording_paint_sink sink{{8, 16}};
+            renderer.text_area({0, 0, 1920, 1080});
+
+            auto m = measure("render frame, " + std::to_string(store.caret_count()) + " carets", 200, [&](std::size_t i)
+            {
+                renderer.update_scroll(static_cast <data_store::index_type> ((i * 7919) % lines));
+                renderer.render(sink);
+            });
+            report(m);
+
+            std::cout << "    rectangles/frame: " << sink.stats().rectangles / 200 << "\n";
+        }
+    }
+}
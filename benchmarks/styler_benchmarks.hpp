@@ -0,0 +1,212 @@
+#pragma once
+
+#include "benchmark_base.hpp"
+
+#include <nana-source-view/c_styler.hpp>
+#include <nana-source-view/rule_styler.hpp>
+
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace benchmarks
+{
+    /**
+     *  Generates C++ that looks like real code: includes, doc comments, structs and functions with nested blocks,
+     *  strings with escapes, character literals and numbers. Deterministic for a seed.
+     */
+    inline std::string make_c_corpus(std::size_t bytes, std::uint32_t seed = 1)
+    {
+        std::mt19937 rng{seed};
+        auto pick = [&rng](auto const& options) -> std::string
+        {
+            return options[rng() % std::size(options)];
+        };
+
+        static char const* const types[] = {"int", "unsigned", "char const*", "std::size_t", "double", "auto", "widget&"};
+        static char const* const names[] = {"value", "count", "index", "buffer", "left", "right", "state", "result"};
+        static char const* const calls[] = {"compute", "std::min", "update_state", "printf", "store.insert", "lookup"};
+
+        std::string text;
+        text.reserve(bytes + 4096);
+
+        std::size_t unit = 0;
+        while (text.size() < bytes)
+        {
+            auto const n = std::to_string(unit++);
+            switch (rng() % 8)
+            {
+                case 0:
+                    text += "#include <module_" + n + "/header.hpp>\n#define LIMIT_" + n + " 0x" + std::to_string(rng() % 4096) + "\n\n";
+                    break;
+                case 1:
+                    text += "/**\n *  Computes the " + pick(names) + " of a " + pick(names) + ".\n *  Returns -1 on failure.\n */\n";
+                    break;
+                case 2:
+                    text += "struct record_" + n + "\n{\n";
+                    for (auto i = rng() % 6; i != 0; --i)
+                        text += "    " + pick(types) + " " + pick(names) + "_" + std::to_string(i) + "; // field\n";
+                    text += "};\n\n";
+                    break;
+                default:
+                {
+                    text += "static " + pick(types) + " function_" + n + "(" + pick(types) + " " + pick(names) + ", int flags)\n{\n";
+                    auto const statements = 3 + rng() % 12;
+                    int depth = 1;
+                    for (std::size_t s = 0; s != statements; ++s)
+                    {
+                        auto const indent = std::string(static_cast <std::size_t> (depth) * 4, ' ');
+                        switch (rng() % 6)
+                        {
+                            case 0:
+                                text += indent + "if (" + pick(names) + " > " + std::to_string(rng() % 1000) + " && flags & 0x4)\n" + indent + "{\n";
+                                ++depth;
+                                break;
+                            case 1:
+                                text += indent + "printf(\"" + pick(names) + " = %d\\n\", " + pick(names) + "); /* trace */\n";
+                                break;
+                            case 2:
+                                text += indent + "auto " + pick(names) + "_" + n + " = " + pick(calls) + "(" + pick(names) + ", '" + static_cast <char> ('a' + rng() % 26) + "');\n";
+                                break;
+                            case 3:
+                                text += indent + pick(names) + " += " + std::to_string(rng() % 100) + "." + std::to_string(rng() % 100) + "f * " + pick(names) + "[" + std::to_string(rng() % 16) + "];\n";
+                                break;
+                            case 4:
+                                if (depth > 1)
+                                {
+                                    --depth;
+                                    text += std::string(static_cast <std::size_t> (depth) * 4, ' ') + "}\n";
+                                    break;
+                                }
+                                [[fallthrough]];
+                            default:
+                                text += indent + "// " + pick(calls) + " must not throw here\n";
+                                break;
+                        }
+                    }
+                    for (; depth > 1; --depth)
+                        text += std::string(static_cast <std::size_t> (depth - 1) * 4, ' ') + "}\n";
+                    text += "    return " + pick(names) + ";\n}\n\n";
+                    break;
+                }
+            }
+        }
+        return text;
+    }
+
+    /**
+     *  A C like language for the rule styler, comparable to what c_style highlights.
+     */
+    inline nana_source_view::styles::rule_set make_c_rules()
+    {
+        auto look = [](unsigned rgb)
+        {
+            return nana_source_view::style{static_cast <nana::color_rgb> (rgb), static_cast <nana::color_rgb> (0x1E1E1E), 0};
+        };
+        return {
+            {
+                {"if|else|for|while|return|static|struct|auto|int|unsigned|char|double|const", look(0x569CD6)},
+                {"[A-Za-z_]\\w*", std::nullopt},
+                {"0x[0-9A-Fa-f]+|\\d+(\\.\\d+)?f?", look(0xB5CEA8)},
+                {"#[a-z]+", look(0xC586C0)}
+            },
+            {
+                {"/\\*", "\\*/", look(0x6A9955), {}},
+                {"//", "", look(0x6A9955), {}},
+                {"\"", "\"", look(0xCE9178), {{"\\\\.", look(0xD7BA7D)}}, true},
+                {"'", "'", look(0xCE9178), {{"\\\\.", look(0xD7BA7D)}}, true}
+            }
+        };
+    }
+
+    /**
+     *  Measures a styler through the styler interface only:
+     *  - initialize over the whole document, as throughput.
+     *  - on_multi_line_change after typing a single byte at a random position, as latency.
+     *  - styles_on_lines for a screenful of lines at a random position, as latency.
+     */
+    inline void run_styler_benchmark
+    (
+        std::string const& name,
+        std::string const& corpus,
+        std::function <std::unique_ptr <nana_source_view::styler> (nana_source_view::data_store const*)> const& make
+    )
+    {
+        using namespace nana_source_view;
+        using index_type = data_store::index_type;
+
+        constexpr std::size_t edits = 2'000;
+        constexpr std::size_t queries = 2'000;
+        constexpr index_type screen_lines = 60;
+
+        auto const megabytes = std::to_string(corpus.size() / 1'000'000) + " MB";
+        data_store store{corpus};
+        auto sty = make(&store);
+
+        auto const start = std::chrono::steady_clock::now();
+        sty->initialize();
+        auto const end = std::chrono::steady_clock::now();
+        report_throughput(name + " initialize, " + megabytes, corpus.size(), std::chrono::duration <double, std::micro> (end - start).count());
+
+        // typing mostly continues identifiers, sometimes it opens or closes something.
+        static constexpr char typed[] = "abcxyz_019 (){};\"'/*";
+        std::mt19937 rng{7};
+        measurement edit{name + " single byte edit, " + megabytes, {}};
+        edit.samples.reserve(edits);
+        for (std::size_t i = 0; i != edits; ++i)
+        {
+            auto const offset = static_cast <index_type> (rng() % store.size());
+            store.remove_caret(store.caret_begin());
+            store.add_caret(offset);
+            store.insert_byte(typed[rng() % (sizeof(typed) - 1)]);
+
+            auto const line = store.line_from_index(offset);
+            auto const before = std::chrono::steady_clock::now();
+            sty->on_multi_line_change(line, line + 1);
+            auto const after = std::chrono::steady_clock::now();
+            edit.samples.push_back(std::chrono::duration <double, std::micro> (after - before).count());
+        }
+        report(edit);
+
+        auto const line_count = static_cast <index_type> (store.line_count());
+        std::size_t styled_bytes = 0;
+        auto query = measure(name + " styles of a screen, " + megabytes, queries, [&](std::size_t)
+        {
+            auto const first = static_cast <index_type> (rng() % static_cast <std::uint32_t> (line_count));
+            for (auto const& range : sty->styles_on_lines(first, std::min(first + screen_lines, line_count)))
+                styled_bytes += range.length;
+        });
+        report(query);
+        std::cout << "    styled bytes/screen: " << styled_bytes / queries << "\n";
+    }
+
+    /**
+     * @param large Also measures a 1 GB corpus, which needs several GB of memory.
+     */
+    inline void run_styler_benchmarks(bool large)
+    {
+        using namespace nana_source_view;
+
+        std::vector <std::size_t> sizes{1'000'000, 16'000'000, 128'000'000};
+        if (large)
+            sizes.push_back(1'000'000'000);
+
+        for (auto const size : sizes)
+        {
+            auto const corpus = make_c_corpus(size);
+
+            run_styler_benchmark("c_style", corpus, [](data_store const* store)
+            {
+                return std::make_unique <styles::c_style> (store);
+            });
+
+            run_styler_benchmark("rule_style", corpus, [](data_store const* store)
+            {
+                return std::make_unique <styles::rule_style> (store, make_c_rules());
+            });
+        }
+    }
+}
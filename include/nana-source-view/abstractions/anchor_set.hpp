@@ -0,0 +1,124 @@
+#pragma once
+
+#include "detail/implicit_treap.hpp"
+#include "../interfaces/edit_observer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nana_source_view
+{
+    /**
+     *  A range of bytes that follows edits, like a diagnostic, a search hit or a bookmark.
+     */
+    struct anchored_range
+    {
+        using index_type = edit_delta::index_type;
+
+        index_type begin;
+        index_type end;
+
+        /// Chosen by the owner, to tell what the range stands for.
+        std::uint32_t tag;
+
+        bool operator==(anchored_range const& other) const
+        {
+            return begin == other.begin && end == other.end && tag == other.tag;
+        }
+    };
+
+    /**
+     *  Ranges over the text that shift and shrink with every edit.
+     *
+     *  The ranges are sorted by begin in a treap. A range does not store its begin, but the distance to the begin
+     *  of the range in front of it. So an edit moves all ranges behind it by changing a single distance,
+     *  only ranges that overlap the edit are touched. An edit costs O(log n + overlapping ranges).
+     *
+     *  Edges: Text inserted at the begin of a range is put in front of it, text inserted at its end behind it.
+     *  A range that is removed entirely collapses to an empty range where the removal happened.
+     */
+    class anchor_set : public edit_observer
+    {
+    public:
+        using index_type = anchored_range::index_type;
+
+    public:
+        anchor_set();
+
+        void on_edit(std::vector <edit_delta> const& deltas) override;
+
+        /**
+         *  Replaces all ranges. They need not be sorted.
+         */
+        void assign(std::vector <anchored_range> ranges);
+
+        /**
+         *  Adds a range in O(log n).
+         */
+        void insert(anchored_range const& range);
+
+        /**
+         * @brief remove Removes the ranges with tag that overlap [begin, end).
+         * @return The amount of removed ranges.
+         */
+        std::size_t remove(index_type begin, index_type end, std::uint32_t tag);
+
+        /**
+         * @brief overlapping The ranges that overlap [begin, end), like the visible part of the text.
+         *        Empty ranges count if they are within [begin, end).
+         * @return Sorted by begin.
+         */
+        std::vector <anchored_range> overlapping(index_type begin, index_type end) const;
+
+        std::size_t size() const;
+        bool empty() const;
+        void clear();
+
+    private:
+        /**
+         *  A range, relative to the begin of the one in front of it.
+         */
+        struct anchor
+        {
+            index_type gap;
+            index_type length;
+            std::uint32_t tag;
+        };
+
+        struct extent
+        {
+            /// The sum of all gaps, which is the begin of the last range relative to the begin in front of the first.
+            index_type sum;
+
+            /// The furthest end, relative like sum.
+            index_type furthest_end;
+        };
+
+        struct extent_traits
+        {
+            using summary_type = extent;
+
+            static extent identity();
+            static extent summarize(anchor const& a);
+            static extent combine(extent const& lhs, extent const& rhs);
+        };
+
+        /**
+         *  The index of the first range that begins at or behind offset, or size().
+         */
+        std::size_t first_at(index_type offset) const;
+
+        /**
+         *  Calls found(index, begin, end) for every range of index >= from that ends at or behind offset.
+         *  Stops when found returns false.
+         */
+        template <typename FunctionT>
+        void visit_ending_behind(std::size_t from, index_type offset, FunctionT&& found) const;
+
+        void apply(edit_delta const& delta);
+
+    private:
+        detail::implicit_treap <anchor, extent_traits> anchors_;
+    };
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "store.hpp"
+#include "anchor_set.hpp"
+#include "../interfaces/edit_observer.hpp"
+#include "../lexing/automaton.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace nana_source_view
+{
+    /**
+     *  Searches a pattern on a worker thread, so the editor stays responsive on large documents.
+     *
+     *  The worker searches a snapshot of the store and hands matches over in batches, as soon as a slice of the
+     *  snapshot is done. The owner collects them with poll on its own thread, where they are put into an anchor set
+     *  that follows all edits from then on. A new search or an edit cancels the running one without waiting for it,
+     *  the worker notices within a few bytes and owns everything it still uses.
+     *  The snapshot is kept and follows edits, so neither refining a query nor editing copies the document again.
+     *  Only if an edit comes while a cancelled worker still reads the snapshot, the next search copies it.
+     *
+     *  Patterns use the syntax of lexing::automaton_builder. They are compiled into a deterministic automaton.
+     *  Matches are the leftmost longest and do not overlap. The automaton runs from all starts at once, keeping
+     *  the leftmost start per state, so a start that does not match costs no extra pass over the text.
+     *  Where a longer match failed behind a match is remembered, so the bytes behind a match are only followed
+     *  again in states that were not seen failing there.
+     *
+     *  The search is not registered as an observer of the store, the owner does that.
+     */
+    class background_search : public edit_observer
+    {
+    public:
+        explicit background_search(data_store const* store);
+        ~background_search();
+
+        background_search(background_search const&) = delete;
+        background_search& operator=(background_search const&) = delete;
+
+        /**
+         * @brief start Cancels the running search and starts searching for pattern.
+         * @throws std::invalid_argument If the pattern is malformed. The running search continues then.
+         */
+        void start(std::string_view pattern);
+
+        /**
+         * @brief cancel Stops the running search without waiting for the worker.
+         *        Matches found so far and not polled are dropped, on_progress is not called anymore.
+         */
+        void cancel();
+
+        /**
+         * @brief poll Moves the matches the worker found since the last poll into results.
+         * @return The amount of new matches.
+         */
+        std::size_t poll();
+
+        /**
+         * @brief running Is the worker still searching, or are there found matches left to poll?
+         */
+        bool running() const;
+
+        /**
+         * @brief results All polled matches. They follow edits.
+         */
+        anchor_set const& results() const;
+
+        /**
+         * @brief on_progress Called on the worker thread after it handed over matches and when it is done.
+         *        Only meant to wake up the owner, everything else has to happen in poll.
+         *        Takes effect with the next start.
+         */
+        void on_progress(std::function <void()> notify);
+
+        /**
+         * @brief on_edit Keeps the results of the running search and cancels it, the snapshot is outdated.
+         */
+        void on_edit(std::vector <edit_delta> const& deltas) override;
+
+    private:
+        /**
+         *  Shared between the owner and the worker of one search.
+         */
+        struct job
+        {
+            std::mutex mutex;
+            std::vector <anchored_range> found;
+            bool finished = false;
+            std::atomic <bool> cancelled{false};
+        };
+
+        static void run
+        (
+            std::shared_ptr <job> state,
+            std::shared_ptr <std::string const> snapshot,
+            lexing::automaton const& pattern,
+            std::function <void()> const& notify
+        );
+
+    private:
+        data_store const* store_;
+        std::shared_ptr <std::string> snapshot_;
+        std::shared_ptr <job> job_;
+        std::thread worker_;
+        anchor_set results_;
+        std::function <void()> notify_;
+    };
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "detail/implicit_treap.hpp"
+#include "detail/line_arena.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace nana_source_view
+{
+    /**
+     *  A bracket in code, reported by a styler. Brackets in strings and comments are not reported.
+     */
+    struct bracket
+    {
+        /// Offset from the beginning of the line.
+        std::uint32_t column;
+
+        /// One of ()[]{}.
+        char symbol;
+    };
+
+    /**
+     *  Where a bracket is in the document.
+     */
+    struct bracket_location
+    {
+        std::size_t line;
+        std::uint32_t column;
+        char symbol;
+    };
+
+    /**
+     *  The brackets of all lines, for finding matching brackets in O(log n).
+     *
+     *  All kinds of brackets nest alike, so a document is a sequence of +1 for opening and -1 for closing brackets.
+     *  The brackets of a line are kept in an arena, a treap over the lines sums them up:
+     *  Per line its sum, its lowest prefix sum and its highest suffix sum.
+     *  A match is then found by descending into the first (or last) line where the depth returns to that of the bracket.
+     */
+    class bracket_index
+    {
+    public:
+        using lines_view = detail::line_arena <bracket>::lines_view;
+
+    public:
+        explicit bracket_index(std::size_t line_count = 0);
+
+        /**
+         *  Drops all brackets and sets the amount of lines.
+         */
+        void reset(std::size_t line_count);
+
+        /**
+         *  Replaces the lines [begin, end) with the lines in sizes, like line_arena::splice.
+         *  Brackets within a line are sorted by column.
+         */
+        void splice(std::size_t begin, std::size_t end, std::vector <std::size_t> const& sizes, std::vector <bracket> const& brackets);
+
+        std::size_t line_count() const;
+
+        /**
+         * @brief brackets_on_line The brackets of a line, sorted by column.
+         */
+        lines_view brackets_on_line(std::size_t line) const;
+
+        /**
+         * @brief match Finds the bracket that matches the one at line and column.
+         *        It is found by nesting only, compare its symbol with counterpart to detect mismatched kinds.
+         * @return The matching bracket. None, if there is no bracket at the location or it is unbalanced.
+         */
+        std::optional <bracket_location> match(std::size_t line, std::uint32_t column) const;
+
+        static bool is_bracket(char c);
+        static bool is_opening(char c);
+
+        /**
+         * @brief counterpart The closing bracket of an opening one and the other way around.
+         */
+        static char counterpart(char c);
+
+    private:
+        /**
+         *  Depth changes of a line or a sequence of lines.
+         */
+        struct depth_summary
+        {
+            std::int64_t sum;
+
+            /// The lowest sum of the first k brackets, k >= 1.
+            std::int64_t lowest_prefix;
+
+            /// The highest sum of the last k brackets, k >= 1.
+            std::int64_t highest_suffix;
+        };
+
+        struct depth_traits
+        {
+            using summary_type = depth_summary;
+
+            static depth_summary identity();
+            static depth_summary summarize(depth_summary const& line);
+            static depth_summary combine(depth_summary const& lhs, depth_summary const& rhs);
+        };
+
+        static depth_summary summarize_line(std::vector <bracket>::const_iterator first, std::vector <bracket>::const_iterator last);
+
+    private:
+        detail::line_arena <bracket> brackets_;
+        detail::implicit_treap <depth_summary, depth_traits> depths_;
+    };
+}
@@ -26,11 +26,27 @@ namespace nana_source_view
         index_type range;
 
         /**
-         *  Is this caret a range and not just a point?
+         *  Is this caret a range and not just a point? The range can point in both directions.
          */
         constexpr bool is_range() const
         {
-            return range > static_cast <index_type> (0);
+            return range != static_cast <index_type> (0);
+        }
+
+        /**
+         *  The first selected offset. Equals offset if this is not a range.
+         */
+        constexpr index_type selection_begin() const
+        {
+            return range < 0 ? offset + range : offset;
+        }
+
+        /**
+         *  Past the last selected offset. Equals offset if this is not a range.
+         */
+        constexpr index_type selection_end() const
+        {
+            return range < 0 ? offset : offset + range;
         }
 
         /**
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace nana_source_view::detail
+{
+    /**
+     *  A sorted set of unique values in a single vector, with the interface of std::set where the editor needs it.
+     *
+     *  Appending behind the last value and iterating are as cheap as with a vector, which is what happens to carets
+     *  almost always: They are produced in order and walked in order. Inserting in the middle moves all values behind.
+     *  Like with std::set, values are constant, and of values that compare equal the first one inserted stays.
+     */
+    template <typename T, typename Compare = std::less <T>>
+    class flat_set
+    {
+    public:
+        using value_type = T;
+        using container_type = std::vector <T>;
+        using size_type = std::size_t;
+        using iterator = typename container_type::const_iterator;
+        using const_iterator = iterator;
+        using reverse_iterator = typename container_type::const_reverse_iterator;
+        using const_reverse_iterator = reverse_iterator;
+
+    public:
+        flat_set() = default;
+
+        flat_set(std::initializer_list <T> values)
+            : flat_set(std::begin(values), std::end(values))
+        {
+        }
+
+        /**
+         *  Linear if the values are sorted, n log n otherwise.
+         */
+        template <typename IteratorT>
+        flat_set(IteratorT first, IteratorT last)
+            : values_(first, last)
+        {
+            normalize();
+        }
+
+        /**
+         *  Takes over values that are sorted and unique, without checking them. Constant time.
+         */
+        void assign_sorted(container_type values)
+        {
+            values_ = std::move(values);
+        }
+
+        /**
+         *  Takes over values in any order, duplicates are dropped.
+         */
+        void assign(container_type values)
+        {
+            values_ = std::move(values);
+            normalize();
+        }
+
+        iterator begin() const
+        {
+            return std::cbegin(values_);
+        }
+        iterator end() const
+        {
+            return std::cend(values_);
+        }
+        iterator cbegin() const
+        {
+            return begin();
+        }
+        iterator cend() const
+        {
+            return end();
+        }
+        reverse_iterator rbegin() const
+        {
+            return std::crbegin(values_);
+        }
+        reverse_iterator rend() const
+        {
+            return std::crend(values_);
+        }
+
+        size_type size() const
+        {
+            return values_.size();
+        }
+        bool empty() const
+        {
+            return values_.empty();
+        }
+        void clear()
+        {
+            values_.clear();
+        }
+        void reserve(size_type capacity)
+        {
+            values_.reserve(capacity);
+        }
+
+        iterator lower_bound(T const& value) const
+        {
+            return std::lower_bound(std::cbegin(values_), std::cend(values_), value, Compare{});
+        }
+        iterator upper_bound(T const& value) const
+        {
+            return std::upper_bound(std::cbegin(values_), std::cend(values_), value, Compare{});
+        }
+        iterator find(T const& value) const
+        {
+            auto iter = lower_bound(value);
+            return iter != end() && !Compare{}(value, *iter) ? iter : end();
+        }
+
+        std::pair <iterator, bool> insert(T const& value)
+        {
+            // the common case first: behind everything.
+            if (values_.empty() || Compare{}(values_.back(), value))
+            {
+                values_.push_back(value);
+                return {std::prev(end()), true};
+            }
+
+            auto iter = lower_bound(value);
+            if (iter != end() && !Compare{}(value, *iter))
+                return {iter, false};
+            return {values_.insert(iter, value), true};
+        }
+
+        /**
+         *  The hint is only used to tell appending apart cheaply, like the hint of std::set.
+         */
+        iterator insert(const_iterator, T const& value)
+        {
+            return insert(value).first;
+        }
+
+        template <typename... Args>
+        std::pair <iterator, bool> emplace(Args&&... args)
+        {
+            return insert(T(std::forward <Args> (args)...));
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            return values_.erase(pos);
+        }
+
+        friend bool operator==(flat_set const& lhs, flat_set const& rhs)
+        {
+            return lhs.values_ == rhs.values_;
+        }
+        friend bool operator!=(flat_set const& lhs, flat_set const& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        /**
+         *  Sorts and drops duplicates. Stable, so the first of equal values stays.
+         */
+        void normalize()
+        {
+            if (!std::is_sorted(std::begin(values_), std::end(values_), Compare{}))
+                std::stable_sort(std::begin(values_), std::end(values_), Compare{});
+
+            values_.erase(std::unique(std::begin(values_), std::end(values_), [](T const& lhs, T const& rhs)
+            {
+                return !Compare{}(lhs, rhs) && !Compare{}(rhs, lhs);
+            }), std::end(values_));
+        }
+
+    private:
+        container_type values_;
+    };
+}
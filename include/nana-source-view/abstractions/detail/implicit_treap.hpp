@@ -0,0 +1,413 @@
+#pragma once
+
+#include "../../assert/assert.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace nana_source_view::detail
+{
+    /**
+     *  A sequence with O(log n) splicing, indexing and searching by aggregates, like prefix sums over lines.
+     *
+     *  It is a treap ordered by position: nodes are kept in a binary search tree by their index,
+     *  balanced by random heap priorities. Every node caches the summary of its subtree.
+     *
+     *  TraitsT describes the summaries:
+     *  - summary_type
+     *  - static summary_type identity()                              The summary of nothing.
+     *  - static summary_type summarize(T const&)                     The summary of a single value.
+     *  - static summary_type combine(summary_type, summary_type)     Associative, left before right.
+     */
+    template <typename T, typename TraitsT>
+    class implicit_treap
+    {
+    public:
+        using value_type = T;
+        using summary_type = typename TraitsT::summary_type;
+
+        static constexpr std::size_t npos = std::numeric_limits <std::size_t>::max();
+
+    public:
+        implicit_treap()
+            : nodes_{}
+            , free_{}
+            , root_{nil}
+            , seed_{0x9E3779B9u}
+        {
+        }
+
+        std::size_t size() const
+        {
+            return size_of(root_);
+        }
+
+        bool empty() const
+        {
+            return root_ == nil;
+        }
+
+        void clear()
+        {
+            nodes_.clear();
+            free_.clear();
+            root_ = nil;
+        }
+
+        /**
+         *  Retrieves a value in O(log n).
+         */
+        T const& operator[](std::size_t index) const
+        {
+            sv_assert(index < size(), "index out of range")
+
+            auto n = root_;
+            for (;;)
+            {
+                auto const left = size_of(nodes_[n].left);
+                if (index < left)
+                    n = nodes_[n].left;
+                else if (index == left)
+                    return nodes_[n].value;
+                else
+                {
+                    index -= left + 1;
+                    n = nodes_[n].right;
+                }
+            }
+        }
+
+        /**
+         *  Replaces a value and updates the summaries on the path to it, O(log n).
+         */
+        void assign(std::size_t index, T value)
+        {
+            sv_assert(index < size(), "index out of range")
+            assign(root_, index, std::move(value));
+        }
+
+        /**
+         *  Replaces the values [begin, end) with [first, last).
+         *  Costs O(log n) plus linear in the amount of removed and inserted values.
+         */
+        template <typename IteratorT>
+        void splice(std::size_t begin, std::size_t end, IteratorT first, IteratorT last)
+        {
+            sv_assert(begin <= end && end <= size(), "splice out of range")
+
+            std::uint32_t left, middle, right;
+            split(root_, begin, left, middle);
+            split(middle, end - begin, middle, right);
+            release(middle);
+            root_ = merge(merge(left, build(first, last)), right);
+        }
+
+        /**
+         *  Copies out the values [begin, end) in O(log n) plus linear in their amount.
+         */
+        std::vector <T> values(std::size_t begin, std::size_t end) const
+        {
+            std::vector <T> result;
+            if (begin < end)
+            {
+                result.reserve(end - begin);
+                values(root_, 0, begin, end, result);
+            }
+            return result;
+        }
+
+        /**
+         *  The summary of the values [begin, end) in O(log n).
+         */
+        summary_type summary(std::size_t begin, std::size_t end) const
+        {
+            if (begin >= end)
+                return TraitsT::identity();
+            return summary(root_, 0, begin, end);
+        }
+
+        /**
+         * @brief find_first Finds the first index at or behind from, whose value contains what is searched for.
+         * @param contains Called as contains(before, summary) with the summary of all values before a subtree
+         *        (starting at 0, not at from) and the summary of the subtree, or of a single value.
+         *        Tells whether the searched for position is within the subtree. Subtrees are only descended into
+         *        if contains is true for them.
+         * @param before If not null, receives the summary of all values before the found one.
+         * @return The index or npos.
+         */
+        template <typename FunctionT>
+        std::size_t find_first(std::size_t from, FunctionT&& contains, summary_type* before = nullptr) const
+        {
+            auto accumulated = TraitsT::identity();
+            auto found = find_first(root_, 0, from, contains, accumulated);
+            if (before)
+                *before = accumulated;
+            return found;
+        }
+
+        /**
+         * @brief find_last Finds the last index before to, whose value contains what is searched for.
+         * @param contains Called as contains(summary, after) with the summary of a subtree, or a single value,
+         *        and the summary of all values behind it up to to.
+         * @param after If not null, receives the summary of the values between the found one and to.
+         * @return The index or npos.
+         */
+        template <typename FunctionT>
+        std::size_t find_last(std::size_t to, FunctionT&& contains, summary_type* after = nullptr) const
+        {
+            auto accumulated = TraitsT::identity();
+            auto found = find_last(root_, 0, to, contains, accumulated);
+            if (after)
+                *after = accumulated;
+            return found;
+        }
+
+    private:
+        static constexpr std::uint32_t nil = std::numeric_limits <std::uint32_t>::max();
+
+        struct node
+        {
+            T value;
+            summary_type summary;
+            std::size_t size;
+            std::uint32_t priority;
+            std::uint32_t left;
+            std::uint32_t right;
+        };
+
+        std::size_t size_of(std::uint32_t n) const
+        {
+            return n == nil ? 0 : nodes_[n].size;
+        }
+
+        summary_type const& summary_of(std::uint32_t n) const
+        {
+            static summary_type const identity = TraitsT::identity();
+            return n == nil ? identity : nodes_[n].summary;
+        }
+
+        void update(std::uint32_t n)
+        {
+            auto& x = nodes_[n];
+            x.size = size_of(x.left) + 1 + size_of(x.right);
+            x.summary = TraitsT::combine(TraitsT::combine(summary_of(x.left), TraitsT::summarize(x.value)), summary_of(x.right));
+        }
+
+        std::uint32_t next_priority()
+        {
+            // xorshift32
+            seed_ ^= seed_ << 13;
+            seed_ ^= seed_ >> 17;
+            seed_ ^= seed_ << 5;
+            return seed_;
+        }
+
+        std::uint32_t make_node(T value)
+        {
+            node x{std::move(value), TraitsT::identity(), 1, next_priority(), nil, nil};
+            std::uint32_t n;
+            if (free_.empty())
+            {
+                n = static_cast <std::uint32_t> (nodes_.size());
+                nodes_.push_back(std::move(x));
+            }
+            else
+            {
+                n = free_.back();
+                free_.pop_back();
+                nodes_[n] = std::move(x);
+            }
+            update(n);
+            return n;
+        }
+
+        /**
+         *  Splits off the first count values of t into left, the rest into right.
+         */
+        void split(std::uint32_t t, std::size_t count, std::uint32_t& left, std::uint32_t& right)
+        {
+            if (t == nil)
+            {
+                left = right = nil;
+                return;
+            }
+            if (size_of(nodes_[t].left) < count)
+            {
+                split(nodes_[t].right, count - size_of(nodes_[t].left) - 1, nodes_[t].right, right);
+                left = t;
+            }
+            else
+            {
+                split(nodes_[t].left, count, left, nodes_[t].left);
+                right = t;
+            }
+            update(t);
+        }
+
+        std::uint32_t merge(std::uint32_t left, std::uint32_t right)
+        {
+            if (left == nil)
+                return right;
+            if (right == nil)
+                return left;
+
+            if (nodes_[left].priority > nodes_[right].priority)
+            {
+                nodes_[left].right = merge(nodes_[left].right, right);
+                update(left);
+                return left;
+            }
+            nodes_[right].left = merge(left, nodes_[right].left);
+            update(right);
+            return right;
+        }
+
+        /**
+         *  Builds a treap of a sequence in linear time, the right spine is kept on a stack.
+         */
+        template <typename IteratorT>
+        std::uint32_t build(IteratorT first, IteratorT last)
+        {
+            std::vector <std::uint32_t> spine;
+            for (; first != last; ++first)
+            {
+                auto n = make_node(*first);
+                auto last_popped = nil;
+                while (!spine.empty() && nodes_[spine.back()].priority < nodes_[n].priority)
+                {
+                    last_popped = spine.back();
+                    spine.pop_back();
+                    update(last_popped);
+                }
+                nodes_[n].left = last_popped;
+                if (!spine.empty())
+                    nodes_[spine.back()].right = n;
+                spine.push_back(n);
+            }
+            for (auto iter = spine.rbegin(); iter != spine.rend(); ++iter)
+                update(*iter);
+            return spine.empty() ? nil : spine.front();
+        }
+
+        void release(std::uint32_t t)
+        {
+            if (t == nil)
+                return;
+
+            std::vector <std::uint32_t> pending{t};
+            while (!pending.empty())
+            {
+                auto n = pending.back();
+                pending.pop_back();
+                if (nodes_[n].left != nil)
+                    pending.push_back(nodes_[n].left);
+                if (nodes_[n].right != nil)
+                    pending.push_back(nodes_[n].right);
+                free_.push_back(n);
+            }
+        }
+
+        void assign(std::uint32_t n, std::size_t index, T&& value)
+        {
+            auto const left = size_of(nodes_[n].left);
+            if (index < left)
+                assign(nodes_[n].left, index, std::move(value));
+            else if (index == left)
+                nodes_[n].value = std::move(value);
+            else
+                assign(nodes_[n].right, index - left - 1, std::move(value));
+            update(n);
+        }
+
+        void values(std::uint32_t n, std::size_t base, std::size_t begin, std::size_t end, std::vector <T>& result) const
+        {
+            if (n == nil || end <= base || base + nodes_[n].size <= begin)
+                return;
+
+            auto const index = base + size_of(nodes_[n].left);
+            values(nodes_[n].left, base, begin, end, result);
+            if (index >= begin && index < end)
+                result.push_back(nodes_[n].value);
+            values(nodes_[n].right, index + 1, begin, end, result);
+        }
+
+        summary_type summary(std::uint32_t n, std::size_t base, std::size_t begin, std::size_t end) const
+        {
+            if (n == nil || end <= base || base + nodes_[n].size <= begin)
+                return TraitsT::identity();
+            if (begin <= base && base + nodes_[n].size <= end)
+                return nodes_[n].summary;
+
+            auto const index = base + size_of(nodes_[n].left);
+            auto result = summary(nodes_[n].left, base, begin, end);
+            if (index >= begin && index < end)
+                result = TraitsT::combine(result, TraitsT::summarize(nodes_[n].value));
+            return TraitsT::combine(result, summary(nodes_[n].right, index + 1, begin, end));
+        }
+
+        template <typename FunctionT>
+        std::size_t find_first(std::uint32_t n, std::size_t base, std::size_t from, FunctionT& contains, summary_type& before) const
+        {
+            if (n == nil)
+                return npos;
+
+            auto const& x = nodes_[n];
+            if (base + x.size <= from || (base >= from && !contains(before, x.summary)))
+            {
+                before = TraitsT::combine(before, x.summary);
+                return npos;
+            }
+
+            auto found = find_first(x.left, base, from, contains, before);
+            if (found != npos)
+                return found;
+
+            auto const index = base + size_of(x.left);
+            auto const value = TraitsT::summarize(x.value);
+            if (index >= from && contains(before, value))
+                return index;
+            before = TraitsT::combine(before, value);
+
+            return find_first(x.right, index + 1, from, contains, before);
+        }
+
+        template <typename FunctionT>
+        std::size_t find_last(std::uint32_t n, std::size_t base, std::size_t to, FunctionT& contains, summary_type& after) const
+        {
+            if (n == nil || base >= to)
+                return npos;
+
+            auto const& x = nodes_[n];
+            if (base + x.size <= to && !contains(x.summary, after))
+            {
+                after = TraitsT::combine(x.summary, after);
+                return npos;
+            }
+
+            auto const index = base + size_of(x.left);
+            auto found = find_last(x.right, index + 1, to, contains, after);
+            if (found != npos)
+                return found;
+
+            if (index < to)
+            {
+                auto const value = TraitsT::summarize(x.value);
+                if (contains(value, after))
+                    return index;
+                after = TraitsT::combine(value, after);
+            }
+
+            return find_last(x.left, base, to, contains, after);
+        }
+
+    private:
+        std::vector <node> nodes_;
+        std::vector <std::uint32_t> free_;
+        std::uint32_t root_;
+        std::uint32_t seed_;
+    };
+}
@@ -0,0 +1,636 @@
+#pragma once
+
+#include "implicit_treap.hpp"
+#include "../../assert/assert.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace nana_source_view::detail
+{
+    /**
+     *  Stores a variable amount of values per line, without an allocation per line.
+     *
+     *  Lines are kept in blocks of up to block_lines consecutive lines, the values of a block are contiguous.
+     *  ends[i] of a block is where the values of its i-th line end. The blocks are ordered in a treap that sums up
+     *  their lines and values, so a line is found in O(log n) and a splice only rewrites the blocks it touches:
+     *  O(log n + changed values), nothing behind the splice is moved.
+     */
+    template <typename T>
+    class line_arena
+    {
+    private:
+        struct block;
+
+    public:
+        using value_type = T;
+
+        /// Lines per block. A splice copies the untouched lines of at most two blocks.
+        static constexpr std::size_t block_lines = 64;
+
+        /// Values a block holds before it is split, unless a single line has more.
+        static constexpr std::size_t block_values = 4096;
+
+        /**
+         *  Walks the values of consecutive lines by their index in the whole arena.
+         *  The block of the current value is cached, crossing into another block looks it up in O(log n).
+         */
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T const*;
+            using reference = T const&;
+
+            const_iterator()
+                : arena_{nullptr}
+                , value_{0}
+                , block_{nullptr}
+                , block_begin_{0}
+                , block_end_{0}
+            {
+            }
+
+            /**
+             * @param value The index of the value in the whole arena.
+             * @param where The block of the line value belongs to, it is only looked up if value is not within it.
+             * @param block_begin The index of the first value of that block.
+             */
+            const_iterator(line_arena const* arena, std::size_t value, block const* where, std::size_t block_begin)
+                : arena_{arena}
+                , value_{value}
+                , block_{where}
+                , block_begin_{block_begin}
+                , block_end_{block_begin + where->values.size()}
+            {
+                enter_block();
+            }
+
+            reference operator*() const
+            {
+                return block_->values[value_ - block_begin_];
+            }
+            pointer operator->() const
+            {
+                return &**this;
+            }
+            reference operator[](difference_type n) const
+            {
+                return *(*this + n);
+            }
+
+            const_iterator& operator+=(difference_type n)
+            {
+                value_ = static_cast <std::size_t> (static_cast <difference_type> (value_) + n);
+                enter_block();
+                return *this;
+            }
+            const_iterator& operator-=(difference_type n)
+            {
+                return *this += -n;
+            }
+            const_iterator& operator++()
+            {
+                return *this += 1;
+            }
+            const_iterator& operator--()
+            {
+                return *this -= 1;
+            }
+            const_iterator operator++(int)
+            {
+                auto copy = *this;
+                ++*this;
+                return copy;
+            }
+            const_iterator operator--(int)
+            {
+                auto copy = *this;
+                --*this;
+                return copy;
+            }
+            const_iterator operator+(difference_type n) const
+            {
+                auto copy = *this;
+                return copy += n;
+            }
+            const_iterator operator-(difference_type n) const
+            {
+                auto copy = *this;
+                return copy -= n;
+            }
+            friend const_iterator operator+(difference_type n, const_iterator const& iter)
+            {
+                return iter + n;
+            }
+            difference_type operator-(const_iterator const& other) const
+            {
+                return static_cast <difference_type> (value_) - static_cast <difference_type> (other.value_);
+            }
+
+            bool operator==(const_iterator const& other) const
+            {
+                return value_ == other.value_;
+            }
+            bool operator!=(const_iterator const& other) const
+            {
+                return value_ != other.value_;
+            }
+            bool operator<(const_iterator const& other) const
+            {
+                return value_ < other.value_;
+            }
+            bool operator>(const_iterator const& other) const
+            {
+                return value_ > other.value_;
+            }
+            bool operator<=(const_iterator const& other) const
+            {
+                return value_ <= other.value_;
+            }
+            bool operator>=(const_iterator const& other) const
+            {
+                return value_ >= other.value_;
+            }
+
+        private:
+            /// Looks up the block of the current value, if it left the cached one. The end has no block.
+            void enter_block()
+            {
+                if (value_ >= block_begin_ && value_ < block_end_)
+                    return;
+                if (value_ >= arena_->size())
+                {
+                    block_ = nullptr;
+                    block_begin_ = block_end_ = 0;
+                    return;
+                }
+                auto const [found, begin] = arena_->block_of_value(value_);
+                block_ = found;
+                block_begin_ = begin;
+                block_end_ = begin + found->values.size();
+            }
+
+        private:
+            line_arena const* arena_;
+            std::size_t value_;
+            block const* block_;
+            std::size_t block_begin_;
+            std::size_t block_end_;
+        };
+
+        /**
+         *  A view on the values of the lines [first_line, last_line). The values of a single line are contiguous.
+         */
+        class lines_view
+        {
+        public:
+            lines_view(line_arena const* arena, std::size_t first_line, std::size_t last_line)
+                : arena_{arena}
+                , first_line_{first_line}
+                , last_line_{last_line}
+            {
+            }
+
+            /**
+             *  All values of all lines of the view.
+             */
+            const_iterator begin() const
+            {
+                if (first_line_ == last_line_)
+                    return {};
+                return arena_->iterator_at(first_line_);
+            }
+            const_iterator end() const
+            {
+                if (first_line_ == last_line_)
+                    return {};
+                return arena_->iterator_at(last_line_);
+            }
+            std::size_t size() const
+            {
+                if (first_line_ == last_line_)
+                    return 0;
+                return arena_->find(last_line_).value - arena_->find(first_line_).value;
+            }
+            bool empty() const
+            {
+                return size() == 0;
+            }
+
+            std::size_t first_line() const
+            {
+                return first_line_;
+            }
+            std::size_t last_line() const
+            {
+                return last_line_;
+            }
+
+            /**
+             *  The values of a single line. line is a line number of the document, not relative to the view.
+             */
+            lines_view line(std::size_t line) const
+            {
+                sv_assert(line >= first_line_ && line < last_line_, "line is not within the view")
+                return {arena_, line, line + 1};
+            }
+
+        private:
+            line_arena const* arena_;
+            std::size_t first_line_;
+            std::size_t last_line_;
+        };
+
+    public:
+        explicit line_arena(std::size_t line_count = 0)
+            : blocks_{}
+            , free_{}
+            , order_{}
+        {
+            reset(line_count);
+        }
+
+        /**
+         *  Drops all values and sets the amount of (empty) lines.
+         */
+        void reset(std::size_t line_count)
+        {
+            blocks_.clear();
+            free_.clear();
+            order_.clear();
+
+            std::vector <std::size_t> sizes(line_count, 0);
+            std::vector <T> values;
+            auto entries = chunk(sizes, values);
+            order_.splice(0, 0, std::begin(entries), std::end(entries));
+        }
+
+        std::size_t line_count() const
+        {
+            return order_.summary(0, order_.size()).lines;
+        }
+
+        /**
+         *  The total amount of values of all lines.
+         */
+        std::size_t size() const
+        {
+            return order_.summary(0, order_.size()).values;
+        }
+
+        /**
+         *  Views the lines [begin, end). Clamped to the existing lines.
+         */
+        lines_view lines(std::size_t begin, std::size_t end) const
+        {
+            end = std::min(end, line_count());
+            begin = std::min(begin, end);
+            return {this, begin, end};
+        }
+
+        /**
+         *  Views a single line.
+         */
+        lines_view line(std::size_t line) const
+        {
+            return lines(line, line + 1);
+        }
+
+        /**
+         *  Replaces the lines [begin, end) with the lines in sizes.
+         *  sizes holds the amount of values per new line, the values of all new lines are in [first, last).
+         *  Only the blocks that hold [begin, end) are rewritten, lines behind the splice are not touched.
+         */
+        template <typename IteratorT>
+        void splice(std::size_t begin, std::size_t end, std::vector <std::size_t> const& sizes, IteratorT first, IteratorT last)
+        {
+            sv_assert(begin <= end && end <= line_count(), "splice out of range")
+
+            std::vector <std::size_t> line_sizes;
+            std::vector <T> values;
+
+            // the lines in front of begin and behind end, that share a block with the splice, are taken along.
+            std::size_t first_position = 0;
+            std::size_t last_position = 0;
+            if (!order_.empty())
+            {
+                auto const head = find(begin);
+                auto const tail = end <= begin + 1 ? head : find(end - 1);
+                auto const tail_line = end == begin ? head.line : tail.line + 1;
+
+                // most splices stay within a block, which is then edited in place.
+                if (head.position == tail.position && splice_in_place(head, tail_line, sizes, first, last))
+                    return;
+
+                first_position = head.position;
+                last_position = tail.position + 1;
+
+                auto const& front = block_at(head.position);
+                append_lines(front, 0, head.line, line_sizes, values);
+
+                auto const kept = values.size();
+                line_sizes.insert(std::end(line_sizes), std::begin(sizes), std::end(sizes));
+                values.insert(std::end(values), first, last);
+                sv_assert(value_sum(sizes) == values.size() - kept, "sizes do not sum up to the amount of values")
+
+                auto const& back = block_at(tail.position);
+                append_lines(back, tail_line, back.line_count(), line_sizes, values);
+
+                // small leftovers are merged with the next block, so blocks do not crumble over time.
+                if (line_sizes.size() < block_lines / 2 && last_position < order_.size())
+                {
+                    auto const& next = block_at(last_position);
+                    append_lines(next, 0, next.line_count(), line_sizes, values);
+                    ++last_position;
+                }
+
+                for (auto position = first_position; position != last_position; ++position)
+                {
+                    auto const slot = order_[position].block;
+                    blocks_[slot] = block{};
+                    free_.push_back(slot);
+                }
+            }
+            else
+            {
+                line_sizes = sizes;
+                values.assign(first, last);
+                sv_assert(value_sum(sizes) == values.size(), "sizes do not sum up to the amount of values")
+            }
+
+            auto entries = chunk(line_sizes, values);
+            order_.splice(first_position, last_position, std::begin(entries), std::end(entries));
+        }
+
+        /**
+         *  Replaces the values of a single line.
+         */
+        template <typename IteratorT>
+        void assign_line(std::size_t line, IteratorT first, IteratorT last)
+        {
+            splice(line, line + 1, {static_cast <std::size_t> (std::distance(first, last))}, first, last);
+        }
+
+    private:
+        struct block
+        {
+            /// ends[i] is where the values of the i-th line of the block end.
+            std::vector <std::size_t> ends;
+            std::vector <T> values;
+
+            std::size_t line_count() const
+            {
+                return ends.size();
+            }
+        };
+
+        /**
+         *  A block in the order of all blocks, by its index in blocks_.
+         */
+        struct block_entry
+        {
+            std::uint32_t block;
+            std::size_t lines;
+            std::size_t values;
+        };
+
+        struct block_summary
+        {
+            std::size_t lines;
+            std::size_t values;
+        };
+
+        struct block_traits
+        {
+            using summary_type = block_summary;
+
+            static block_summary identity()
+            {
+                return {0, 0};
+            }
+            static block_summary summarize(block_entry const& entry)
+            {
+                return {entry.lines, entry.values};
+            }
+            static block_summary combine(block_summary const& lhs, block_summary const& rhs)
+            {
+                return {lhs.lines + rhs.lines, lhs.values + rhs.values};
+            }
+        };
+
+        /**
+         *  Where a line begins: its block and the first value of the block in the whole arena,
+         *  the line within the block and its first value in the whole arena.
+         *  The line behind the last one is at the end of the last block.
+         */
+        struct place
+        {
+            std::size_t position;
+            std::size_t block_begin;
+            std::size_t line;
+            std::size_t value;
+        };
+
+        block const& block_at(std::size_t position) const
+        {
+            return blocks_[order_[position].block];
+        }
+
+        place find(std::size_t line) const
+        {
+            block_summary before{0, 0};
+            auto position = order_.find_first(0, [line](block_summary const& preceding, block_summary const& blocks)
+            {
+                return preceding.lines + blocks.lines > line;
+            }, &before);
+
+            if (position == order_.npos)
+            {
+                sv_assert(line == line_count() && !order_.empty(), "line out of range")
+                position = order_.size() - 1;
+                auto const& last = block_at(position);
+                return {position, before.values - last.values.size(), last.line_count(), before.values};
+            }
+
+            auto const& found = block_at(position);
+            auto const local = line - before.lines;
+            return {position, before.values, local, before.values + value_end(found, local)};
+        }
+
+        const_iterator iterator_at(std::size_t line) const
+        {
+            auto const at = find(line);
+            return {this, at.value, &block_at(at.position), at.block_begin};
+        }
+
+        /**
+         *  The block that holds a value and the index of its first value in the whole arena.
+         */
+        std::pair <block const*, std::size_t> block_of_value(std::size_t value) const
+        {
+            block_summary before{0, 0};
+            auto const position = order_.find_first(0, [value](block_summary const& preceding, block_summary const& blocks)
+            {
+                return preceding.values + blocks.values > value;
+            }, &before);
+            sv_assert(position != order_.npos, "value out of range")
+            return {&block_at(position), before.values};
+        }
+
+        /**
+         *  The end of the values of the lines in front of line, within a block.
+         */
+        static std::size_t value_end(block const& from, std::size_t line)
+        {
+            return line == 0 ? 0 : from.ends[line - 1];
+        }
+
+        static std::size_t value_sum(std::vector <std::size_t> const& sizes)
+        {
+            return std::accumulate(std::begin(sizes), std::end(sizes), std::size_t{0});
+        }
+
+        /**
+         *  Appends the lines [begin, end) of a block as sizes and values.
+         */
+        static void append_lines
+        (
+            block const& from,
+            std::size_t begin,
+            std::size_t end,
+            std::vector <std::size_t>& sizes,
+            std::vector <T>& values
+        )
+        {
+            for (auto line = begin; line < end; ++line)
+                sizes.push_back(from.ends[line] - value_end(from, line));
+            auto const first = std::begin(from.values);
+            values.insert(
+                std::end(values),
+                first + static_cast <std::ptrdiff_t> (value_end(from, begin)),
+                first + static_cast <std::ptrdiff_t> (value_end(from, end))
+            );
+        }
+
+        /**
+         *  Replaces the lines [head.line, tail_line) of the block of head, unless the block becomes too small or too large.
+         * @return Whether the block was edited.
+         */
+        template <typename IteratorT>
+        bool splice_in_place
+        (
+            place const& head,
+            std::size_t tail_line,
+            std::vector <std::size_t> const& sizes,
+            IteratorT first,
+            IteratorT last
+        )
+        {
+            auto const slot = order_[head.position].block;
+            auto& target = blocks_[slot];
+
+            auto const inserted = static_cast <std::size_t> (std::distance(first, last));
+            auto const value_begin = value_end(target, head.line);
+            auto const value_stop = value_end(target, tail_line);
+            auto const lines = target.line_count() - (tail_line - head.line) + sizes.size();
+            auto const value_count = target.values.size() - (value_stop - value_begin) + inserted;
+            if (lines < block_lines / 4 || lines > 2 * block_lines || (lines > 1 && value_count > 2 * block_values))
+                return false;
+
+            // values
+            auto const common = std::min(inserted, value_stop - value_begin);
+            auto position = std::copy_n(first, common, std::begin(target.values) + static_cast <std::ptrdiff_t> (value_begin));
+            std::advance(first, common);
+            if (inserted > common)
+                target.values.insert(position, first, last);
+            else
+                target.values.erase(position, std::begin(target.values) + static_cast <std::ptrdiff_t> (value_stop));
+
+            // line ends of the new lines, the lines behind them move by the difference.
+            std::vector <std::size_t> ends;
+            ends.reserve(sizes.size());
+            auto offset = value_begin;
+            for (auto const& size : sizes)
+                ends.push_back(offset += size);
+            sv_assert(offset == value_begin + inserted, "sizes do not sum up to the amount of values")
+
+            auto const shift = static_cast <std::ptrdiff_t> (inserted) - static_cast <std::ptrdiff_t> (value_stop - value_begin);
+            for (auto line = tail_line; line < target.line_count(); ++line)
+                target.ends[line] = static_cast <std::size_t> (static_cast <std::ptrdiff_t> (target.ends[line]) + shift);
+
+            auto const replaced = std::begin(target.ends) + static_cast <std::ptrdiff_t> (head.line);
+            auto const common_lines = std::min(tail_line - head.line, ends.size());
+            auto after = std::copy_n(std::begin(ends), common_lines, replaced);
+            if (ends.size() > common_lines)
+                target.ends.insert(after, std::begin(ends) + static_cast <std::ptrdiff_t> (common_lines), std::end(ends));
+            else
+                target.ends.erase(after, std::begin(target.ends) + static_cast <std::ptrdiff_t> (tail_line));
+
+            order_.assign(head.position, {slot, lines, value_count});
+            return true;
+        }
+
+        /**
+         *  Puts lines into new blocks of about equal line counts.
+         * @return The entries of the blocks, in order.
+         */
+        std::vector <block_entry> chunk(std::vector <std::size_t> const& sizes, std::vector <T>& values)
+        {
+            std::vector <block_entry> entries;
+            if (sizes.empty())
+                return entries;
+
+            auto const count = (sizes.size() + block_lines - 1) / block_lines;
+            auto const lines_per_block = (sizes.size() + count - 1) / count;
+
+            std::size_t line = 0;
+            std::size_t value = 0;
+            while (line < sizes.size())
+            {
+                block made{};
+                std::size_t end = 0;
+                while (line < sizes.size() && made.ends.size() < lines_per_block && (made.ends.empty() || end + sizes[line] <= block_values))
+                {
+                    end += sizes[line++];
+                    made.ends.push_back(end);
+                }
+                auto const first = std::make_move_iterator(std::begin(values) + static_cast <std::ptrdiff_t> (value));
+                made.values.assign(first, first + static_cast <std::ptrdiff_t> (end));
+                value += end;
+
+                auto const lines = made.line_count();
+                entries.push_back({store(std::move(made)), lines, end});
+            }
+            return entries;
+        }
+
+        /**
+         *  Puts a block into a free slot.
+         */
+        std::uint32_t store(block&& made)
+        {
+            if (free_.empty())
+            {
+                blocks_.push_back(std::move(made));
+                return static_cast <std::uint32_t> (blocks_.size() - 1);
+            }
+            auto const slot = free_.back();
+            free_.pop_back();
+            blocks_[slot] = std::move(made);
+            return slot;
+        }
+
+    private:
+        std::vector <block> blocks_;
+        std::vector <std::uint32_t> free_;
+        implicit_treap <block_entry, block_traits> order_;
+    };
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace nana_source_view::detail
+{
+    /// Below this many values, starting threads costs more than it saves.
+    constexpr std::size_t parallel_sort_threshold = 1 << 16;
+
+    /**
+     *  The amount of threads parallel_sort uses by default.
+     */
+    inline std::size_t sort_threads()
+    {
+        return std::min <std::size_t> (std::max(1u, std::thread::hardware_concurrency()), 8);
+    }
+
+    /**
+     *  Sorts runs of the values on threads of their own, then merges neighbouring runs, also in parallel,
+     *  halving their number every round. Not stable, like std::sort.
+     */
+    template <typename T, typename CompareT>
+    void parallel_sort(std::vector <T>& values, CompareT compare, std::size_t threads = sort_threads())
+    {
+        if (threads < 2 || values.size() < parallel_sort_threshold)
+        {
+            std::sort(std::begin(values), std::end(values), compare);
+            return;
+        }
+
+        auto const at = [&values](std::size_t index)
+        {
+            return std::begin(values) + static_cast <std::ptrdiff_t> (index);
+        };
+
+        // run i is [bounds[i], bounds[i + 1]).
+        std::vector <std::size_t> bounds;
+        for (std::size_t i = 0; i <= threads; ++i)
+            bounds.push_back(values.size() * i / threads);
+
+        std::vector <std::thread> workers;
+        for (std::size_t i = 0; i + 1 < bounds.size(); ++i)
+        {
+            workers.emplace_back([&, begin = bounds[i], end = bounds[i + 1]]()
+            {
+                std::sort(at(begin), at(end), compare);
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+
+        while (bounds.size() > 2)
+        {
+            workers.clear();
+            std::vector <std::size_t> merged{0};
+            std::size_t i = 0;
+            for (; i + 2 < bounds.size(); i += 2)
+            {
+                workers.emplace_back([&, begin = bounds[i], middle = bounds[i + 1], end = bounds[i + 2]]()
+                {
+                    std::inplace_merge(at(begin), at(middle), at(end), compare);
+                });
+                merged.push_back(bounds[i + 2]);
+            }
+
+            // an odd run out waits for the next round.
+            if (i + 1 < bounds.size())
+                merged.push_back(bounds.back());
+
+            for (auto& worker : workers)
+                worker.join();
+            bounds = std::move(merged);
+        }
+    }
+}
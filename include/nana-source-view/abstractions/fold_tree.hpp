@@ -0,0 +1,138 @@
+#pragma once
+
+#include "store.hpp"
+#include "bracket_index.hpp"
+#include "wrap_layout.hpp"
+#include "../interfaces/edit_observer.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace nana_source_view
+{
+    /**
+     *  A block of lines that can be collapsed. The header stays visible, the lines (header, last] are hidden.
+     */
+    struct fold_region
+    {
+        using index_type = data_store::index_type;
+
+        /// The line that stays visible, like the one with the opening bracket.
+        index_type header;
+
+        /// The last line that is hidden.
+        index_type last;
+
+        bool collapsed;
+
+        friend bool operator==(fold_region const& lhs, fold_region const& rhs)
+        {
+            return lhs.header == rhs.header && lhs.last == rhs.last && lhs.collapsed == rhs.collapsed;
+        }
+    };
+
+    /**
+     *  Code folding: Nested regions of lines that can be collapsed.
+     *
+     *  The regions are kept sorted by their header, nested regions follow the region they are in, one region per header.
+     *  Collapsed regions hide their lines in a wrap_layout, where hidden lines have no rows. So mapping rows to lines
+     *  stays O(log n) and collapsed lines are never visited by the layout, the renderer, scrolling or vertical caret
+     *  movement. Collapsing or expanding a region costs O(k + log n) for its k lines.
+     *
+     *  The tree follows the store as an edit observer. It has to be registered after the layout, which shows
+     *  the touched lines again. Regions behind an edit are shifted, an edit within a collapsed region expands it,
+     *  an edit that only changes the text of a header keeps it collapsed. Regions whose header is merged into
+     *  the lines in front of it are dropped.
+     */
+    class fold_tree : public edit_observer
+    {
+    public:
+        using index_type = data_store::index_type;
+
+    public:
+        /**
+         *  No regions. The tree is not registered as an observer of the store, the owner does that.
+         */
+        fold_tree(data_store const* store, wrap_layout* layout);
+
+        /**
+         * @brief assign Replaces the regions, usually by from_brackets or from_indentation.
+         *        Regions that are collapsed stay collapsed if they are given again.
+         *        Of regions with the same header, the largest is kept.
+         * @throws std::invalid_argument If regions overlap without nesting or are not regions of the store.
+         */
+        void assign(std::vector <fold_region> regions);
+
+        /**
+         * @brief regions All regions, sorted by header.
+         */
+        std::vector <fold_region> const& regions() const;
+
+        /**
+         * @brief region_at The region with the given header, if there is one.
+         */
+        std::optional <fold_region> region_at(index_type header) const;
+
+        /**
+         * @brief collapse Hides the lines of the region with the given header.
+         * @return Whether there is such a region that was not collapsed.
+         */
+        bool collapse(index_type header);
+
+        /**
+         * @brief expand Shows the lines of the region with the given header, but those of collapsed regions within.
+         * @return Whether there is such a region that was collapsed.
+         */
+        bool expand(index_type header);
+
+        /**
+         * @brief toggle Collapses or expands the region with the given header.
+         * @return Whether there is such a region.
+         */
+        bool toggle(index_type header);
+
+        /**
+         * @brief collapse_top_level Collapses all regions that are not within another one.
+         */
+        void collapse_top_level();
+
+        /**
+         * @brief expand_all Expands all regions and shows all lines.
+         */
+        void expand_all();
+
+        void on_edit(std::vector <edit_delta> const& deltas) override;
+
+        /**
+         * @brief from_brackets A region from every line with an opening bracket to the line in front of its match.
+         *        The line with the closing bracket stays visible. Brackets on the same or neighbouring lines
+         *        make no region.
+         */
+        static std::vector <fold_region> from_brackets(bracket_index const& brackets);
+
+        /**
+         * @brief from_indentation A region from every line to the last line behind it that is indented deeper.
+         *        Blank lines belong to the region around them, but do not end one.
+         * @param tab_width The columns a tab advances to a multiple of.
+         */
+        static std::vector <fold_region> from_indentation(data_store const& store, index_type tab_width = 4);
+
+    private:
+        /**
+         *  The region with the given header or the end.
+         */
+        std::vector <fold_region>::iterator find(index_type header);
+
+        /**
+         *  Shows the lines [first, last), then hides those of the outermost collapsed regions within again.
+         *  There must not be a collapsed region around them that begins in front of first - 1.
+         */
+        void apply(index_type first, index_type last);
+
+    private:
+        data_store const* store_;
+        wrap_layout* layout_;
+        std::vector <fold_region> regions_;
+    };
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "store.hpp"
+#include "literal_finder.hpp"
+#include "../interfaces/edit_observer.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nana_source_view
+{
+    /**
+     *  Finds a literal query while it is typed.
+     *
+     *  All positions the query occurs at are kept, overlapping ones included. If the next query extends the
+     *  last one, it can only occur where the last one did, so only those positions are verified.
+     *  Any other change of the query, a change of the mode or an edit of the store lead to a full scan.
+     *
+     *  The search is not registered as an observer of the store, the owner does that.
+     */
+    class incremental_search : public edit_observer
+    {
+    public:
+        explicit incremental_search(data_store const* store);
+
+        /**
+         * @brief update Searches for query, narrowing the last result if possible.
+         * @return The beginnings of all matches, sorted. Matches do not overlap, like in literal_finder.
+         */
+        std::vector <std::size_t> const& update(std::string_view query, find_case mode = find_case::exact);
+
+        /**
+         * @brief matches The result of the last update.
+         */
+        std::vector <std::size_t> const& matches() const;
+
+        /**
+         * @brief narrowed Did the last update only verify the positions of the query before?
+         */
+        bool narrowed() const;
+
+        /**
+         * @brief reset Forgets the query, the next update scans the whole store.
+         */
+        void reset();
+
+        /**
+         * @brief on_edit Positions are outdated after an edit, the next update scans the whole store.
+         */
+        void on_edit(std::vector <edit_delta> const& deltas) override;
+
+    private:
+        /**
+         *  Can query be narrowed down from the last one?
+         */
+        bool extends(std::string_view query, find_case mode) const;
+
+        /**
+         *  Picks the matches from the candidates, every one behind the end of the previous.
+         */
+        void select_matches(std::size_t length);
+
+    private:
+        data_store const* store_;
+        std::string query_;
+        find_case mode_;
+
+        /// false if there is no query or the candidates are outdated.
+        bool valid_;
+        bool narrowed_;
+
+        /// All positions the query occurs at, overlapping ones too.
+        std::vector <std::size_t> candidates_;
+        std::vector <std::size_t> matches_;
+    };
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "store.hpp"
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace nana_source_view
+{
+    /**
+     *  Rearranges whole lines: sorting, removing repeated lines, reversing, moving and duplicating.
+     *
+     *  Lines are handled as views into the store, found with the line index. The new text of all affected lines
+     *  is assembled once and goes into the store as a single replacement, so the cost is the cost of reordering
+     *  the views plus a copy, no matter how many lines there are.
+     *
+     *  Carets follow the lines they are on. Lines are given as [first, last], last included.
+     *  Every operation returns what undoes it, see data_store::replace_all. Nothing if it did not change anything.
+     */
+    class line_operations
+    {
+    public:
+        using index_type = data_store::index_type;
+        using undo_type = std::vector <data_store::replacement>;
+
+    public:
+        explicit line_operations(data_store* store);
+
+        /**
+         * @brief caret_lines The first and the last line touched by carets.
+         *        A selection that ends at the beginning of a line does not touch that line.
+         */
+        std::pair <index_type, index_type> caret_lines() const;
+
+        /**
+         * @brief sort Sorts lines by their bytes. Equal lines keep their order.
+         *        Large amounts of lines are sorted on several threads.
+         */
+        undo_type sort(index_type first, index_type last, bool descending = false);
+
+        /**
+         * @brief unique Removes lines that are equal to a line in front of them.
+         *        Carets on removed lines go to the beginning of the next line that stays.
+         */
+        undo_type unique(index_type first, index_type last);
+
+        /**
+         * @brief reverse Reverses the order of the lines.
+         */
+        undo_type reverse(index_type first, index_type last);
+
+        /**
+         * @brief move_up Swaps the lines with the one in front of them.
+         */
+        undo_type move_up(index_type first, index_type last);
+
+        /**
+         * @brief move_down Swaps the lines with the one behind them.
+         */
+        undo_type move_down(index_type first, index_type last);
+
+        /**
+         * @brief duplicate Inserts a copy of the lines behind them. The carets go to the copy.
+         */
+        undo_type duplicate(index_type first, index_type last);
+
+    private:
+        /**
+         *  Throws std::out_of_range if [first, last] is not a range of lines of the store.
+         */
+        void validate(index_type first, index_type last) const;
+
+        /**
+         *  A line without its line ending.
+         */
+        std::string_view content(index_type line) const;
+
+        /**
+         *  Replaces the lines [first, last] with the lines in order, which are line numbers from within.
+         *  Lines may be repeated or left out.
+         */
+        undo_type rearrange(index_type first, index_type last, std::vector <index_type> const& order);
+
+    private:
+        data_store* store_;
+    };
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "store.hpp"
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nana_source_view
+{
+    enum class find_case
+    {
+        /// Bytes have to be equal.
+        exact,
+
+        /// ASCII letters match regardless of case, all other bytes have to be equal.
+        ascii_insensitive,
+
+        /// Like ascii_insensitive, and also letters of Latin-1, Latin Extended-A, Greek and Cyrillic.
+        utf8_insensitive
+    };
+
+    /**
+     *  Finds all occurrences of a literal string.
+     *
+     *  Every character of the needle is allowed in at most two forms of equal length, its upper and lower case.
+     *  Candidates are found by comparing 16 positions at once with the forms of the first and of the last byte
+     *  of the needle, only positions that fit both are compared completely.
+     *
+     *  Texts can be searched in slices: Only matches that begin within [from, to) are reported,
+     *  but they may reach behind to. So slicing a text at arbitrary positions finds the same matches.
+     */
+    class literal_finder
+    {
+    public:
+        static constexpr std::size_t npos = std::numeric_limits <std::size_t>::max();
+
+    public:
+        /**
+         *  Throws std::invalid_argument for an empty needle.
+         */
+        literal_finder(std::string_view needle, find_case mode = find_case::exact);
+
+        /**
+         * @brief find_all Appends the beginnings of all matches that begin in [from, to) to found.
+         *        Matches do not overlap, a match is searched for behind the end of the previous one.
+         * @return The offset the next match may begin at, pass it as from to continue with the next slice.
+         */
+        std::size_t find_all(std::string_view text, std::size_t from, std::size_t to, std::vector <std::size_t>& found) const;
+
+        /**
+         * @brief find_next The first match at or behind from.
+         * @return Its beginning or npos.
+         */
+        std::size_t find_next(std::string_view text, std::size_t from) const;
+
+        /**
+         * @brief matches Does a match begin at pos? Regardless of matches in front of it.
+         */
+        bool matches(std::string_view text, std::size_t pos) const;
+
+        /**
+         * @brief select_all Selections of all matches in a store, sorted, to replace its carets with.
+         *        The carets are behind the matches, like after typing them.
+         */
+        std::vector <data_store::caret_type> select_all(data_store const& store) const;
+
+        /**
+         * @brief size The length of a match in bytes. All matches have the length of the needle.
+         */
+        std::size_t size() const;
+
+    private:
+        /**
+         *  A character of the needle, in both forms. Both have the same length of 1 or 2 bytes.
+         */
+        struct unit
+        {
+            std::size_t length;
+            std::array <char, 2> lower;
+            std::array <char, 2> upper;
+        };
+
+        /**
+         *  Does a match begin at pos? pos + size() must be within text.
+         */
+        bool matches_at(std::string_view text, std::size_t pos) const;
+
+        /**
+         *  Calls on_match(pos) for every match beginning in [from, to), until it returns false.
+         *  Returns the offset behind the last match or to.
+         */
+        template <typename FunctionT>
+        std::size_t scan(std::string_view text, std::size_t from, std::size_t to, FunctionT&& on_match) const;
+
+    private:
+        find_case mode_;
+        std::string needle_;
+        std::vector <unit> units_;
+
+        /// The forms the first and the last byte of a match may have.
+        std::array <char, 2> first_;
+        std::array <char, 2> last_;
+    };
+}
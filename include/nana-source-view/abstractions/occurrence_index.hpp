@@ -0,0 +1,138 @@
+#pragma once
+
+#include "store.hpp"
+#include "word_trie.hpp"
+#include "detail/line_arena.hpp"
+#include "../interfaces/edit_observer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace nana_source_view
+{
+    /**
+     *  Where every identifier of a document occurs, for highlighting or selecting all occurrences of a symbol.
+     *
+     *  Identifiers are the runs of bytes basic_navigator::classify calls identifiers, so they are the same words
+     *  ctrl navigation jumps over. The index follows the store as an edit observer and only rescans touched lines.
+     *
+     *  Per line the occurrences are kept in an arena, per word a sorted list of the lines it occurs on.
+     *  Inserted or removed lines would shift the lists of all words behind them, so line shifts are logged instead
+     *  and applied to a word only when it is modified or looked up.
+     *
+     *  The words are also kept in a trie with their amount of occurrences, for completion.
+     */
+    class occurrence_index : public edit_observer
+    {
+    public:
+        using index_type = data_store::index_type;
+        using word_id = std::uint32_t;
+
+    public:
+        /**
+         *  Indexes the whole store. The index is not registered as an observer of the store, the owner does that.
+         */
+        explicit occurrence_index(data_store const* store);
+
+        /**
+         *  Rescans the whole store.
+         */
+        void rebuild();
+
+        void on_edit(std::vector <edit_delta> const& deltas) override;
+
+        /**
+         * @brief occurrences The offsets of all occurrences of word, sorted.
+         *        Only whole identifiers count, "id" does not occur in "identifier".
+         */
+        std::vector <index_type> occurrences(std::string_view word) const;
+
+        /**
+         * @brief count The amount of occurrences of word.
+         */
+        std::size_t count(std::string_view word) const;
+
+        /**
+         * @brief word_at The identifier that contains offset or ends at it. Empty, if there is none.
+         */
+        std::string_view word_at(index_type offset) const;
+
+        /**
+         * @brief complete The count most frequent identifiers of the document that start with prefix.
+         */
+        std::vector <word_trie::candidate> complete(std::string_view prefix, std::size_t count) const;
+
+        /**
+         * @brief distinct_words The amount of different identifiers in the document.
+         */
+        std::size_t distinct_words() const;
+
+    private:
+        /**
+         *  An identifier on a line.
+         */
+        struct occurrence
+        {
+            std::uint32_t column;
+            std::uint32_t length;
+            word_id word;
+        };
+
+        struct word_entry
+        {
+            std::string text;
+
+            /// The line of every occurrence, sorted. A line is repeated for every occurrence on it.
+            std::vector <std::size_t> lines;
+
+            /// The amount of shifts of the log that are applied to lines.
+            std::size_t applied;
+        };
+
+        /**
+         *  The lines at and behind from moved by delta.
+         */
+        struct line_shift
+        {
+            std::size_t from;
+            std::ptrdiff_t delta;
+        };
+
+        std::string_view line_text(std::size_t line) const;
+
+        /**
+         *  Appends the identifiers of a line to found.
+         */
+        void scan_line(std::size_t line, std::vector <occurrence>& found);
+
+        word_id intern(std::string_view text);
+
+        /**
+         *  Applies all pending shifts to the lines of a word.
+         */
+        void normalize(word_entry& entry) const;
+
+        /**
+         *  Applies all pending shifts to all words and drops the log.
+         */
+        void compact();
+
+        /**
+         *  Replaces the lines [begin, end) with count freshly scanned lines.
+         */
+        void replace_lines(std::size_t begin, std::size_t end, std::size_t count);
+
+    private:
+        data_store const* store_;
+        detail::line_arena <occurrence> lines_;
+        std::unordered_map <std::string, word_id> ids_;
+        mutable std::vector <word_entry> words_;
+        std::vector <word_id> free_ids_;
+        std::vector <line_shift> shifts_;
+        word_trie completions_;
+    };
+}
@@ -1,16 +1,20 @@
 #pragma once
 
 #include "caret.hpp"
+#include "detail/flat_set.hpp"
+#include "../interfaces/edit_observer.hpp"
 
 #include <interval-tree/interval_tree.hpp>
 
 #include <set>
+#include <string>
 #include <vector>
 #include <string_view>
 
 namespace nana_source_view
 {
     class data_store;
+    class wrap_layout;
 
     enum class line_end_type
     {
@@ -56,6 +60,12 @@ namespace nana_source_view
         basic_navigator& operator=(basic_navigator const&);
         basic_navigator& operator=(basic_navigator&&);
 
+        /**
+         *  The class of a single byte. Bytes of multi byte utf8 sequences are other.
+         *  Everything that splits text into words, like ctrl navigation or the occurrence index, uses this.
+         */
+        static basic_character_classes classify(char byte);
+
         /**
          *  Arrow left action. Moves all carets in the editor.
          */
@@ -67,15 +77,40 @@ namespace nana_source_view
         void arrow_right(bool shift, bool ctrl);
 
         /**
-         *  Arrow up action. Moves all carets in the editor.
+         *  Arrow up action. Moves all carets in the editor a row up, keeping their column.
          */
         void arrow_up(bool shift, bool ctrl);
 
         /**
-         *  Arrow down action. Moves all carets in the editor.
+         *  Arrow down action. Moves all carets in the editor a row down, keeping their column.
          */
         void arrow_down(bool shift, bool ctrl);
 
+        /**
+         *  Vertical movement goes by the rows of the layout, over wrapped rows and folded lines in O(log n).
+         *  Without a layout, rows are lines. The layout is not owned.
+         */
+        void row_layout(wrap_layout const* layout);
+
+        /**
+         *  Box selection, like alt + drag: Selects the columns between anchor_column and active_column on every line
+         *  between anchor_line and active_line. Columns count code points, like the text renderer does.
+         *  Every line gets a caret at active_column, or at its end if it is too short. Replaces all carets.
+         */
+        void select_box
+        (
+            caret_type::index_type anchor_line,
+            caret_type::index_type anchor_column,
+            caret_type::index_type active_line,
+            caret_type::index_type active_column
+        );
+
+        /**
+         *  Double click action: Replaces all carets by a selection of the word at offset, the run of bytes
+         *  of the class of the byte at offset, see classify. At the end of a line, the byte in front of it counts.
+         */
+        void select_word(caret_type::index_type offset);
+
     protected:
         /**
          *  Goes an entire complete character left. Respects utf-8 encoding.
@@ -99,6 +134,12 @@ namespace nana_source_view
          */
         caret_type::index_type utf8_go_right_class(caret_type::index_type from) const;
 
+        /**
+         *  Goes rows down, or up if negative. The column in code points is kept, a shorter row is gone to its end.
+         *  Going past the first or the last row ends at the beginning or the end of the text.
+         */
+        caret_type::index_type row_step(caret_type::index_type from, caret_type::index_type rows) const;
+
         virtual void arrow_left_impl(bool shift, bool ctrl);
         virtual void arrow_right_impl(bool shift, bool ctrl);
         virtual void arrow_up_impl(bool shift, bool ctrl);
@@ -107,8 +148,14 @@ namespace nana_source_view
     private:
         basic_character_classes assess_class(caret_type::index_type offset) const;
 
+        /**
+         *  Moves all carets by row_step. With shift, the anchors stay and overlapping selections are merged.
+         */
+        void move_rows(caret_type::index_type rows, bool shift);
+
     private:
         data_store* store;
+        wrap_layout const* layout;
     };
 
     class data_store
@@ -116,18 +163,27 @@ namespace nana_source_view
     public:
         friend class basic_navigator;
 
-        // todo: std::set is not optimal, boost::flat_set is a dependency, make own container (maybe)
         using caret_type = caret<>;
         using byte_type = char;
         using index_type = caret_type::index_type;
         using codepage_character = int32_t;
-        using caret_container_type = std::set <caret_type>;
+        using caret_container_type = detail::flat_set <caret_type>;
         using byte_container_type = std::vector <byte_type>;
         using iterator = byte_container_type::iterator;
         using const_iterator = byte_container_type::const_iterator;
 
         using caret_iterator = caret_container_type::iterator;
 
+        /**
+         *  The bytes [offset, offset + length) are to be replaced by text, see replace_all.
+         */
+        struct replacement
+        {
+            index_type offset;
+            index_type length;
+            std::string text;
+        };
+
     public:
         /**
          *  Creates the data store, puts data inside and sets the caret to the end of the data.
@@ -159,12 +215,40 @@ namespace nana_source_view
          */
         void set_line_end(line_end_type let);
 
+        /**
+         *  The line ending the line index is built with.
+         */
+        line_end_type line_end() const;
+
         /**
          *  Insert a byte at all carets.
          *  Does overwrite if a caret is a range.
          */
         void insert_byte(byte_type byte);
 
+        /**
+         *  Backspace at all carets: Removes the character in front of each caret, or its selection.
+         *  With whole_word, everything up to where ctrl + arrow left would go is removed instead.
+         *  All carets are handled in a single pass, carets that meet are merged.
+         */
+        void erase_backward(bool whole_word = false);
+
+        /**
+         *  Delete at all carets: Removes the character behind each caret, or its selection.
+         *  With whole_word, everything up to where ctrl + arrow right would go is removed instead.
+         */
+        void erase_forward(bool whole_word = false);
+
+        /**
+         *  Applies all replacements in a single pass over the bytes, the line index is rebuilt once
+         *  and observers are notified once. Replacements have to be sorted by offset and must not overlap.
+         *  Carets within a replaced range move behind its new text.
+         *
+         *  Returns the replacements that undo all of them at once, when passed to replace_all again.
+         *  Throws std::invalid_argument if replacements overlap or are unsorted, std::out_of_range if one is out of bounds.
+         */
+        std::vector <replacement> replace_all(std::vector <replacement> const& replacements);
+
         const_iterator begin() const;
         const_iterator end() const;
 
@@ -186,6 +270,11 @@ namespace nana_source_view
          */
         std::string utf8_string() const;
 
+        /**
+         *  All bytes at once, without a copy. Invalidated by any modification.
+         */
+        std::string_view view() const;
+
         /**
          *  Sets the text and resets all carets.
          */
@@ -219,6 +308,17 @@ namespace nana_source_view
          */
         void add_caret(caret_type::index_type pos, caret_type::index_type range = 0);
 
+        /**
+         *  Inserts many carets at once. Linear if they are sorted by offset and behind all existing carets,
+         *  like carets at all occurrences of a word are.
+         */
+        void add_carets(std::vector <caret_type> const& added);
+
+        /**
+         *  Replaces all carets. added must not be empty.
+         */
+        void replace_carets(std::vector <caret_type> const& added);
+
         /**
          *  Removes a caret from the store. Be careful not to remove all of them without adding one.
          */
@@ -227,6 +327,11 @@ namespace nana_source_view
         caret_iterator caret_begin() const;
         caret_iterator caret_end() const;
 
+        /**
+         *  Retrieves the first caret with an offset that is not less than offset.
+         */
+        caret_iterator caret_lower_bound(index_type offset) const;
+
         /**
          *  Retrieves the amount of carets
          */
@@ -243,7 +348,7 @@ namespace nana_source_view
         void clear();
 
         /**
-         * Retrieves the line from the given index. Tis is costly, avoid use
+         * Retrieves the line from the given index. Binary search over the line index.
          */
         index_type line_from_index(index_type index) const;
 
@@ -253,17 +358,29 @@ namespace nana_source_view
         index_type index_from_line(index_type line) const;
 
         /**
-         * @brief line_count Returns the amount of lines in the store.
+         * @brief line_count Returns the amount of lines in the store. There is always at least one line.
          * @return A number of lines.
          */
         std::size_t line_count() const;
 
         /**
-         * @brief line Retrieve the beginning and end of a line as a range.
+         * @brief line Retrieve the beginning and end of a line as a range. The line ending is part of the range.
          * @param line Which line to get.
          * @return Beginning and end of a line as iterators.
          */
         std::pair <const_iterator, const_iterator> line(index_type line) const;
+
+        /**
+         * @brief add_observer Registers an observer that is notified about every modification.
+         *        The store does not own the observer, it has to be removed before it dies.
+         */
+        void add_observer(edit_observer* observer);
+
+        /**
+         * @brief remove_observer Unregisters an observer.
+         */
+        void remove_observer(edit_observer* observer);
+
     private:
         struct low_level_ops
         {
@@ -278,7 +395,7 @@ namespace nana_source_view
             static void insert(byte_container_type& data, caret_type const& car, byte_type byte);
         };
         /**
-         *  Fills the "line_ends" set with a list of all line endings.
+         *  Fills the line index with the beginnings of all lines.
          *  Necessary on loading an entire block of text.
          */
         void reform_line_end_tree();
@@ -290,42 +407,42 @@ namespace nana_source_view
          */
         void insert_byte_multi_caret(byte_type byte);
 
+        /**
+         *  Removes ranges ordered like the carets they belong to. Ranges of neighbouring carets may overlap.
+         */
+        void erase_ranges(std::vector <replacement> ranges);
+
         /**
          *  Removes range from store and updates the given caret.
          */
         caret_type remove_range_single_caret(caret_type car);
 
-    private:
-        struct line_container
-        {
-            /// Index position in data_store where this line begins
-            index_type index;
-
-            /// Which line is this? | Count of all lineendings before this.
-            index_type line;
-
-            bool operator<(line_container const& other) const
-            {
-                return index < other.index;
-            }
-
-            struct line_number_compare
-            {
-                bool operator()(line_container const& lhs, line_container const& rhs) const
-                {
-                    return lhs.line < rhs.line;
-                }
-            };
-        };
+        /**
+         *  Replaces the bytes [offset, offset + removed) with inserted and keeps the line index up to date.
+         *  Does not update carets and does not notify observers.
+         *  Only the lines around the edit are rescanned.
+         */
+        edit_delta replace_bytes(index_type offset, index_type removed, std::basic_string_view <byte_type> inserted);
+
+        /**
+         *  Returns the length of the line ending at pos or 0 if there is none.
+         */
+        index_type line_break_length(index_type pos) const;
 
+        /**
+         *  Passes the deltas to all observers.
+         */
+        void notify(std::vector <edit_delta> const& deltas);
+
+    private:
         byte_container_type data;
         caret_container_type carets;
         line_end_type let;
 
-        // TODO: Better container possibly needed. Candidates: boost::flat_set or maybe even a b-tree?
-        std::set <line_container> line_ends_index_sorted;
+        /// A sorted container with all line beginnings. The first line always begins at 0.
+        std::vector <index_type> line_starts;
 
-        /// A container with all line beginnings.
-        std::vector <index_type> line_ends_line_sorted;
+        /// Non owning.
+        std::vector <edit_observer*> observers;
     };
 }
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "style_range.hpp"
+
+#include <vector>
+#include <cstddef>
+
+namespace nana_source_view
+{
+    /**
+     *  Interns styles, so style ranges only need to refer to them by a 16 bit id.
+     *  Equal styles share an id, so comparing ids is comparing styles.
+     */
+    class style_palette
+    {
+    public:
+        /**
+         *  The id of unstyled text, the renderer draws it with its own colors.
+         */
+        static constexpr style_id default_id = 0;
+
+    public:
+        style_palette();
+
+        /**
+         * @brief intern Retrieves the id of a style, adds the style if it is not yet known.
+         *        Linear in the size of the palette, stylers intern their styles once and keep the ids.
+         * @throws std::length_error if the palette is full.
+         */
+        style_id intern(style const& s);
+
+        /**
+         * @brief operator[] Retrieves an interned style. id must have been returned by intern.
+         */
+        style const& operator[](style_id id) const;
+
+        /**
+         * @brief size The amount of ids in use, including the default id.
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief clear Forgets all styles except for the default.
+         */
+        void clear();
+
+    private:
+        std::vector <style> styles_;
+    };
+}
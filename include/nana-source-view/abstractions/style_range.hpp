@@ -1,9 +1,8 @@
 #pragma once
 
-#include <interval-tree/interval_tree.hpp>
 #include <nana/basic_types.hpp>
 
-#include <optional>
+#include <cstdint>
 
 namespace nana_source_view
 {
@@ -22,11 +21,36 @@ namespace nana_source_view
         nana::color bgcolor;
 
         unsigned char font_mods;
+
+        friend bool operator==(style const& lhs, style const& rhs)
+        {
+            return lhs.fgcolor == rhs.fgcolor && lhs.bgcolor == rhs.bgcolor && lhs.font_mods == rhs.font_mods;
+        }
+
+        friend bool operator!=(style const& lhs, style const& rhs)
+        {
+            return !(lhs == rhs);
+        }
     };
 
+    /**
+     *  Identifies a style interned in a style_palette.
+     */
+    using style_id = std::uint16_t;
+
+    /**
+     *  A styled run of bytes within a line. Stored per line, so positions are relative to the line start.
+     *  Kept small on purpose, highlighting a large file produces millions of them.
+     */
     struct style_range
     {
-        lib_interval_tree::interval <int64_t> range;
-        style styling;
+        /// Offset of the first byte from the beginning of the line.
+        std::uint32_t start;
+
+        /// Amount of styled bytes.
+        std::uint32_t length;
+
+        /// The style in the palette of the styler that produced this range.
+        style_id id;
     };
 }
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "detail/line_arena.hpp"
+#include "style_range.hpp"
+
+namespace nana_source_view
+{
+    /**
+     *  The style ranges of all lines of a document in one arena.
+     *  Stylers splice the lines they restyled, the renderer reads runs of lines.
+     */
+    using style_store = detail::line_arena <style_range>;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nana_source_view
+{
+    /**
+     *  Words with their frequencies in a prefix tree, for completing words.
+     *
+     *  Nodes live in one vector, the children of a node are a list of siblings sorted by byte.
+     *  Every node knows the highest frequency in its subtree, so the most frequent completions of a prefix
+     *  are found best first, without visiting words that do not make it into the result.
+     */
+    class word_trie
+    {
+    public:
+        struct candidate
+        {
+            std::string word;
+            std::size_t frequency;
+
+            bool operator==(candidate const& other) const
+            {
+                return word == other.word && frequency == other.frequency;
+            }
+        };
+
+    public:
+        word_trie();
+
+        void clear();
+
+        /**
+         * @brief add Changes the frequency of word by delta. A word is gone when its frequency drops to 0.
+         *        Frequencies must not become negative.
+         */
+        void add(std::string_view word, std::ptrdiff_t delta);
+
+        /**
+         * @brief frequency The frequency of word, 0 if it is not in the trie.
+         */
+        std::size_t frequency(std::string_view word) const;
+
+        /**
+         * @brief size The amount of words with a frequency above 0.
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief complete The count most frequent words that start with prefix, the prefix itself included.
+         * @return Sorted by descending frequency, words of equal frequency alphabetically.
+         */
+        std::vector <candidate> complete(std::string_view prefix, std::size_t count) const;
+
+    private:
+        struct node
+        {
+            std::uint32_t first_child;
+            std::uint32_t next_sibling;
+
+            /// How often the word that ends here occurs.
+            std::uint32_t frequency;
+
+            /// The highest frequency in the subtree of this node.
+            std::uint32_t best;
+
+            char byte;
+        };
+
+        /**
+         *  The child of n for byte or nil.
+         */
+        std::uint32_t child(std::uint32_t n, char byte) const;
+
+        /**
+         *  The child of n for byte, it is created if it does not exist.
+         */
+        std::uint32_t make_child(std::uint32_t n, char byte);
+
+        /**
+         *  The node of a word or nil.
+         */
+        std::uint32_t find(std::string_view word) const;
+
+        void unlink(std::uint32_t parent, std::uint32_t n);
+
+    private:
+        std::vector <node> nodes_;
+        std::vector <std::uint32_t> free_;
+        std::size_t words_;
+    };
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "store.hpp"
+#include "detail/implicit_treap.hpp"
+#include "detail/parallel_sort.hpp"
+#include "../interfaces/edit_observer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace nana_source_view
+{
+    /**
+     *  Soft wrapping: Lines longer than a given amount of columns are shown in several rows.
+     *
+     *  A treap over the lines holds the amount of rows of every line, so the row a line begins in and the line
+     *  a row belongs to are prefix sums, found in O(log n). Scrolling works in rows with that.
+     *  Where a line wraps is not stored, it is computed from the line when asked for, only visible lines are.
+     *
+     *  Lines can also be hidden, like the lines of a collapsed fold. Hidden lines have no rows, so they are skipped
+     *  by every mapping between rows and lines at no cost.
+     *
+     *  The layout follows the store as an edit observer and rewraps touched lines only.
+     *  When the columns change, all lines become stale and count as a single row, until they are refreshed:
+     *  The visible ones first with refresh, the rest with refresh_all, which splits them up among threads.
+     *
+     *  Columns are code points, like the glyphs of a monospace font. With no columns, nothing is wrapped.
+     */
+    class wrap_layout : public edit_observer
+    {
+    public:
+        using index_type = data_store::index_type;
+
+    public:
+        /**
+         *  Wrapping is off until columns are set, all lines are visible.
+         *  The layout is not registered as an observer of the store, the owner does that.
+         */
+        explicit wrap_layout(data_store const* store);
+
+        /**
+         * @brief columns Sets the width of a row. Lines are not wrapped with 0 columns.
+         *        A change makes all lines stale.
+         */
+        void columns(index_type columns);
+
+        index_type columns() const;
+
+        /**
+         * @brief enabled Are lines wrapped?
+         */
+        bool enabled() const;
+
+        /**
+         * @brief row_count The amount of rows of all lines.
+         */
+        index_type row_count() const;
+
+        /**
+         * @brief rows The amount of rows of a line, 1 if it is stale and 0 if it is hidden.
+         */
+        index_type rows(index_type line) const;
+
+        /**
+         * @brief row_of_line The row a line begins in. The row count for the line count.
+         */
+        index_type row_of_line(index_type line) const;
+
+        /**
+         * @brief line_of_row The line a row belongs to and which row of the line it is.
+         *        The line count and 0 for rows behind the last one.
+         */
+        std::pair <index_type, index_type> line_of_row(index_type row) const;
+
+        /**
+         * @brief wrap_points Where the rows of a line but the first begin, as offsets within the line.
+         *        Valid until the next edit or change of columns.
+         */
+        std::vector <index_type> const& wrap_points(index_type line) const;
+
+        /**
+         * @brief hide Hides or shows the lines [first, last).
+         */
+        void hide(index_type first, index_type last, bool hidden);
+
+        /**
+         * @brief hide Shows the lines [first, last), but those in the hidden ranges, in a single pass.
+         * @param hidden Ranges of lines [begin, end), sorted.
+         */
+        void hide(index_type first, index_type last, std::vector <std::pair <index_type, index_type>> const& hidden);
+
+        bool hidden(index_type line) const;
+
+        /**
+         * @brief next_visible The first line behind line that is not hidden, or the line count.
+         */
+        index_type next_visible(index_type line) const;
+
+        /**
+         * @brief previous_visible The last line before line that is not hidden, or -1.
+         */
+        index_type previous_visible(index_type line) const;
+
+        /**
+         * @brief stale Are there visible lines that were not wrapped since the columns changed?
+         */
+        bool stale() const;
+
+        /**
+         * @brief refresh Wraps the visible stale lines of [first, last).
+         * @return Whether there were any.
+         */
+        bool refresh(index_type first, index_type last);
+
+        /**
+         * @brief refresh_all Wraps all visible stale lines, on several threads if there are many.
+         *        Hidden lines are wrapped when they are shown.
+         */
+        void refresh_all(std::size_t threads = detail::sort_threads());
+
+        /**
+         * @brief wrap Where a line of text has to be wrapped to fit into columns.
+         *        Rows break behind the last blank that fits, or within a word that is longer than a row.
+         * @param text A line without its line ending.
+         */
+        static std::vector <index_type> wrap(std::string_view text, index_type columns);
+
+        void on_edit(std::vector <edit_delta> const& deltas) override;
+
+    private:
+        struct wrapped_line
+        {
+            std::uint32_t rows;
+            bool stale;
+            bool hidden;
+        };
+
+        /**
+         *  Hidden lines count neither as rows nor as stale.
+         */
+        struct row_summary
+        {
+            index_type rows;
+            index_type stale;
+        };
+
+        struct row_traits
+        {
+            using summary_type = row_summary;
+
+            static row_summary identity();
+            static row_summary summarize(wrapped_line const& line);
+            static row_summary combine(row_summary const& lhs, row_summary const& rhs);
+        };
+
+        /**
+         *  A line without its line ending.
+         */
+        std::string_view content(index_type line) const;
+
+        /**
+         *  Wraps the given lines, on several threads if there are many.
+         */
+        std::vector <wrapped_line> wrap_lines(std::vector <index_type> const& lines, std::size_t threads) const;
+
+        /**
+         *  Wraps the lines [first, last), on several threads if there are many.
+         */
+        std::vector <wrapped_line> wrap_lines(index_type first, index_type last, std::size_t threads) const;
+
+    private:
+        data_store const* store_;
+        index_type columns_;
+        detail::implicit_treap <wrapped_line, row_traits> lines_;
+        mutable index_type cached_line_;
+        mutable std::vector <index_type> cached_points_;
+    };
+}
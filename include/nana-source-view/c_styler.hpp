@@ -5,14 +5,123 @@
 
 #include <nana-source-view/interfaces/styler.hpp>
 
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
 namespace nana_source_view::styles
 {
+    /**
+     *  Highlights C and C++.
+     *
+     *  The lexer state at the start of every line is kept as a checkpoint.
+     *  A change re-lexes from the first changed line and stops at the first line behind the change
+     *  that starts in the same state as before, so typing usually re-lexes a single line.
+     */
     class c_style : public styler
     {
-        using iterator_type = std::unordered_map <data_store::index_type, std::vector <style_range>>;
+    public:
+        /**
+         *  What the lexer is in the middle of, when a line ends.
+         */
+        struct line_state
+        {
+            enum class context : std::uint8_t
+            {
+                code,
+                block_comment,
+                line_comment,
+                string,
+                raw_string
+            };
+
+            context ctx = context::code;
+
+            /// Inside of a preprocessor directive that is continued with a backslash.
+            bool preprocessor = false;
+
+            /// Raw strings: The id of the delimiter that closes the string.
+            std::uint16_t delimiter = 0;
+
+            friend bool operator==(line_state const& lhs, line_state const& rhs)
+            {
+                return lhs.ctx == rhs.ctx && lhs.preprocessor == rhs.preprocessor && lhs.delimiter == rhs.delimiter;
+            }
+
+            friend bool operator!=(line_state const& lhs, line_state const& rhs)
+            {
+                return !(lhs == rhs);
+            }
+        };
+
+        /**
+         *  The colors of the token classes.
+         */
+        struct theme
+        {
+            style keyword;
+            style comment;
+            style string;
+            style number;
+            style preprocessor;
+        };
+
+    public:
+        c_style(data_store const* store);
+        c_style(data_store const* store, theme const& colors);
 
         void initialize() override;
         void on_multi_line_change(index_type begin, index_type end) override;
-        range_type styles_on_lines(index_type begin, index_type end) override;
+
+        /**
+         * @brief state_at The lexer state at the start of a line.
+         */
+        line_state state_at(index_type line) const;
+
+        /**
+         * @brief relexed_lines The amount of lines lexed by the last update.
+         */
+        std::size_t relexed_lines() const;
+
+    private:
+        /**
+         * @brief lex_line Lexes a single line and appends its style ranges and the brackets in code.
+         * @param state The state at the start of the line.
+         * @return The state at the start of the next line.
+         */
+        line_state lex_line
+        (
+            std::string_view text,
+            line_state state,
+            std::vector <style_range>& ranges,
+            std::vector <bracket>& found
+        );
+
+        /**
+         * @brief delimiter_id Interns a raw string delimiter in O(1).
+         *        Throws std::length_error if there are more delimiters than a line state can tell apart.
+         */
+        std::uint16_t delimiter_id(std::string_view delimiter);
+
+    private:
+        theme theme_;
+        style_id keyword_;
+        style_id comment_;
+        style_id string_;
+        style_id number_;
+        style_id preprocessor_;
+
+        /// The state at the start of every line, and behind the last one.
+        std::vector <line_state> states_;
+
+        /// Raw string delimiters, 0 is the empty delimiter.
+        std::vector <std::string> delimiters_;
+
+        /// The ids of the delimiters, the index into delimiters_.
+        std::unordered_map <std::string, std::uint16_t> delimiter_ids_;
+
+        std::size_t relexed_;
     };
 }
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../abstractions/caret.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace nana_source_view
+{
+    /**
+     *  Describes a single replacement in the data store:
+     *  The bytes [offset, offset + removed) were replaced by inserted bytes.
+     */
+    struct edit_delta
+    {
+        using index_type = caret<>::index_type;
+
+        index_type offset;
+        index_type removed;
+        index_type inserted;
+
+        /// The line that contains offset.
+        index_type first_line;
+
+        /// Line breaks that were removed. The lines [first_line, first_line + lines_removed] are gone.
+        index_type lines_removed;
+
+        /// Line breaks that were inserted. The lines [first_line, first_line + lines_inserted] are new.
+        index_type lines_inserted;
+    };
+
+    /**
+     *  A contiguous range of lines touched by one or more deltas, in old and in new line numbers (inclusive).
+     */
+    struct touched_lines
+    {
+        std::size_t old_begin;
+        std::size_t old_end;
+        std::size_t new_begin;
+        std::size_t new_end;
+    };
+
+    /**
+     *  Combines deltas that touch the same or neighbouring lines, for observers that keep information per line.
+     */
+    inline std::vector <touched_lines> group_deltas(std::vector <edit_delta> const& deltas)
+    {
+        std::vector <touched_lines> groups;
+        std::ptrdiff_t shift = 0;
+        for (auto const& delta : deltas)
+        {
+            auto const old_begin = static_cast <std::size_t> (delta.first_line);
+            auto const old_end = static_cast <std::size_t> (delta.first_line + delta.lines_removed);
+
+            if (groups.empty() || old_begin > groups.back().old_end)
+                groups.push_back({old_begin, old_end, static_cast <std::size_t> (static_cast <std::ptrdiff_t> (old_begin) + shift), 0});
+            else
+                groups.back().old_end = std::max(groups.back().old_end, old_end);
+
+            shift += delta.lines_inserted - delta.lines_removed;
+            groups.back().new_end = static_cast <std::size_t> (static_cast <std::ptrdiff_t> (groups.back().old_end) + shift);
+        }
+        return groups;
+    }
+
+    /**
+     *  Gets notified about all modifications of a data store.
+     *  Used by everything that keeps information per line or per offset and wants to update incrementally.
+     */
+    class edit_observer
+    {
+    public:
+        virtual ~edit_observer() = default;
+
+        /**
+         * @brief on_edit Called after the data store was modified.
+         * @param deltas Sorted by offset and not overlapping. Offsets and lines refer to the text before the edit,
+         *        so deltas[i] is shifted by the sum of all size and line differences of deltas[0..i).
+         */
+        virtual void on_edit(std::vector <edit_delta> const& deltas) = 0;
+    };
+}
@@ -1,9 +1,16 @@
 #pragma once
 
+#include "../abstractions/bracket_index.hpp"
 #include "../abstractions/store.hpp"
 #include "../abstractions/style_range.hpp"
+#include "../abstractions/style_store.hpp"
+#include "../abstractions/style_palette.hpp"
+#include "edit_observer.hpp"
 
-#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace nana_source_view
@@ -15,11 +22,17 @@ namespace nana_source_view
     {
     public:
         using index_type = data_store::index_type;
-        using iterator_type = std::unordered_map <index_type, std::vector <style_range>>::const_iterator;
-        using range_type = std::pair <iterator_type, iterator_type>;
+        using iterator_type = style_store::const_iterator;
+        using range_type = style_store::lines_view;
 
         styler(data_store const* store)
             : store{store}
+            , styles{store->line_count()}
+            , brackets{store->line_count()}
+            , palette{}
+            , restyled{0, 0}
+            , unvisited_lines{0}
+            , next_group{std::numeric_limits <index_type>::max()}
         {
         }
 
@@ -42,11 +55,21 @@ namespace nana_source_view
 
         /**
          * @brief on_multi_line_change Called when multiple lines change.
+         *        Lines are counted in the current text. If lines were inserted or removed,
+         *        the difference between store->line_count() and styles.line_count() tells how many,
+         *        the lines [begin, end - difference) of the old text were replaced by [begin, end).
          * @param begin The first line that is included in the change
          * @param end past the end index. The first line NOT included in the change
          */
         virtual void on_multi_line_change(index_type begin, index_type end) = 0;
 
+        /**
+         * @brief on_edit Restyles the lines an edit touched. Every group of neighbouring deltas is passed to
+         *        on_multi_line_change on its own, so carets far apart do not relex all lines between them.
+         * @return The restyled lines of every group, in the line numbers of the current text.
+         */
+        std::vector <std::pair <index_type, index_type>> on_edit(std::vector <edit_delta> const& deltas);
+
         /**
          * @brief styles_on_line The style on the specific line, base implementation uses styles_on_lines.
          * @param begin Which line.
@@ -58,14 +81,138 @@ namespace nana_source_view
         }
 
         /**
-         * @brief styles_on_lines Returns a range within some sort of container with style ranges.
+         * @brief styles_on_lines Returns the style ranges of the lines, those of a single line are contiguous in memory.
+         *        The base implementation views the style store.
          * @param begin Begin of relevant styles
          * @param end Past the end index.
-         * @return
+         * @return A view on the lines, it can be iterated as a whole or line by line.
          */
-        virtual range_type styles_on_lines(index_type begin, index_type end) = 0;
+        virtual range_type styles_on_lines(index_type begin, index_type end)
+        {
+            return styles.lines(static_cast <std::size_t> (begin), static_cast <std::size_t> (end));
+        }
+
+        /**
+         * @brief get_palette Retrieves the palette the ids of all style ranges refer to.
+         */
+        style_palette const& get_palette() const
+        {
+            return palette;
+        }
+
+        /**
+         * @brief get_brackets Retrieves the brackets in code, for matching brackets.
+         *        Stylers that do not report brackets leave it empty.
+         */
+        bracket_index const& get_brackets() const
+        {
+            return brackets;
+        }
+
+        /**
+         * @brief restyled_lines The lines whose styles were replaced by the last initialize or on_multi_line_change.
+         *        Can reach beyond the changed lines, if a change affects the lines below, like an opened comment.
+         */
+        std::pair <index_type, index_type> restyled_lines() const
+        {
+            return restyled;
+        }
+
+    protected:
+        /**
+         * @brief line_text Retrieves a line without its line ending.
+         */
+        std::string_view line_text(index_type line) const;
+
+        /**
+         * @brief relex Restyles the lines [begin, end) of an on_multi_line_change incrementally.
+         *        Lexers keep checkpoints, their state at the start of every line. Lexing goes on behind end
+         *        until a line starts in the same state as before, the styles behind that line are still valid.
+         *        Splices the new styles and brackets, updates the checkpoints and sets restyled.
+         * @param checkpoints The state at the start of every line and behind the last one.
+         * @param lex Called as lex(text, state, ranges, brackets). Appends the ranges and the brackets of a line
+         *        and returns the state of the next.
+         * @return The amount of lexed lines.
+         */
+        template <typename StateT, typename FunctionT>
+        std::size_t relex(std::vector <StateT>& checkpoints, index_type begin, index_type end, FunctionT&& lex)
+        {
+            auto const line_count = static_cast <index_type> (store->line_count());
+            auto const old_count = static_cast <index_type> (styles.line_count());
+            auto const difference = line_count - old_count - unvisited_lines;
+            auto const stop = std::min(line_count, next_group);
+
+            begin = std::clamp(begin, index_type{0}, std::min(line_count, old_count));
+            end = std::clamp(end, begin, line_count);
+            auto const old_end = std::clamp(end - difference, begin, old_count);
+
+            std::vector <style_range> ranges;
+            std::vector <std::size_t> sizes;
+            std::vector <bracket> found;
+            std::vector <std::size_t> bracket_sizes;
+            std::vector <StateT> fresh;
+
+            auto state = checkpoints[static_cast <std::size_t> (begin)];
+            auto line = begin;
+            while (line < stop)
+            {
+                auto const before = ranges.size();
+                auto const brackets_before = found.size();
+                state = lex(line_text(line), state, ranges, found);
+                sizes.push_back(ranges.size() - before);
+                bracket_sizes.push_back(found.size() - brackets_before);
+                fresh.push_back(state);
+                ++line;
+
+                // behind the change, the rest stays as it was once a line starts in the same state as before.
+                auto const old_line = line - difference;
+                if (line >= end && old_line >= old_end && checkpoints[static_cast <std::size_t> (old_line)] == state)
+                    break;
+            }
+            auto const old_stop = line - difference;
+
+            styles.splice(
+                static_cast <std::size_t> (begin),
+                static_cast <std::size_t> (old_stop),
+                sizes,
+                std::begin(ranges),
+                std::end(ranges)
+            );
+            brackets.splice(static_cast <std::size_t> (begin), static_cast <std::size_t> (old_stop), bracket_sizes, found);
+
+            // the checkpoints of the lines [begin + 1, line] replace the old ones of [begin + 1, old_stop].
+            auto position = std::begin(checkpoints) + static_cast <std::ptrdiff_t> (begin + 1);
+            auto const replaced = static_cast <std::ptrdiff_t> (old_stop - begin);
+            auto const common = std::min(replaced, static_cast <std::ptrdiff_t> (fresh.size()));
+            position = std::copy_n(std::begin(fresh), common, position);
+            if (static_cast <std::ptrdiff_t> (fresh.size()) > common)
+                checkpoints.insert(position, std::begin(fresh) + common, std::end(fresh));
+            else
+                checkpoints.erase(position, position + (replaced - common));
+
+            restyled = {begin, line};
+            return fresh.size();
+        }
 
     protected:
         data_store const* store;
+
+        /// The styles of all lines. Implementations splice the lines they restyle.
+        style_store styles;
+
+        /// The brackets in code of all lines, spliced by relex.
+        bracket_index brackets;
+
+        /// Implementations intern their styles here and put the ids into the style ranges.
+        style_palette palette;
+
+        /// Set by implementations, see restyled_lines.
+        std::pair <index_type, index_type> restyled;
+
+        /// While on_edit goes through the groups: the lines inserted by the groups behind the current one,
+        /// which the styles do not know yet, and the first line of the next group. relex stops there,
+        /// the next group goes on from the checkpoint it left.
+        index_type unvisited_lines;
+        index_type next_group;
     };
 }
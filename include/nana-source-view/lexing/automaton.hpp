@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace nana_source_view::lexing
+{
+    /**
+     *  A table driven deterministic automaton that is built at runtime from patterns, see automaton_builder.
+     *
+     *  Bytes are mapped to equivalence classes, so the table has a row per state and a column per class.
+     *  The cost of a match depends on the length of the matched text only, not on the amount of patterns.
+     */
+    class automaton
+    {
+    public:
+        using state_type = std::uint16_t;
+        using token_type = std::uint16_t;
+
+        static constexpr state_type dead = 0;
+
+        /// Returned as the token of a match if no prefix was accepted.
+        static constexpr token_type no_token = 0;
+
+        struct match
+        {
+            /// Past the last byte of the match.
+            std::size_t end;
+            token_type token;
+        };
+
+    public:
+        automaton();
+
+        /**
+         * @brief longest_match Runs the automaton from pos.
+         * @param start The start state of a group, see automaton_builder::group.
+         * @return The longest accepted match. If there is none, end is pos and the token is no_token.
+         */
+        match longest_match(std::string_view text, std::size_t pos, state_type start) const
+        {
+            match result{pos, no_token};
+            auto state = start;
+            while (pos < text.size())
+            {
+                state = next_[state * class_count_ + classes_[static_cast <unsigned char> (text[pos])]];
+                if (state == dead)
+                    break;
+                ++pos;
+                if (accepts_[state] != no_token)
+                    result = {pos, accepts_[state]};
+            }
+            return result;
+        }
+
+        /**
+         * @brief skip_dead Skips bytes that lead from state to the dead state, so no match can start with them.
+         * @return The first position at or behind pos that has a transition or text.size().
+         */
+        std::size_t skip_dead(std::string_view text, std::size_t pos, state_type state) const
+        {
+            auto const* row = next_.data() + state * class_count_;
+            while (pos < text.size() && row[classes_[static_cast <unsigned char> (text[pos])]] == dead)
+                ++pos;
+            return pos;
+        }
+
+        /**
+         * @brief next The state a byte leads to from state, dead if there is none.
+         */
+        state_type next(state_type state, char byte) const
+        {
+            return next_[state * class_count_ + classes_[static_cast <unsigned char> (byte)]];
+        }
+
+        /**
+         * @brief accepts The token of a state, no_token if it does not accept.
+         */
+        token_type accepts(state_type state) const
+        {
+            return accepts_[state];
+        }
+
+        /**
+         * @brief start The start state of a group of patterns.
+         */
+        state_type start(std::size_t group) const;
+
+        std::size_t state_count() const;
+        std::size_t class_count() const;
+
+    private:
+        friend class automaton_builder;
+
+        std::array <std::uint8_t, 256> classes_;
+        std::size_t class_count_;
+
+        /// state_count * class_count_ entries.
+        std::vector <state_type> next_;
+        std::vector <token_type> accepts_;
+        std::vector <state_type> starts_;
+    };
+
+    /**
+     *  Compiles patterns into a single automaton.
+     *
+     *  Patterns are added to groups, every group gets its own start state in the same table,
+     *  so a lexer can switch between sets of patterns, like code and strings, without switching tables.
+     *  If patterns of a group match equally long texts, the one added first wins.
+     *
+     *  The pattern syntax is a small subset of regular expressions:
+     *  - abc       literal bytes
+     *  - .         any byte
+     *  - [a-z_]    a set of bytes, [^...] the complement
+     *  - \d \w \s  digits, identifier bytes (including utf8 sequences), spaces and tabs
+     *  - \x        the byte x, for any other x: \. \[ \\ \( and so on. \t and \n are tab and line feed
+     *  - (a|b)     grouping and alternatives
+     *  - a* a+ a?  repetitions
+     */
+    class automaton_builder
+    {
+    public:
+        using token_type = automaton::token_type;
+
+    public:
+        automaton_builder();
+
+        /**
+         * @brief group Opens a new group of patterns.
+         * @return The index of the group, pass it to add and to automaton::start.
+         */
+        std::size_t group();
+
+        /**
+         * @brief add Adds a pattern to a group.
+         * @param token What longest_match returns for this pattern, must not be no_token.
+         * @throws std::invalid_argument If the pattern is malformed or matches the empty text.
+         */
+        void add(std::size_t group, std::string_view pattern, token_type token);
+
+        /**
+         * @brief build Runs the subset construction over all patterns of all groups.
+         * @throws std::length_error If the automaton needs more states than state_type can count.
+         */
+        automaton build() const;
+
+    private:
+        /**
+         *  A state of the nondeterministic automaton all patterns are first translated to.
+         */
+        struct node
+        {
+            /// The bytes that lead to next.
+            std::bitset <256> bytes;
+            std::size_t next;
+
+            /// Reached without consuming a byte.
+            std::vector <std::size_t> epsilon;
+
+            /// Patterns end here.
+            token_type accept;
+
+            /// Order of the pattern, the lowest wins among accepting nodes.
+            std::size_t priority;
+        };
+
+        /**
+         *  A piece of an automaton under construction, it is entered at first and left from last.
+         */
+        struct fragment
+        {
+            std::size_t first;
+            std::size_t last;
+        };
+
+        class parser;
+
+        std::size_t make_node();
+
+        /**
+         * @brief closure Extends a set of nodes by all nodes reachable without consuming a byte. Sorts the set.
+         */
+        void closure(std::vector <std::size_t>& nodes) const;
+
+    private:
+        std::vector <node> nodes_;
+
+        /// A node per group, with epsilon edges to the patterns of the group.
+        std::vector <std::size_t> groups_;
+
+        std::size_t patterns_;
+    };
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "scan.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+
+namespace nana_source_view::lexing
+{
+    /**
+     *  Lets a state of an automaton consume a whole run of bytes at once, instead of one transition per byte.
+     *  Only valid for states that loop to themselves on exactly these bytes.
+     */
+    enum class run_skip : std::uint8_t
+    {
+        none,
+
+        /// see is_identifier_byte
+        identifier,
+
+        /// spaces and tabs
+        blanks
+    };
+
+    /**
+     *  A table driven deterministic automaton over character classes.
+     *
+     *  Every byte is mapped to a class, transitions are looked up per state and class.
+     *  State 0 is the dead state, accepting states carry the id of the token they recognize.
+     *  Matching is greedy, the longest accepted prefix wins.
+     *  Tables are plain arrays, so automata can be built in constant expressions.
+     */
+    template <std::size_t StateCount, std::size_t ClassCount>
+    struct dfa
+    {
+        using state_type = std::uint8_t;
+        using token_type = std::uint8_t;
+
+        static constexpr state_type dead = 0;
+
+        /// Returned as the token of a match if no prefix was accepted.
+        static constexpr token_type no_token = 0;
+
+        struct match
+        {
+            /// Past the last byte of the match.
+            std::size_t end;
+            token_type token;
+        };
+
+        std::array <std::uint8_t, 256> classes{};
+        std::array <std::array <state_type, ClassCount>, StateCount> next{};
+        std::array <token_type, StateCount> accepts{};
+        std::array <run_skip, StateCount> skips{};
+
+        /**
+         *  Assigns all bytes of chars to a class.
+         */
+        constexpr void classify(std::string_view chars, std::uint8_t character_class)
+        {
+            for (auto c : chars)
+                classes[static_cast <unsigned char> (c)] = character_class;
+        }
+
+        /**
+         *  Assigns all bytes in [low, high] to a class.
+         */
+        constexpr void classify(unsigned char low, unsigned char high, std::uint8_t character_class)
+        {
+            for (unsigned c = low; c <= high; ++c)
+                classes[c] = character_class;
+        }
+
+        /**
+         *  Adds the transition from -> to for all given classes.
+         */
+        constexpr void transition(state_type from, std::initializer_list <std::uint8_t> on, state_type to)
+        {
+            for (auto character_class : on)
+                next[from][character_class] = to;
+        }
+
+        /**
+         * @brief longest_match Runs the automaton from pos.
+         * @return The longest accepted match. If there is none, end is pos and the token is no_token.
+         */
+        match longest_match(std::string_view text, std::size_t pos, state_type start) const
+        {
+            match result{pos, no_token};
+            auto state = start;
+            while (pos < text.size())
+            {
+                state = next[state][classes[static_cast <unsigned char> (text[pos])]];
+                if (state == dead)
+                    break;
+                ++pos;
+
+                switch (skips[state])
+                {
+                    case run_skip::none:
+                        break;
+                    case run_skip::identifier:
+                        pos = skip_identifier(text, pos);
+                        break;
+                    case run_skip::blanks:
+                        pos = skip_blanks(text, pos);
+                        break;
+                }
+
+                if (accepts[state] != no_token)
+                    result = {pos, accepts[state]};
+            }
+            return result;
+        }
+    };
+}
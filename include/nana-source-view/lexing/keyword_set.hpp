@@ -0,0 +1,209 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace nana_source_view::lexing
+{
+    /**
+     *  A set of words with a perfect hash, built at compile time.
+     *
+     *  Words are hashed once. The low half of the hash distributes them into buckets, every bucket gets a displacement
+     *  that is mixed into the high half, chosen such that all words of all buckets land in distinct slots
+     *  (hash and displace). A lookup therefore reads the word once to hash and once to compare with at most one word.
+     *  Most identifiers are no keywords, these are rejected by their first byte and length before hashing.
+     */
+    template <std::size_t N>
+    class keyword_set
+    {
+    public:
+        /// Amount of slots, a power of two of at least twice the words.
+        static constexpr std::size_t slot_count = []
+        {
+            std::size_t size = 1;
+            while (size < 2 * N)
+                size *= 2;
+            return size;
+        }();
+
+        static constexpr std::size_t bucket_count = N / 2 + 1;
+
+        /// Returned by find for words that are not in the set.
+        static constexpr std::size_t npos = static_cast <std::size_t> (-1);
+
+    public:
+        /**
+         *  Builds the set. Fails to compile in constant expressions if words contains duplicates.
+         */
+        constexpr explicit keyword_set(std::array <std::string_view, N> const& words)
+            : slots_{}
+            , indices_{}
+            , displacements_{}
+            , lengths_{}
+            , min_length_{static_cast <std::size_t> (-1)}
+            , max_length_{0}
+        {
+            for (std::size_t i = 0; i != N; ++i)
+            {
+                min_length_ = words[i].size() < min_length_ ? words[i].size() : min_length_;
+                max_length_ = words[i].size() > max_length_ ? words[i].size() : max_length_;
+                if (!words[i].empty())
+                    lengths_[static_cast <unsigned char> (words[i].front())] |= length_bit(words[i].size());
+                for (std::size_t j = 0; j != i; ++j)
+                    if (words[i] == words[j])
+                        throw std::invalid_argument("keyword_set: duplicate word");
+            }
+
+            std::array <std::size_t, bucket_count> bucket_sizes{};
+            for (std::size_t i = 0; i != N; ++i)
+                ++bucket_sizes[bucket_of(hash(words[i]))];
+
+            std::array <bool, slot_count> occupied{};
+            std::array <std::size_t, slot_count> placed{};
+
+            // the largest buckets are the hardest to place, so they go first.
+            for (std::size_t size = N; size != 0; --size)
+            {
+                for (std::size_t bucket = 0; bucket != bucket_count; ++bucket)
+                {
+                    if (bucket_sizes[bucket] != size)
+                        continue;
+
+                    std::uint32_t displacement = 1;
+                    for (;; ++displacement)
+                    {
+                        if (displacement == 0xFFFF)
+                            throw std::logic_error("keyword_set: no perfect hash found");
+
+                        std::size_t count = 0;
+                        bool fits = true;
+                        for (std::size_t i = 0; i != N && fits; ++i)
+                        {
+                            if (bucket_of(hash(words[i])) != bucket)
+                                continue;
+
+                            auto slot = slot_of(hash(words[i]), displacement);
+                            if (occupied[slot])
+                                fits = false;
+                            for (std::size_t k = 0; k != count && fits; ++k)
+                                if (placed[k] == slot)
+                                    fits = false;
+                            placed[count++] = slot;
+                        }
+                        if (fits)
+                            break;
+                    }
+
+                    displacements_[bucket] = static_cast <std::uint16_t> (displacement);
+                    for (std::size_t i = 0; i != N; ++i)
+                    {
+                        if (bucket_of(hash(words[i])) != bucket)
+                            continue;
+
+                        auto slot = slot_of(hash(words[i]), displacement);
+                        occupied[slot] = true;
+                        slots_[slot] = words[i];
+                        indices_[slot] = static_cast <std::uint16_t> (i);
+                    }
+                }
+            }
+        }
+
+        /**
+         *  Retrieves the index of word in the list the set was built from, or npos.
+         */
+        constexpr std::size_t find(std::string_view word) const
+        {
+            if (word.size() < min_length_ || word.size() > max_length_)
+                return npos;
+            if (!word.empty() && (lengths_[static_cast <unsigned char> (word.front())] & length_bit(word.size())) == 0)
+                return npos;
+
+            auto const h = hash(word);
+            auto const slot = slot_of(h, displacements_[bucket_of(h)]);
+            auto const& candidate = slots_[slot];
+            if (candidate.size() != word.size())
+                return npos;
+            for (std::size_t i = 0; i != word.size(); ++i)
+                if (candidate[i] != word[i])
+                    return npos;
+            return indices_[slot];
+        }
+
+        constexpr bool contains(std::string_view word) const
+        {
+            return find(word) != npos;
+        }
+
+        static constexpr std::size_t size()
+        {
+            return N;
+        }
+
+    private:
+        /**
+         *  The bit of a word length in lengths_, all lengths of 31 and above share one.
+         */
+        static constexpr std::uint32_t length_bit(std::size_t length)
+        {
+            return std::uint32_t{1} << (length < 31 ? length : 31);
+        }
+
+        /**
+         *  64 bit FNV-1a over the word.
+         */
+        static constexpr std::uint64_t hash(std::string_view word)
+        {
+            std::uint64_t h = 14695981039346656037ull;
+            for (auto c : word)
+            {
+                h ^= static_cast <unsigned char> (c);
+                h *= 1099511628211ull;
+            }
+            return h;
+        }
+
+        static constexpr std::size_t bucket_of(std::uint64_t h)
+        {
+            return static_cast <std::uint32_t> (h) % bucket_count;
+        }
+
+        static constexpr std::size_t slot_of(std::uint64_t h, std::uint32_t displacement)
+        {
+            // murmur3 finalizer over the high half and the displacement.
+            auto x = static_cast <std::uint32_t> (h >> 32) ^ (displacement * 0x9E3779B1u);
+            x ^= x >> 16;
+            x *= 0x85EBCA6Bu;
+            x ^= x >> 13;
+            x *= 0xC2B2AE35u;
+            x ^= x >> 16;
+            return x & (slot_count - 1);
+        }
+
+    private:
+        std::array <std::string_view, slot_count> slots_;
+        std::array <std::uint16_t, slot_count> indices_;
+        std::array <std::uint16_t, bucket_count> displacements_;
+
+        /// Per first byte, a bit for every length of the words starting with it.
+        std::array <std::uint32_t, 256> lengths_;
+        std::size_t min_length_;
+        std::size_t max_length_;
+    };
+
+    /**
+     *  Builds a keyword_set from a list of words, usable to initialize a constexpr variable:
+     *  constexpr auto keywords = make_keyword_set({"if", "else"});
+     */
+    template <std::size_t N>
+    constexpr keyword_set <N> make_keyword_set(std::string_view const (&words)[N])
+    {
+        std::array <std::string_view, N> list{};
+        for (std::size_t i = 0; i != N; ++i)
+            list[i] = words[i];
+        return keyword_set <N> {list};
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace nana_source_view::lexing
+{
+    /**
+     *  Is c a byte of an identifier? Letters, digits, '_' and every byte of a multi byte utf8 sequence.
+     */
+    constexpr bool is_identifier_byte(char c)
+    {
+        return (c >= 'a' && c <= 'z')
+            || (c >= 'A' && c <= 'Z')
+            || (c >= '0' && c <= '9')
+            || c == '_'
+            || static_cast <unsigned char> (c) >= 0x80
+        ;
+    }
+
+    /**
+     * @brief skip_identifier Finds the first byte at or behind pos that is not an identifier byte.
+     *        Uses SIMD if the target supports it, 16 bytes per step.
+     * @return The position of that byte or text.size().
+     */
+    std::size_t skip_identifier(std::string_view text, std::size_t pos);
+
+    /**
+     * @brief skip_blanks Finds the first byte at or behind pos that is neither a space nor a tab.
+     * @return The position of that byte or text.size().
+     */
+    std::size_t skip_blanks(std::string_view text, std::size_t pos);
+
+    /**
+     * @brief find_either Finds the first occurrence of one of two bytes at or behind pos.
+     *        Used to find the end of quoted literals, which needs the quote and the escape character.
+     * @return The position or text.size().
+     */
+    std::size_t find_either(std::string_view text, std::size_t pos, char first, char second);
+}
@@ -0,0 +1,134 @@
+/**
+ * A styler that is configured by rules instead of code
+ **/
+#pragma once
+
+#include <nana-source-view/interfaces/styler.hpp>
+#include <nana-source-view/lexing/automaton.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace nana_source_view::styles
+{
+    /**
+     *  Styles the text matched by a pattern, see lexing::automaton_builder for the syntax.
+     *  Tokens without a style are left unstyled. They are still useful to keep other rules from matching
+     *  within them, like an identifier rule keeps a keyword rule from matching the start of "iffy".
+     */
+    struct token_rule
+    {
+        std::string pattern;
+        std::optional <style> look;
+    };
+
+    /**
+     *  Text from a match of begin to a match of end, like comments or strings.
+     *  Within a scope only its own tokens and end are matched, everything else gets the style of the scope.
+     */
+    struct scope_rule
+    {
+        std::string begin;
+
+        /// Scopes without an end last until the end of the line.
+        std::string end;
+
+        style look;
+
+        /// Matched before end, like escape sequences in strings.
+        std::vector <token_rule> tokens;
+
+        /// The scope is closed at the end of a line even if end was not found.
+        bool single_line = false;
+    };
+
+    /**
+     *  Describes a language. If rules match equally long texts, tokens win over scopes and earlier over later rules.
+     */
+    struct rule_set
+    {
+        std::vector <token_rule> tokens;
+        std::vector <scope_rule> scopes;
+    };
+
+    /**
+     *  Highlights text by a rule_set.
+     *
+     *  All rules are compiled into a single automaton once, scopes are start states within it.
+     *  So the cost of styling depends on the text only, not on the amount of rules.
+     *  The open scope at the start of every line is kept as a checkpoint to restyle incrementally, like c_style does.
+     */
+    class rule_style : public styler
+    {
+    public:
+        /// 0 is outside of all scopes, scope_rules[i] is i + 1.
+        using scope_index = std::uint16_t;
+
+    public:
+        /**
+         * @throws std::invalid_argument If a pattern is malformed or matches the empty text.
+         */
+        rule_style(data_store const* store, rule_set rules);
+
+        void initialize() override;
+        void on_multi_line_change(index_type begin, index_type end) override;
+
+        /**
+         * @brief scope_at The scope that is open at the start of a line.
+         */
+        scope_index scope_at(index_type line) const;
+
+        /**
+         * @brief relexed_lines The amount of lines lexed by the last update.
+         */
+        std::size_t relexed_lines() const;
+
+    private:
+        /**
+         *  What happens if the token of a rule is matched.
+         */
+        struct action
+        {
+            /// The scope that is open behind the token.
+            scope_index next_scope;
+
+            /// The rule's style, interned on initialize.
+            std::optional <style> look;
+            style_id id;
+        };
+
+        /**
+         * @brief lex_line Lexes a single line and appends its style ranges and the brackets in code.
+         * @param scope The scope open at the start of the line.
+         * @return The scope open at the start of the next line.
+         */
+        scope_index lex_line
+        (
+            std::string_view text,
+            scope_index scope,
+            std::vector <style_range>& ranges,
+            std::vector <bracket>& found
+        ) const;
+
+    private:
+        lexing::automaton automaton_;
+
+        /// Per token of the automaton, index 0 is lexing::automaton::no_token.
+        std::vector <action> actions_;
+
+        /// The start state and the style of every scope, index 0 is outside of all scopes and unstyled.
+        std::vector <lexing::automaton::state_type> starts_;
+        std::vector <style> scope_looks_;
+        std::vector <style_id> scope_ids_;
+
+        /// Scopes that are closed at the end of a line.
+        std::vector <bool> single_line_;
+
+        /// The scope at the start of every line, and behind the last one.
+        std::vector <scope_index> scopes_;
+
+        std::size_t relexed_;
+    };
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <nana-source-view/abstractions/store.hpp>
+#include <nana-source-view/skeleton/paint_sink.hpp>
+
+#include <nana/basic_types.hpp>
+
+#include <chrono>
+#include <optional>
+#include <vector>
+
+namespace nana_source_view::skeletons
+{
+    class text_renderer;
+
+    /**
+     *  Draws the carets of the visible lines and makes them blink.
+     *
+     *  The pixels under the carets are saved once per full render.
+     *  A blink only draws or restores these small areas, all carets at once, the rest of the editor is left alone.
+     *  Blinking pauses while the user types and stops entirely after a while without input,
+     *  so an idle editor does not need a timer at all.
+     */
+    class caret_blinker
+    {
+    public:
+        using index_type = data_store::index_type;
+        using clock_type = std::chrono::steady_clock;
+
+    public:
+        caret_blinker(data_store const* store);
+
+        caret_blinker(caret_blinker const&) = delete;
+        caret_blinker& operator=(caret_blinker const&) = delete;
+
+        /**
+         * @brief color Sets the color of the carets.
+         */
+        void color(nana::color const& color);
+
+        /**
+         * @brief timing Configures the blinking.
+         * @param interval Time between two phases.
+         * @param typing_pause Carets stay visible for this long after activity.
+         * @param idle_timeout Carets stop blinking and stay visible after this long without activity.
+         */
+        void timing
+        (
+            std::chrono::milliseconds interval,
+            std::chrono::milliseconds typing_pause,
+            std::chrono::milliseconds idle_timeout
+        );
+
+        /**
+         * @brief interval The time between two phases, the rate tick should be called with.
+         */
+        std::chrono::milliseconds interval() const;
+
+        /**
+         * @brief render Locates the visible carets and draws them if they are in their visible phase.
+         *        Must be called after every full render, because it saves what is under the carets.
+         * @param focused Carets are only drawn into focused editors.
+         */
+        void render(text_renderer const& layout, paint_sink& sink, bool focused, clock_type::time_point now);
+
+        /**
+         * @brief tick Advances the blinking.
+         * @return true if the carets were drawn or erased. Only the caret areas need to be brought to the screen.
+         */
+        bool tick(paint_sink& sink, clock_type::time_point now);
+
+        /**
+         * @brief activity Notifies about user input. Shows the carets and pauses the blinking.
+         * @return true if the carets were drawn.
+         */
+        bool activity(paint_sink& sink, clock_type::time_point now);
+
+        /**
+         * @brief blinking Does tick still need to be called? False if there is nothing to blink or the editor is idle.
+         */
+        bool blinking(clock_type::time_point now) const;
+
+        /**
+         * @brief areas Retrieves the caret rectangles of the last render.
+         */
+        std::vector <nana::rectangle> const& areas() const;
+
+        /**
+         * @brief shown Are the carets currently drawn?
+         */
+        bool shown() const;
+
+    private:
+        /**
+         * @brief paint Draws the carets or restores what was under them, depending on the phase.
+         */
+        void paint(paint_sink& sink);
+
+    private:
+        data_store const* store_;
+        nana::color color_;
+
+        std::chrono::milliseconds interval_;
+        std::chrono::milliseconds typing_pause_;
+        std::chrono::milliseconds idle_timeout_;
+        clock_type::time_point last_activity_;
+
+        std::vector <nana::rectangle> areas_;
+
+        /// The pixels under the carets. Released on the next render.
+        std::optional <std::size_t> saved_;
+        paint_sink* saved_sink_;
+
+        bool focused_;
+        bool shown_;
+    };
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <nana-source-view/abstractions/store.hpp>
+#include <nana-source-view/abstractions/detail/implicit_treap.hpp>
+#include <nana-source-view/interfaces/edit_observer.hpp>
+#include <nana-source-view/interfaces/styler.hpp>
+#include <nana-source-view/skeleton/paint_sink.hpp>
+
+#include <nana/basic_types.hpp>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace nana_source_view::skeletons
+{
+    /**
+     *  An overview strip of the whole document.
+     *
+     *  The minimap keeps a small summary per line and renders by downsampling these summaries.
+     *  It reads document bytes only for lines that were edited, never when drawing.
+     *  The summaries are kept in a treap that aggregates them, so inserting lines does not move the ones behind,
+     *  and a row is the aggregate of its lines in O(log n). Rows behind an edit that changes the line count
+     *  have to be recomputed, which costs O(log n) per row instead of a pass over all lines behind.
+     */
+    class minimap : public edit_observer
+    {
+    public:
+        using index_type = data_store::index_type;
+
+        /**
+         *  What the minimap knows about a line. Columns are clamped to 16 bit.
+         */
+        struct line_summary
+        {
+            /// Columns of leading whitespace.
+            std::uint16_t indent;
+
+            /// Columns after the indentation, without the line ending.
+            std::uint16_t length;
+
+            /// The palette id of the style covering most of the line. 0 is unstyled text.
+            style_id style_class;
+        };
+
+    public:
+        minimap(data_store const* store);
+
+        /**
+         * @brief rebuild Summarizes every line of the store. Called on construction.
+         */
+        void rebuild();
+
+        /**
+         * @brief on_edit Updates the summaries of the edited lines.
+         */
+        void on_edit(std::vector <edit_delta> const& deltas) override;
+
+        /**
+         * @brief restyle Updates the dominant styles of the lines [begin, end) from the styler.
+         */
+        void restyle(styler& sty, index_type begin, index_type end);
+
+        /**
+         * @brief colors Sets the background and the color of unstyled text.
+         */
+        void colors(nana::color const& fgcolor, nana::color const& bgcolor);
+
+        /**
+         * @brief render Draws the overview into area.
+         * @param visible_lines The lines visible in the text area, they get framed.
+         */
+        void render(paint_sink& sink, nana::rectangle const& area, std::pair <index_type, index_type> visible_lines);
+
+        /**
+         * @brief summary Retrieves the summary of a single line.
+         */
+        line_summary const& summary(index_type line) const;
+
+    private:
+        /**
+         *  A downsampled pixel row of the minimap.
+         */
+        struct row
+        {
+            std::uint16_t indent;
+            std::uint16_t extent;
+            std::uint16_t style_class;
+
+            /// 0 - 255, the share of non empty lines in this row.
+            std::uint8_t density;
+        };
+
+        /**
+         *  The aggregate of a range of lines, a row is made from.
+         */
+        struct range_summary
+        {
+            std::size_t lines;
+
+            /// Lines that are not empty, the rest only count for lines.
+            std::size_t filled;
+            std::uint16_t indent;
+            std::uint16_t extent;
+
+            /// The length and style of the last of the longest lines.
+            std::uint16_t longest;
+            style_id style_class;
+        };
+
+        struct summary_traits
+        {
+            using summary_type = range_summary;
+
+            static range_summary identity();
+            static range_summary summarize(line_summary const& line);
+            static range_summary combine(range_summary const& lhs, range_summary const& rhs);
+        };
+
+        /**
+         * @brief summarize Summarizes a single line by reading it from the store.
+         */
+        line_summary summarize(index_type line) const;
+
+        /**
+         * @brief lines_per_row How many lines are combined into a row for the given amount of rows.
+         */
+        std::size_t lines_per_row(std::size_t row_count) const;
+
+        /**
+         * @brief update_rows Recomputes all rows that are marked dirty.
+         */
+        void update_rows(std::size_t row_count);
+
+        /**
+         * @brief invalidate Marks the rows containing the lines [begin, end) dirty.
+         *        Everything gets invalidated if the amount of lines changed.
+         */
+        void invalidate(std::size_t begin, std::size_t end);
+
+    private:
+        data_store const* store_;
+        detail::implicit_treap <line_summary, summary_traits> summaries_;
+
+        /// Colors of style classes, index 0 is unstyled text.
+        std::vector <nana::color> class_colors_;
+        nana::color bgcolor_;
+
+        std::vector <row> rows_;
+
+        /// Lines per row the rows were computed with.
+        std::size_t row_scale_;
+
+        /// The range of lines that need their rows recomputed.
+        std::size_t dirty_begin_;
+        std::size_t dirty_end_;
+    };
+}
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <nana/basic_types.hpp>
+#include <nana/paint/graphics.hpp>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+namespace nana_source_view::skeletons
+{
+    /**
+     *  Everything the editor draws goes through a paint sink.
+     *  This decouples layout and painting from nana::paint::graphics, so rendering can run without a display.
+     */
+    class paint_sink
+    {
+    public:
+        /**
+         *  A handle to a strip of pre-rendered glyphs, see make_atlas.
+         */
+        struct glyph_atlas
+        {
+            std::size_t id;
+
+            /// Every glyph occupies a cell of this size.
+            nana::size cell;
+        };
+
+        virtual ~paint_sink() = default;
+
+        /**
+         * @brief typeface Sets the font for all following text operations.
+         */
+        virtual void typeface(nana::paint::font const& font) = 0;
+
+        /**
+         * @brief text_extent_size Measures a utf8 text with the current typeface.
+         */
+        virtual nana::size text_extent_size(std::string_view text) const = 0;
+
+        /**
+         * @brief rectangle Draws a rectangle.
+         * @param solid Fills the rectangle if true, only draws the border otherwise.
+         */
+        virtual void rectangle(nana::rectangle const& rect, nana::color const& color, bool solid = true) = 0;
+
+        /**
+         * @brief line Draws a line between the two points.
+         */
+        virtual void line(nana::point const& from, nana::point const& to, nana::color const& color) = 0;
+
+        /**
+         * @brief string Draws a single run of utf8 text. pos is the upper left corner.
+         */
+        virtual void string(nana::point const& pos, std::string_view text, nana::color const& color) = 0;
+
+        /**
+         * @brief make_atlas Pre-renders every code point of glyphs with the current typeface into equally sized cells.
+         *        The atlas lives until it is released or the sink is destroyed.
+         */
+        virtual glyph_atlas make_atlas(std::string_view glyphs, nana::color const& fgcolor, nana::color const& bgcolor) = 0;
+
+        /**
+         * @brief blit_glyph Copies the cell of the glyph at index in the atlas to pos.
+         */
+        virtual void blit_glyph(glyph_atlas const& atlas, std::size_t index, nana::point const& pos) = 0;
+
+        /**
+         * @brief release_atlas Frees the atlas. The handle must not be used afterwards.
+         */
+        virtual void release_atlas(glyph_atlas const& atlas) = 0;
+
+        /**
+         * @brief save_areas Copies the pixels of all areas, so overlays drawn on top can be undone without a repaint.
+         * @return A handle for restore_areas and release_areas.
+         */
+        virtual std::size_t save_areas(std::vector <nana::rectangle> const& areas) = 0;
+
+        /**
+         * @brief restore_areas Copies the saved pixels back to where they were taken from.
+         */
+        virtual void restore_areas(std::size_t id) = 0;
+
+        /**
+         * @brief release_areas Frees saved pixels. The handle must not be used afterwards.
+         */
+        virtual void release_areas(std::size_t id) = 0;
+    };
+
+    /**
+     *  The paint sink that draws onto a nana graphics object. Used by the widget.
+     */
+    class graphics_paint_sink : public paint_sink
+    {
+    public:
+        using graph_reference = ::nana::paint::graphics&;
+
+        explicit graphics_paint_sink(graph_reference graph);
+
+        void typeface(nana::paint::font const& font) override;
+        nana::size text_extent_size(std::string_view text) const override;
+        void rectangle(nana::rectangle const& rect, nana::color const& color, bool solid) override;
+        void line(nana::point const& from, nana::point const& to, nana::color const& color) override;
+        void string(nana::point const& pos, std::string_view text, nana::color const& color) override;
+        glyph_atlas make_atlas(std::string_view glyphs, nana::color const& fgcolor, nana::color const& bgcolor) override;
+        void blit_glyph(glyph_atlas const& atlas, std::size_t index, nana::point const& pos) override;
+        void release_atlas(glyph_atlas const& atlas) override;
+        std::size_t save_areas(std::vector <nana::rectangle> const& areas) override;
+        void restore_areas(std::size_t id) override;
+        void release_areas(std::size_t id) override;
+
+    private:
+        /**
+         *  Saved areas are packed next to each other into a single graphics.
+         */
+        struct saved_areas
+        {
+            std::unique_ptr <nana::paint::graphics> pixels;
+            std::vector <nana::rectangle> areas;
+        };
+
+    private:
+        graph_reference graph_;
+
+        /// Released atlases leave an empty slot behind, which is reused.
+        std::vector <std::unique_ptr <nana::paint::graphics>> atlases_;
+
+        /// Released saves leave an empty slot behind, which is reused.
+        std::vector <saved_areas> saves_;
+    };
+
+    /**
+     *  A headless paint sink. Counts everything that would have been drawn and optionally records the commands.
+     *  Text is measured with a fixed glyph size, so layout is deterministic and independent of installed fonts.
+     */
+    class recording_paint_sink : public paint_sink
+    {
+    public:
+        struct statistics
+        {
+            /// Total amount of drawing operations, measurements excluded.
+            std::size_t draw_calls = 0;
+            std::size_t rectangles = 0;
+            std::size_t lines = 0;
+            std::size_t text_runs = 0;
+
+            /// Sum of the byte sizes of all text runs.
+            std::size_t text_bytes = 0;
+
+            std::size_t typeface_changes = 0;
+            std::size_t measurements = 0;
+
+            /// Glyphs copied out of atlases. Also counted as draw calls.
+            std::size_t blits = 0;
+            std::size_t atlases_made = 0;
+            std::size_t atlases_released = 0;
+
+            /// Areas saved and restored, every area counts. Restores are also counted as draw calls.
+            std::size_t areas_saved = 0;
+            std::size_t areas_restored = 0;
+        };
+
+        enum class command_kind
+        {
+            rectangle,
+            line,
+            string,
+            blit,
+            restore
+        };
+
+        struct command
+        {
+            command_kind kind;
+
+            /// For lines this spans from the first to the second point. For strings and blits it is the text box.
+            nana::rectangle area;
+            nana::color color;
+
+            /// The drawn text. For blits the glyph that was copied.
+            std::string text;
+        };
+
+        /**
+         * @param glyph_size The size every code point is measured with.
+         * @param record_commands Keep a list of all commands? Otherwise only count them.
+         */
+        explicit recording_paint_sink(nana::size const& glyph_size = {8, 16}, bool record_commands = false);
+
+        void typeface(nana::paint::font const& font) override;
+        nana::size text_extent_size(std::string_view text) const override;
+        void rectangle(nana::rectangle const& rect, nana::color const& color, bool solid) override;
+        void line(nana::point const& from, nana::point const& to, nana::color const& color) override;
+        void string(nana::point const& pos, std::string_view text, nana::color const& color) override;
+        glyph_atlas make_atlas(std::string_view glyphs, nana::color const& fgcolor, nana::color const& bgcolor) override;
+        void blit_glyph(glyph_atlas const& atlas, std::size_t index, nana::point const& pos) override;
+        void release_atlas(glyph_atlas const& atlas) override;
+        std::size_t save_areas(std::vector <nana::rectangle> const& areas) override;
+        void restore_areas(std::size_t id) override;
+        void release_areas(std::size_t id) override;
+
+        /**
+         * @brief stats Retrieves the counters collected since construction or the last reset.
+         */
+        statistics const& stats() const;
+
+        /**
+         * @brief commands Retrieves all recorded commands. Empty if recording is off.
+         */
+        std::vector <command> const& commands() const;
+
+        /**
+         * @brief reset Clears all counters and recorded commands.
+         */
+        void reset();
+
+    private:
+        /**
+         *  Measures without counting the measurement.
+         */
+        nana::size measure(std::string_view text) const;
+
+    private:
+        nana::size glyph_size_;
+        bool record_commands_;
+        mutable statistics stats_;
+        std::vector <command> commands_;
+
+        /// The glyphs of every atlas, split into code points. Released atlases leave an empty slot behind, which is reused.
+        std::vector <std::optional <std::vector <std::string>>> atlases_;
+
+        /// The areas of every save. Released saves leave an empty slot behind, which is reused.
+        std::vector <std::optional <std::vector <nana::rectangle>>> saves_;
+    };
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <nana-source-view/abstractions/store.hpp>
+#include <nana-source-view/abstractions/anchor_set.hpp>
+#include <nana-source-view/skeleton/paint_sink.hpp>
+
+#include <nana/basic_types.hpp>
+
+#include <vector>
+
+namespace nana_source_view::skeletons
+{
+    class text_renderer;
+
+    /**
+     *  Paints the selections of all carets that reach into the visible lines.
+     *
+     *  Carets are visited in a single sweep that starts at the first caret touching the view,
+     *  so the cost depends on the visible carets and not on all carets of the document.
+     *  Selections that touch or overlap on a line are merged into one rectangle.
+     */
+    class selection_renderer
+    {
+    public:
+        using index_type = data_store::index_type;
+
+    public:
+        selection_renderer(data_store const* store);
+
+        /**
+         * @brief color Sets the color selections are filled with.
+         */
+        void color(nana::color const& color);
+
+        /**
+         * @brief collect Computes the merged selection rectangles of the visible lines.
+         * @param layout Provides the visible lines and the horizontal positions of offsets.
+         * @return The rectangles sorted top to bottom and left to right. Valid until the next collect.
+         */
+        std::vector <nana::rectangle> const& collect(text_renderer const& layout, paint_sink& sink);
+
+        /**
+         * @brief collect Computes the merged rectangles of ranges, like search results, on the visible lines.
+         * @param ranges Sorted and not overlapping, see anchor_set::overlapping.
+         * @return The rectangles sorted top to bottom and left to right. Valid until the next collect.
+         */
+        std::vector <nana::rectangle> const& collect
+        (
+            text_renderer const& layout,
+            paint_sink& sink,
+            std::vector <anchored_range> const& ranges
+        );
+
+        /**
+         * @brief render Collects and fills the selection rectangles.
+         */
+        void render(text_renderer const& layout, paint_sink& sink);
+
+    private:
+        /**
+         *  Where the sweep over the visible lines is, ranges are added from top to bottom.
+         */
+        struct sweep
+        {
+            index_type first;
+            index_type last;
+            index_type visible_begin;
+            index_type visible_end;
+            index_type line;
+        };
+
+        /**
+         * @brief begin_sweep Clears the spans and starts a sweep over the visible lines.
+         */
+        sweep begin_sweep(text_renderer const& layout);
+
+        /**
+         * @brief line_start Where a line begins, the end of the document for the line count.
+         */
+        index_type line_start(index_type line) const;
+
+        /**
+         * @brief add_range Adds the spans of the range [begin, end) to the visible lines, a span per row.
+         * @param cursor A text_renderer::x_cursor, kept over the whole sweep. Only used in the implementation.
+         */
+        template <typename CursorT>
+        void add_range
+        (
+            text_renderer const& layout,
+            paint_sink& sink,
+            sweep& state,
+            CursorT& cursor,
+            index_type begin,
+            index_type end
+        );
+
+        /**
+         * @brief add_span Adds a span on a line, merges it with the previous span if they touch.
+         */
+        void add_span(int y, int left, int right, unsigned height);
+
+    private:
+        data_store const* store_;
+        nana::color color_;
+        std::vector <nana::rectangle> spans_;
+    };
+}
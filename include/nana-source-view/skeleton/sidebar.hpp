@@ -1,4 +1,108 @@
-#ifndef SIDEBAR_HPP
-#define SIDEBAR_HPP
+#pragma once
 
-#endif // SIDEBAR_HPP
+#include <nana-source-view/abstractions/store.hpp>
+#include <nana-source-view/skeleton/paint_sink.hpp>
+
+#include <nana/basic_types.hpp>
+#include <nana/paint/graphics.hpp>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace nana_source_view::skeletons
+{
+    /**
+     *  The gutter left of the text. Renders the line numbers of the visible lines.
+     *
+     *  Digits are rendered once into an atlas and composed per line by copying cells,
+     *  so drawing the gutter never lays out or measures text.
+     *  The atlas is released through the sink it was made by, when it is rebuilt, when the sidebar draws to another
+     *  sink and when the sidebar is destroyed. So that sink has to outlive the sidebar or its use of the sink.
+     */
+    class sidebar
+    {
+    public:
+        using index_type = data_store::index_type;
+
+    public:
+        sidebar(data_store const* store);
+        ~sidebar();
+
+        sidebar(sidebar const&) = delete;
+        sidebar& operator=(sidebar const&) = delete;
+
+        /**
+         * @brief font Sets the font for the line numbers. Invalidates the digit atlas.
+         */
+        void font(nana::paint::font const& font);
+
+        /**
+         * @brief colors Sets the colors of the gutter. Invalidates the digit atlas.
+         */
+        void colors(nana::color const& fgcolor, nana::color const& bgcolor);
+
+        /**
+         * @brief width Retrieves the width of the gutter in pixels.
+         *        Only recalculated if the amount of digits of the line count changes.
+         * @param sink The sink the atlas is built for, if it is not yet.
+         */
+        unsigned width(paint_sink& sink);
+
+        /**
+         * @brief render Renders the line numbers of the visible lines.
+         * @param area The area of the gutter. Its width should be what width() returned.
+         * @param visible_lines The first visible line and the past the end line.
+         * @param line_height The height of a line, must match the text.
+         */
+        void render
+        (
+            paint_sink& sink,
+            nana::rectangle const& area,
+            std::pair <index_type, index_type> visible_lines,
+            unsigned line_height
+        );
+
+        /**
+         * @brief render Renders the line numbers of lines that do not follow each other at line_height,
+         *        like wrapped lines or the lines around a fold.
+         * @param line_tops Every visible line and its vertical pixel position.
+         */
+        void render
+        (
+            paint_sink& sink,
+            nana::rectangle const& area,
+            std::vector <std::pair <index_type, int>> const& line_tops,
+            unsigned line_height
+        );
+
+    private:
+        /**
+         * @brief prepare (Re)builds the atlas if it is invalid or was built for another sink, which releases the old one.
+         */
+        void prepare(paint_sink& sink);
+
+        /**
+         * @brief release Releases the atlas if there is one.
+         */
+        void release();
+
+        /**
+         * @brief digit_count The amount of decimal digits of a number. At least 1.
+         */
+        static unsigned digit_count(std::size_t number);
+
+    private:
+        data_store const* store_;
+        nana::paint::font font_;
+        nana::color fgcolor_;
+        nana::color bgcolor_;
+
+        std::optional <paint_sink::glyph_atlas> atlas_;
+        paint_sink* atlas_sink_;
+
+        /// digits of the line count at the last width calculation. 0 = dirty.
+        unsigned digits_;
+        unsigned width_;
+    };
+}
@@ -2,18 +2,32 @@
 
 #include "source_view_scheme.hpp"
 #include <nana-source-view/skeleton/text_renderer.hpp>
+#include <nana-source-view/skeleton/paint_sink.hpp>
+#include <nana-source-view/skeleton/sidebar.hpp>
+#include <nana-source-view/skeleton/minimap.hpp>
+#include <nana-source-view/skeleton/caret_blinker.hpp>
+#include <nana-source-view/interfaces/edit_observer.hpp>
+#include <nana-source-view/abstractions/occurrence_index.hpp>
+#include <nana-source-view/abstractions/anchor_set.hpp>
+#include <nana-source-view/abstractions/literal_finder.hpp>
+#include <nana-source-view/abstractions/background_search.hpp>
+#include <nana-source-view/abstractions/incremental_search.hpp>
+#include <nana-source-view/abstractions/line_operations.hpp>
+#include <nana-source-view/abstractions/wrap_layout.hpp>
+#include <nana-source-view/abstractions/fold_tree.hpp>
 
 #include <memory>
 
 #include <nana/gui/widgets/widget.hpp>
 #include <nana/gui/detail/general_events.hpp>
 #include <nana/gui/detail/drawer.hpp>
+#include <nana/gui/timer.hpp>
 #include <nana/basic_types.hpp>
 #include <nana/unicode_bidi.hpp>
 
 namespace nana_source_view::skeletons
 {
-    class source_editor_impl
+    class source_editor_impl : public edit_observer
     {
     public: // Typedefs
         using graph_reference = ::nana::paint::graphics&;
@@ -22,6 +36,11 @@ namespace nana_source_view::skeletons
         source_editor_impl(nana::window, graph_reference, skeletons::source_editor_scheme const*);
         ~source_editor_impl();
 
+        /**
+         * @brief on_edit Restyles the edited lines.
+         */
+        void on_edit(std::vector <edit_delta> const& deltas) override;
+
         /**
          * @brief render Renders the textbox
          * @param focused
@@ -34,6 +53,153 @@ namespace nana_source_view::skeletons
          */
         void area(nana::rectangle const& rect);
 
+        /**
+         * @brief typeface Sets the font of the text and the line numbers.
+         */
+        void typeface(nana::paint::font const& font);
+
+        /**
+         * @brief focus Informs this impl that the focus was gained or lost.
+         */
+        void focus(bool getting);
+
+        /**
+         * @brief caret_activity Called on user input. Shows the carets and pauses their blinking.
+         */
+        void caret_activity();
+
+        /**
+         * @brief mouse_down Places the caret at a point and starts dragging a selection from there.
+         * @param shift Extends the selection of the first caret to the point instead.
+         * @param ctrl Adds a caret at the point instead, nothing is dragged.
+         * @param alt Starts a box selection, see select_box. Columns are glyph widths.
+         */
+        void mouse_down(nana::point const& point, bool shift, bool ctrl, bool alt);
+
+        /**
+         * @brief mouse_move Drags the selection to a point. Above or below the text area, the text scrolls towards it.
+         */
+        void mouse_move(nana::point const& point);
+
+        /**
+         * @brief mouse_up Ends dragging.
+         */
+        void mouse_up();
+
+        /**
+         * @brief double_click Selects the word at a point, see basic_navigator::select_word.
+         */
+        void double_click(nana::point const& point);
+
+        /**
+         * @brief matching_brackets For every caret next to a bracket in code, the offsets of that bracket and its match.
+         *        The bracket behind a caret is preferred over the one before it.
+         */
+        std::vector <std::pair <data_store::index_type, data_store::index_type>> matching_brackets();
+
+        /**
+         * @brief jump_to_matching_brackets Moves every caret next to a bracket to the same side of the matching one.
+         */
+        void jump_to_matching_brackets();
+
+        /**
+         * @brief occurrences_of_word The offsets of all occurrences of the identifier at the first caret, for highlighting.
+         */
+        std::vector <data_store::index_type> occurrences_of_word();
+
+        /**
+         * @brief select_all_occurrences Replaces the carets by selections of every occurrence of the identifier
+         *        at the first caret. Nothing happens if there is no identifier at it.
+         */
+        void select_all_occurrences();
+
+        /**
+         * @brief word_completions Up to count identifiers of the document, that complete the one before the first caret.
+         *        Most frequent first.
+         */
+        std::vector <word_trie::candidate> word_completions(std::size_t count);
+
+        /**
+         * @brief overlays Ranges of the owner, like diagnostics or bookmarks, that follow all edits.
+         */
+        anchor_set& overlays();
+
+        /**
+         * @brief select_all_matches Selects every match of a literal string. The carets stay if there is none.
+         * @return The amount of matches.
+         */
+        std::size_t select_all_matches(std::string_view needle, find_case mode);
+
+        /**
+         * @brief select_box Selects a rectangle of lines and columns with a caret per line,
+         *        see basic_navigator::select_box.
+         */
+        void select_box
+        (
+            data_store::index_type anchor_line,
+            data_store::index_type anchor_column,
+            data_store::index_type active_line,
+            data_store::index_type active_column
+        );
+
+        /**
+         * @brief arrow_up Moves the carets a row up, over wrapped rows and folded lines.
+         * @param shift Extends the selections instead.
+         */
+        void arrow_up(bool shift);
+
+        /**
+         * @brief arrow_down Moves the carets a row down, over wrapped rows and folded lines.
+         * @param shift Extends the selections instead.
+         */
+        void arrow_down(bool shift);
+
+        /**
+         * @brief replace_all_matches Replaces every match of a literal string at once.
+         * @return The replacements that undo it, see data_store::replace_all.
+         */
+        std::vector <data_store::replacement> replace_all_matches(std::string_view needle, std::string_view text, find_case mode);
+
+        /**
+         * @brief lines Sorting, moving and duplicating of whole lines, usually of line_operations::caret_lines.
+         */
+        line_operations lines();
+
+        /**
+         * @brief find_pattern Starts searching a regular expression in the background, see background_search.
+         *        Matches show up in search().results() while the search runs.
+         * @throws std::invalid_argument If the pattern is malformed.
+         */
+        void find_pattern(std::string_view pattern);
+
+        /**
+         * @brief find_as_you_type Searches a literal query while it is typed, see incremental_search.
+         * @return The beginnings of all matches.
+         */
+        std::vector <std::size_t> const& find_as_you_type(std::string_view query, find_case mode);
+
+        /**
+         * @brief search The running or last background search.
+         */
+        background_search const& search() const;
+
+        /**
+         * @brief word_wrap Wraps lines at the width of the text area, or stops wrapping them.
+         *        After a resize, the visible lines are wrapped right away and the rest shortly after on several threads.
+         */
+        void word_wrap(bool enabled);
+
+        /**
+         * @brief folds The regions that can be collapsed. Collapsing or expanding them needs a redraw.
+         */
+        fold_tree& folds();
+
+        /**
+         * @brief derive_folds Sets the regions from the brackets the styler reports, or from the indentation.
+         *        Collapsed regions that are found again stay collapsed.
+         */
+        void derive_folds();
+
         /**
          * @brief text Sets the text of the editor
          * @param rect
@@ -52,18 +218,111 @@ namespace nana_source_view::skeletons
         template <typename T, typename... Args>
         T* replace_styler(Args&&... args)
         {
-            return renderer_.replace_styler<T>(std::forward <Args&&> (args)...);
+            auto* sty = renderer_.replace_styler<T>(std::forward <Args&&> (args)...);
+            styler_replaced_(sty);
+            return sty;
         }
 
     private: // Internal Implementations
         ::nana::color bgcolor_() const;
 
+        /**
+         * @brief layout_ Distributes the area between the gutter and the text.
+         */
+        void layout_();
+
+        /**
+         * @brief minimap_area_ The strip on the right the minimap is drawn into.
+         */
+        nana::rectangle minimap_area_() const;
+
+        /**
+         * @brief styler_replaced_ Initializes a new styler and passes its styles on.
+         */
+        void styler_replaced_(styler* sty);
+
+        /**
+         * @brief blink_ Advances the caret blinking. Only the caret areas are redrawn.
+         */
+        void blink_();
+
+        /**
+         * @brief update_blink_timer_ Starts or stops the timer, depending on whether the carets need to blink.
+         */
+        void update_blink_timer_();
+
+        /**
+         * @brief poll_search_ Takes over the matches of the background search and redraws if there are new ones.
+         */
+        void poll_search_();
+
+        /**
+         * @brief rewrap_ Wraps the lines that were left stale by the last render and redraws.
+         */
+        void rewrap_();
+
+        /**
+         * @brief drag_to_ Extends the dragged selection, or box, to a point.
+         */
+        void drag_to_(nana::point const& point);
+
+        /**
+         * @brief autoscroll_ Scrolls while a selection is dragged above or below the text area, faster further away.
+         */
+        void autoscroll_();
+
+        /**
+         * @brief scroll_by_ Scrolls rows down, or up if negative, within the document.
+         */
+        void scroll_by_(data_store::index_type rows);
+
+        /**
+         * @brief box_column_ The column of a box selection at a horizontal pixel position.
+         */
+        data_store::index_type box_column_(int x) const;
+
+    private:
+        /**
+         *  A selection that is dragged with the mouse.
+         */
+        struct drag_state
+        {
+            bool active;
+            bool box;
+
+            /// Where a drag of a selection began.
+            data_store::index_type anchor;
+
+            /// Where a drag of a box began.
+            data_store::index_type anchor_line;
+            data_store::index_type anchor_column;
+
+            /// The last position of the mouse.
+            nana::point point;
+        };
+
     private:
         struct implementation;
         std::unique_ptr <implementation> impl_;
         text_renderer renderer_;
         nana::window window_;
         graph_reference graph_;
+        graphics_paint_sink sink_;
+        sidebar sidebar_;
+        unsigned gutter_width_;
+        minimap minimap_;
+        occurrence_index occurrences_;
+        anchor_set overlays_;
+        background_search search_;
+        incremental_search typed_search_;
+        wrap_layout wrap_;
+        fold_tree folds_;
+        caret_blinker carets_;
+        drag_state drag_;
+        nana::timer blink_timer_;
+        nana::timer search_timer_;
+        nana::timer wrap_timer_;
+        nana::timer drag_timer_;
         skeletons::source_editor_scheme const* scheme_;
     };
 }
@@ -2,18 +2,41 @@
 
 #include <nana-source-view/interfaces/styler.hpp>
 #include <nana-source-view/abstractions/store.hpp>
+#include <nana-source-view/abstractions/anchor_set.hpp>
+#include <nana-source-view/abstractions/wrap_layout.hpp>
+#include <nana-source-view/skeleton/paint_sink.hpp>
+#include <nana-source-view/skeleton/selection_renderer.hpp>
 
 #include <nana/basic_types.hpp>
 #include <nana/paint/graphics.hpp>
 
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace nana_source_view::skeletons
 {
     class text_renderer
     {
     public: // Typedefs
-        using graph_reference = ::nana::paint::graphics&;
         using index_type = data_store::index_type;
 
+        /**
+         *  Remembers the last position computed by offset_x,
+         *  so that positions on a line can be computed from left to right in linear time.
+         */
+        struct x_cursor
+        {
+            index_type line = -1;
+            index_type offset = 0;
+            int x = 0;
+
+            /// Where the row of offset begins, when the line is wrapped.
+            index_type row_begin = 0;
+        };
+
     public:
         text_renderer(data_store const* store);
 
@@ -44,17 +67,54 @@ namespace nana_source_view::skeletons
          */
         void text_area(nana::rectangle const& rect);
 
+        /**
+         * @brief text_area Retrieves the text area.
+         */
+        nana::rectangle text_area() const;
+
         /**
          * @brief render Renders the visible text into the box.
-         * @param graph
+         * @param sink Where to paint to. Can be headless.
+         */
+        void render(paint_sink& sink);
+
+        /**
+         * @brief update_scroll Set the first row that is scrolled to. Rows are lines, unless lines are wrapped or hidden.
+         * @param scroll_top_row the top row in the scrolled area.
+         */
+        void update_scroll(index_type scroll_top_row);
+
+        /**
+         * @brief scroll_top The first row that is scrolled to, for positioning a scrollbar. O(log n) with a row layout.
+         *        The scroll position sticks to a line, so it changes when lines above are wrapped differently.
+         */
+        index_type scroll_top() const;
+
+        /**
+         * @brief scroll_extent The amount of rows to scroll through.
+         */
+        index_type scroll_extent() const;
+
+        /**
+         * @brief row_layout Takes the rows of lines from a layout, which wraps lines and hides folded ones.
+         *        nullptr for a row per line. The layout is not owned and has to observe the store.
          */
-        void render(graph_reference graph);
+        void row_layout(wrap_layout* layout);
 
         /**
-         * @brief update_scroll Set the first line that is scrolled to.
-         * @param scroll_top_line the top line in the scrolled area.
+         * @brief word_wrap Wraps lines at the width of the text area, if there is a row layout.
          */
-        void update_scroll(index_type scroll_top_line);
+        void word_wrap(bool enabled);
+
+        /**
+         * @brief hidden Is a line hidden in a collapsed fold?
+         */
+        bool hidden(index_type line) const;
+
+        /**
+         * @brief next_line The first line behind line that is not hidden, or the line count. O(log n) with a row layout.
+         */
+        index_type next_line(index_type line) const;
 
         /**
          * @brief font Sets the base font.
@@ -68,11 +128,152 @@ namespace nana_source_view::skeletons
          */
         nana::paint::font font() const;
 
+        /**
+         * @brief foreground Sets the color for unstyled text.
+         */
+        void foreground(nana::color const& color);
+
+        /**
+         * @brief selection_color Sets the color selections are filled with.
+         */
+        void selection_color(nana::color const& color);
+
+        /**
+         * @brief highlight Frames the visible ranges of a set, like search results, over the selections.
+         *        Only the ranges that overlap the visible lines are looked at. The set is not owned.
+         *        Passing a set again changes its color.
+         */
+        void highlight(anchor_set const* ranges, nana::color const& color);
+
+        /**
+         * @brief line_height The height of a line in pixels. Measured on the first render after a font change.
+         */
+        unsigned line_height() const;
+
+        /**
+         * @brief visible_lines Retrieves the range of lines that fit into the text area.
+         * @return The first visible line and the past the end line.
+         */
+        std::pair <index_type, index_type> visible_lines() const;
+
+        /**
+         * @brief glyph_width The width of a glyph of a monospace font, or of an 'M' otherwise.
+         */
+        unsigned glyph_width() const;
+
+        /**
+         * @brief offset_x Retrieves the horizontal pixel position of an offset on a line.
+         *        Glyphs are measured one by one with cached advances. Glyphs right of the text area are not measured,
+         *        so a position there is only known to be right of it.
+         * @param offset An offset within the line, not behind its line ending.
+         * @param cursor Optional. Continues from the cursor if it is on the same row and not behind offset.
+         *        Updated to offset.
+         * @param before_wrap If offset is where a wrapped row begins, it is placed at the end of the row before.
+         */
+        int offset_x
+        (
+            paint_sink& sink,
+            index_type line,
+            index_type offset,
+            x_cursor* cursor = nullptr,
+            bool before_wrap = false
+        ) const;
+
+        /**
+         * @brief position Retrieves the top left pixel position of an offset on a visible line.
+         */
+        nana::point position(paint_sink& sink, index_type line, index_type offset, x_cursor* cursor = nullptr) const;
+
+        /**
+         * @brief hit_test The offset nearest to a pixel position, for placing carets with the mouse.
+         *        Above or below the text is its beginning or end, left or right of a row the row's beginning or end.
+         *        The row is found in O(log n), the column by the advances of the glyphs left of the position only.
+         */
+        index_type hit_test(paint_sink& sink, nana::point const& point) const;
+
+        /**
+         * @brief line_top Retrieves the vertical pixel position of the first row of a line.
+         *        Above the text area for the first visible line, if it is scrolled into.
+         */
+        int line_top(index_type line) const;
+
+        /**
+         * @brief wrap_points Where the rows of a line but the first begin, as offsets within the line.
+         *        Empty, if lines are not wrapped.
+         */
+        std::vector <index_type> const& wrap_points(index_type line) const;
+
+    private:
+        /**
+         * @brief update_metrics Measures line height and glyph width with the current font.
+         */
+        void update_metrics(paint_sink& sink);
+
+        /**
+         * @brief advance The width of a single code point. Measured once per font and code point.
+         */
+        unsigned advance(paint_sink& sink, std::string_view glyph) const;
+
+        /**
+         * @brief visible_row_end Where the glyphs of a row that start left of the right border of the text area end.
+         *        The row is drawn from the left of the text area, glyphs right of the border are not measured.
+         * @param begin Where the row begins in text.
+         * @param end Where the row ends in text.
+         */
+        std::size_t visible_row_end(paint_sink& sink, std::string_view text, std::size_t begin, std::size_t end) const;
+
+        /**
+         * @brief laid_out Do rows come from a layout?
+         */
+        bool laid_out() const;
+
+        /**
+         * @brief update_wrap Fits the row layout to the text area and wraps the visible lines.
+         */
+        void update_wrap();
+
+        /**
+         * @brief scroll_anchor The first visible line and how many of its rows are scrolled past, within bounds.
+         *        A hidden line is anchored at the fold header above it.
+         */
+        std::pair <index_type, index_type> scroll_anchor() const;
+
+        /**
+         * @brief render_runs Draws a line as runs of equally styled text.
+         * @param text The line without its line ending.
+         * @param row_begin, row_end The part of text that is drawn at y, the whole text unless it is wrapped.
+         */
+        void render_runs
+        (
+            paint_sink& sink,
+            index_type line,
+            int y,
+            std::string_view text,
+            styler::range_type const& styles,
+            std::size_t row_begin,
+            std::size_t row_end
+        );
+
     private:
         data_store const* store_;
         nana::rectangle area_;
         std::unique_ptr <styler> styler_;
         nana::paint::font font_;
+        nana::color fgcolor_;
+        selection_renderer selection_;
+        std::vector <std::pair <anchor_set const*, nana::color>> highlights_;
+        wrap_layout* wrap_;
+        bool word_wrap_;
+
+        /// The first visible line and how many of its rows are scrolled past.
         index_type scroll_top_;
+        index_type scroll_row_;
+        unsigned line_height_;
+        unsigned glyph_width_;
+        bool monospace_;
+        bool metrics_dirty_;
+
+        /// The advances of the code points measured so far, by their utf8 bytes.
+        mutable std::unordered_map <std::uint32_t, unsigned> advances_;
     };
 }
@@ -1,17 +0,0 @@
-#include <nana-source-view/c_styler.hpp>
-
-namespace nana_source_view
-{
-    void c_styler::initialize()
-    {
-
-    }
-    void c_styler::on_multi_line_change(index_type begin, index_type end)
-    {
-
-    }
-    range_type c_styler::styles_on_lines(index_type begin, index_type end)
-    {
-
-    }
-}
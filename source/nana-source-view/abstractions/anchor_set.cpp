@@ -0,0 +1,252 @@
+#include <nana-source-view/abstractions/anchor_set.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace nana_source_view
+{
+    namespace
+    {
+        /// The furthest end of nothing, far in front of any real offset.
+        constexpr anchored_range::index_type unreachable = anchored_range::index_type{1} << 48;
+
+        void validate(anchored_range const& range)
+        {
+            if (range.begin < 0 || range.end < range.begin)
+                throw std::invalid_argument("anchor_set: range ends before it begins");
+        }
+    }
+//#####################################################################################################################
+    anchor_set::extent anchor_set::extent_traits::identity()
+    {
+        return {0, -unreachable};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    anchor_set::extent anchor_set::extent_traits::summarize(anchor const& a)
+    {
+        return {a.gap, a.gap + a.length};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    anchor_set::extent anchor_set::extent_traits::combine(extent const& lhs, extent const& rhs)
+    {
+        return {lhs.sum + rhs.sum, std::max(lhs.furthest_end, lhs.sum + rhs.furthest_end)};
+    }
+//#####################################################################################################################
+    anchor_set::anchor_set()
+        : anchors_{}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void anchor_set::on_edit(std::vector <edit_delta> const& deltas)
+    {
+        // deltas refer to the old text, from back to front every delta still finds its offsets.
+        for (auto iter = std::rbegin(deltas); iter != std::rend(deltas); ++iter)
+            apply(*iter);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t anchor_set::first_at(index_type offset) const
+    {
+        // gaps are not negative, so the last begin of a subtree is its highest.
+        auto const found = anchors_.find_first(0, [offset](extent const& before, extent const& subtree)
+        {
+            return before.sum + subtree.sum >= offset;
+        });
+        return found == anchors_.npos ? anchors_.size() : found;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    template <typename FunctionT>
+    void anchor_set::visit_ending_behind(std::size_t from, index_type offset, FunctionT&& found) const
+    {
+        for (;;)
+        {
+            extent before;
+            auto const index = anchors_.find_first(from, [offset](extent const& preceding, extent const& subtree)
+            {
+                return preceding.sum + subtree.furthest_end >= offset;
+            }, &before);
+            if (index == anchors_.npos)
+                return;
+
+            auto const& a = anchors_[index];
+            auto const begin = before.sum + a.gap;
+            if (!found(index, begin, begin + a.length))
+                return;
+            from = index + 1;
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void anchor_set::apply(edit_delta const& delta)
+    {
+        auto const removed_end = delta.offset + delta.removed;
+        auto const shift = delta.inserted - delta.removed;
+        auto const first = first_at(delta.offset);
+        auto const last = delta.removed == 0 ? first : first_at(removed_end);
+
+        // ranges in front of the edit that reach into it keep their begin, their end moves or is cut off.
+        std::vector <std::pair <std::size_t, anchor>> cut;
+        visit_ending_behind(0, delta.offset + 1, [&](std::size_t index, index_type, index_type end)
+        {
+            if (index >= first)
+                return false;
+
+            auto a = anchors_[index];
+            a.length += (end >= removed_end ? end + shift : delta.offset) - end;
+            cut.push_back({index, a});
+            return true;
+        });
+        for (auto const& [index, a] : cut)
+            anchors_.assign(index, a);
+
+        if (first == last && (shift == 0 || last == anchors_.size()))
+            return;
+
+        // ranges that begin within the removed bytes begin behind the inserted ones, if anything of them is left.
+        auto const base = anchors_.summary(0, first).sum;
+        std::vector <anchored_range> moved;
+        auto begin = base;
+        for (auto index = first; index != last; ++index)
+        {
+            auto const& a = anchors_[index];
+            begin += a.gap;
+            auto const end = begin + a.length;
+
+            anchored_range range{delta.offset + delta.inserted, end >= removed_end ? end + shift : delta.offset, a.tag};
+            if (range.end < range.begin)
+                range.begin = range.end = delta.offset;
+            moved.push_back(range);
+        }
+        std::stable_sort(std::begin(moved), std::end(moved), [](auto const& lhs, auto const& rhs)
+        {
+            return lhs.begin < rhs.begin;
+        });
+
+        std::vector <anchor> replaced;
+        replaced.reserve(moved.size() + 1);
+        auto previous = base;
+        for (auto const& range : moved)
+        {
+            replaced.push_back({range.begin - previous, range.end - range.begin, range.tag});
+            previous = range.begin;
+        }
+
+        // the first range behind the edit carries the shift of all behind it.
+        auto end = last;
+        if (last != anchors_.size())
+        {
+            auto next = anchors_[last];
+            next.gap = begin + next.gap + shift - previous;
+            replaced.push_back(next);
+            ++end;
+        }
+        anchors_.splice(first, end, std::begin(replaced), std::end(replaced));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void anchor_set::assign(std::vector <anchored_range> ranges)
+    {
+        for (auto const& range : ranges)
+            validate(range);
+
+        std::stable_sort(std::begin(ranges), std::end(ranges), [](auto const& lhs, auto const& rhs)
+        {
+            return lhs.begin < rhs.begin;
+        });
+
+        std::vector <anchor> anchors;
+        anchors.reserve(ranges.size());
+        index_type previous = 0;
+        for (auto const& range : ranges)
+        {
+            anchors.push_back({range.begin - previous, range.end - range.begin, range.tag});
+            previous = range.begin;
+        }
+
+        anchors_.clear();
+        anchors_.splice(0, 0, std::begin(anchors), std::end(anchors));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void anchor_set::insert(anchored_range const& range)
+    {
+        validate(range);
+
+        // behind all ranges with the same begin.
+        auto index = anchors_.find_first(0, [begin = range.begin](extent const& before, extent const& subtree)
+        {
+            return before.sum + subtree.sum > begin;
+        });
+        if (index == anchors_.npos)
+            index = anchors_.size();
+
+        auto const base = anchors_.summary(0, index).sum;
+        std::vector <anchor> replaced{anchor{range.begin - base, range.end - range.begin, range.tag}};
+        auto end = index;
+        if (index != anchors_.size())
+        {
+            auto next = anchors_[index];
+            next.gap -= range.begin - base;
+            replaced.push_back(next);
+            ++end;
+        }
+        anchors_.splice(index, end, std::begin(replaced), std::end(replaced));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t anchor_set::remove(index_type begin, index_type end, std::uint32_t tag)
+    {
+        std::vector <std::size_t> found;
+        visit_ending_behind(0, begin, [&](std::size_t index, index_type range_begin, index_type range_end)
+        {
+            if (range_begin >= end && !(range_begin == begin && range_end == begin))
+                return false;
+            if ((range_end > begin || range_begin == range_end) && anchors_[index].tag == tag)
+                found.push_back(index);
+            return true;
+        });
+
+        // back to front, so indices stay valid. The gap of a removed range goes to the one behind it.
+        for (auto iter = std::rbegin(found); iter != std::rend(found); ++iter)
+        {
+            auto const index = *iter;
+            if (index + 1 == anchors_.size())
+            {
+                std::vector <anchor> none;
+                anchors_.splice(index, index + 1, std::begin(none), std::end(none));
+                continue;
+            }
+
+            auto next = anchors_[index + 1];
+            next.gap += anchors_[index].gap;
+            anchors_.splice(index, index + 2, &next, &next + 1);
+        }
+        return found.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <anchored_range> anchor_set::overlapping(index_type begin, index_type end) const
+    {
+        std::vector <anchored_range> result;
+        visit_ending_behind(0, begin, [&](std::size_t index, index_type range_begin, index_type range_end)
+        {
+            if (range_begin >= end && !(range_begin == begin && range_end == begin))
+                return false;
+            if (range_end > begin || range_begin == range_end)
+                result.push_back({range_begin, range_end, anchors_[index].tag});
+            return true;
+        });
+        return result;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t anchor_set::size() const
+    {
+        return anchors_.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool anchor_set::empty() const
+    {
+        return anchors_.empty();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void anchor_set::clear()
+    {
+        anchors_.clear();
+    }
+//#####################################################################################################################
+}
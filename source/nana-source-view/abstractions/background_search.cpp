@@ -0,0 +1,287 @@
+#include <nana-source-view/abstractions/background_search.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace nana_source_view
+{
+    namespace
+    {
+        /// Matches are handed over after every slice of this many bytes.
+        constexpr std::size_t slice_size = 256 * 1024;
+
+        constexpr lexing::automaton::token_type found_token = 1;
+
+        /**
+         *  A run of the search automaton that began at begin.
+         */
+        struct attempt
+        {
+            std::size_t begin;
+            lexing::automaton::state_type state;
+        };
+    }
+//#####################################################################################################################
+    background_search::background_search(data_store const* store)
+        : store_{store}
+        , snapshot_{}
+        , job_{}
+        , worker_{}
+        , results_{}
+        , notify_{}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    background_search::~background_search()
+    {
+        cancel();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void background_search::start(std::string_view pattern)
+    {
+        // compiled first, a malformed pattern leaves the running search alone.
+        lexing::automaton_builder builder;
+        builder.add(builder.group(), pattern, found_token);
+        auto compiled = builder.build();
+
+        cancel();
+        results_.clear();
+
+        if (!snapshot_)
+        {
+            auto const text = store_->view();
+            snapshot_ = std::make_shared <std::string> (std::begin(text), std::end(text));
+        }
+
+        job_ = std::make_shared <job> ();
+        worker_ = std::thread{[state = job_, snapshot = std::shared_ptr <std::string const> {snapshot_}, compiled = std::move(compiled), notify = notify_]()
+        {
+            run(state, snapshot, compiled, notify);
+        }};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void background_search::run
+    (
+        std::shared_ptr <job> state,
+        std::shared_ptr <std::string const> snapshot,
+        lexing::automaton const& pattern,
+        std::function <void()> const& notify
+    )
+    {
+        using state_type = lexing::automaton::state_type;
+
+        std::string_view const text{*snapshot};
+        auto const start = pattern.start(0);
+
+        // the runs of the automaton at pos, sorted by where they began, one per state.
+        std::vector <attempt> attempts;
+        std::vector <attempt> stepped;
+        std::vector <std::size_t> seen(pattern.state_count(), 0);
+        std::size_t step = 1;
+
+        // the leftmost longest match so far. Handed over once no run that began in front of it is left.
+        bool pending = false;
+        std::size_t match_begin = 0;
+        std::size_t match_end = 0;
+
+        // the states the run of the pending match went through behind its end.
+        std::vector <state_type> trail;
+
+        // failed[p - failed_base] does not lead to a match from p, dead where nothing is known.
+        std::vector <state_type> failed;
+        std::size_t failed_base = 0;
+        auto const fails = [&](std::size_t at, state_type next)
+        {
+            return at >= failed_base && at - failed_base < failed.size() && failed[at - failed_base] == next;
+        };
+
+        std::vector <anchored_range> batch;
+        auto const hand_over = [&](bool finished)
+        {
+            std::lock_guard <std::mutex> guard{state->mutex};
+            state->found.insert(std::end(state->found), std::begin(batch), std::end(batch));
+            state->finished = finished;
+
+            // under the lock, so notify is not called anymore once cancel returns.
+            if (notify && !state->cancelled)
+                notify();
+        };
+
+        std::size_t pos = 0;
+        auto checkpoint = slice_size;
+        while (!state->cancelled.load(std::memory_order_relaxed))
+        {
+            if (attempts.empty())
+            {
+                pos = pattern.skip_dead(text.substr(0, std::min(checkpoint, text.size())), pos, start);
+                if (pos == text.size())
+                    break;
+            }
+            if (!pending && seen[start] != step)
+            {
+                seen[start] = step;
+                attempts.push_back({pos, start});
+            }
+
+            // the runs end with the text.
+            ++step;
+            stepped.clear();
+            if (pos != text.size())
+            {
+                for (auto const& run : attempts)
+                {
+                    auto const next = pattern.next(run.state, text[pos]);
+                    if (next == lexing::automaton::dead || seen[next] == step || fails(pos + 1, next))
+                        continue;
+                    seen[next] = step;
+                    stepped.push_back({run.begin, next});
+                }
+                ++pos;
+            }
+            attempts.swap(stepped);
+
+            // the leftmost run that accepts wins, a longer match of the same start replaces the shorter one.
+            for (auto const& run : attempts)
+            {
+                if (pattern.accepts(run.state) == lexing::automaton::no_token)
+                    continue;
+                if (!pending || run.begin <= match_begin)
+                {
+                    pending = true;
+                    match_begin = run.begin;
+                    match_end = pos;
+                    trail.clear();
+                }
+                break;
+            }
+
+            if (pending)
+            {
+                attempts.erase(std::remove_if(std::begin(attempts), std::end(attempts), [match_begin](auto const& run)
+                {
+                    return run.begin > match_begin;
+                }), std::end(attempts));
+                if (match_end != pos && !attempts.empty() && attempts.back().begin == match_begin)
+                    trail.push_back(attempts.back().state);
+            }
+
+            if (pending && attempts.empty())
+            {
+                batch.push_back({static_cast <anchored_range::index_type> (match_begin), static_cast <anchored_range::index_type> (match_end), 0});
+
+                // the bytes behind the match are searched again, but not in the states its run failed in.
+                auto const from = match_end + 1;
+                if (failed_base + failed.size() <= from || from - failed_base > failed.size() / 2)
+                {
+                    failed.erase(std::begin(failed), std::begin(failed) + static_cast <std::ptrdiff_t> (std::min(from - failed_base, failed.size())));
+                    failed_base = from;
+                }
+                if (failed.size() < from - failed_base + trail.size())
+                    failed.resize(from - failed_base + trail.size(), lexing::automaton::dead);
+                std::copy(std::begin(trail), std::end(trail), std::begin(failed) + static_cast <std::ptrdiff_t> (from - failed_base));
+
+                pending = false;
+                pos = match_end;
+                ++step;
+            }
+
+            if (pos >= checkpoint)
+            {
+                checkpoint = pos - pos % slice_size + slice_size;
+                if (!batch.empty())
+                {
+                    hand_over(false);
+                    batch.clear();
+                }
+            }
+        }
+        hand_over(true);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void background_search::cancel()
+    {
+        if (!job_)
+            return;
+
+        // the worker owns its state and finishes on its own.
+        {
+            std::lock_guard <std::mutex> guard{job_->mutex};
+            job_->cancelled = true;
+        }
+        if (worker_.joinable())
+            worker_.detach();
+        job_.reset();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t background_search::poll()
+    {
+        if (!job_)
+            return 0;
+
+        std::vector <anchored_range> found;
+        bool finished;
+        {
+            std::lock_guard <std::mutex> guard{job_->mutex};
+            found.swap(job_->found);
+            finished = job_->finished;
+        }
+
+        // found in order, behind everything polled before.
+        for (auto const& range : found)
+            results_.insert(range);
+
+        if (finished)
+        {
+            worker_.join();
+            job_.reset();
+        }
+        return found.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool background_search::running() const
+    {
+        return static_cast <bool> (job_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    anchor_set const& background_search::results() const
+    {
+        return results_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void background_search::on_progress(std::function <void()> notify)
+    {
+        notify_ = std::move(notify);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void background_search::on_edit(std::vector <edit_delta> const& deltas)
+    {
+        // what was found so far is still valid for the text before the edit.
+        poll();
+        cancel();
+        results_.on_edit(deltas);
+
+        // a cancelled worker may still read the snapshot, then it is copied again by the next search.
+        if (!snapshot_ || snapshot_.use_count() != 1)
+        {
+            snapshot_.reset();
+            return;
+        }
+
+        // replaced like in the store, many deltas in one pass.
+        auto const text = store_->view();
+        if (deltas.size() > 16)
+        {
+            snapshot_->assign(std::begin(text), std::end(text));
+            return;
+        }
+        edit_delta::index_type shift = 0;
+        for (auto const& delta : deltas)
+        {
+            auto const offset = static_cast <std::size_t> (delta.offset + shift);
+            snapshot_->replace(offset, static_cast <std::size_t> (delta.removed), text.substr(offset, static_cast <std::size_t> (delta.inserted)));
+            shift += delta.inserted - delta.removed;
+        }
+    }
+//#####################################################################################################################
+}
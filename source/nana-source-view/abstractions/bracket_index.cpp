@@ -0,0 +1,193 @@
+#include <nana-source-view/abstractions/bracket_index.hpp>
+
+#include <algorithm>
+
+namespace nana_source_view
+{
+    namespace
+    {
+        /// Stands for "no prefix" and "no suffix" of empty lines, far away from any real depth.
+        constexpr std::int64_t unreachable = std::int64_t{1} << 48;
+
+        std::int64_t depth_of(char symbol)
+        {
+            return bracket_index::is_opening(symbol) ? 1 : -1;
+        }
+    }
+//#####################################################################################################################
+    bracket_index::depth_summary bracket_index::depth_traits::identity()
+    {
+        return {0, unreachable, -unreachable};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bracket_index::depth_summary bracket_index::depth_traits::summarize(depth_summary const& line)
+    {
+        return line;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bracket_index::depth_summary bracket_index::depth_traits::combine(depth_summary const& lhs, depth_summary const& rhs)
+    {
+        return {
+            lhs.sum + rhs.sum,
+            std::min(lhs.lowest_prefix, lhs.sum + rhs.lowest_prefix),
+            std::max(rhs.highest_suffix, rhs.sum + lhs.highest_suffix)
+        };
+    }
+//#####################################################################################################################
+    bracket_index::bracket_index(std::size_t line_count)
+        : brackets_{}
+        , depths_{}
+    {
+        reset(line_count);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void bracket_index::reset(std::size_t line_count)
+    {
+        brackets_.reset(line_count);
+
+        depths_.clear();
+        std::vector <depth_summary> empty(line_count, depth_traits::identity());
+        depths_.splice(0, 0, std::begin(empty), std::end(empty));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void bracket_index::splice(std::size_t begin, std::size_t end, std::vector <std::size_t> const& sizes, std::vector <bracket> const& brackets)
+    {
+        brackets_.splice(begin, end, sizes, std::begin(brackets), std::end(brackets));
+
+        // summarized from the new brackets, not looked up line by line again.
+        std::vector <depth_summary> lines;
+        lines.reserve(sizes.size());
+        auto first = std::cbegin(brackets);
+        for (auto const size : sizes)
+        {
+            auto const last = first + static_cast <std::ptrdiff_t> (size);
+            lines.push_back(summarize_line(first, last));
+            first = last;
+        }
+        depths_.splice(begin, end, std::begin(lines), std::end(lines));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t bracket_index::line_count() const
+    {
+        return brackets_.line_count();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bracket_index::lines_view bracket_index::brackets_on_line(std::size_t line) const
+    {
+        return brackets_.line(line);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bracket_index::depth_summary bracket_index::summarize_line
+    (
+        std::vector <bracket>::const_iterator first,
+        std::vector <bracket>::const_iterator last
+    )
+    {
+        auto result = depth_traits::identity();
+        for (; first != last; ++first)
+        {
+            auto const depth = depth_of(first->symbol);
+            result = depth_traits::combine(result, {depth, depth, depth});
+        }
+        return result;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::optional <bracket_location> bracket_index::match(std::size_t line, std::uint32_t column) const
+    {
+        if (line >= line_count())
+            return std::nullopt;
+
+        auto const on_line = brackets_.line(line);
+        auto const self = std::lower_bound(std::begin(on_line), std::end(on_line), column, [](bracket const& b, std::uint32_t c)
+        {
+            return b.column < c;
+        });
+        if (self == std::end(on_line) || self->column != column)
+            return std::nullopt;
+
+        // depth counts relative to the bracket, the match is where it returns to 0.
+        if (is_opening(self->symbol))
+        {
+            std::int64_t depth = 0;
+            for (auto iter = self; iter != std::end(on_line); ++iter)
+            {
+                depth += depth_of(iter->symbol);
+                if (depth == 0)
+                    return bracket_location{line, iter->column, iter->symbol};
+            }
+
+            // the first line behind, where the depth falls below the remaining one.
+            auto const remaining = depth;
+            auto const start = depths_.summary(0, line + 1).sum;
+            depth_summary before;
+            auto const found = depths_.find_first(line + 1, [&](depth_summary const& preceding, depth_summary const& lines)
+            {
+                return preceding.sum - start + remaining + lines.lowest_prefix <= 0;
+            }, &before);
+            if (found == depths_.npos)
+                return std::nullopt;
+
+            depth = before.sum - start + remaining;
+            for (auto const& b : brackets_.line(found))
+            {
+                depth += depth_of(b.symbol);
+                if (depth == 0)
+                    return bracket_location{found, b.column, b.symbol};
+            }
+            return std::nullopt;
+        }
+
+        std::int64_t depth = 0;
+        for (auto iter = std::make_reverse_iterator(self + 1); iter != std::make_reverse_iterator(std::begin(on_line)); ++iter)
+        {
+            depth += depth_of(iter->symbol);
+            if (depth == 0)
+                return bracket_location{line, iter->column, iter->symbol};
+        }
+
+        // the last line before, where the depth rises above the remaining one.
+        auto const remaining = depth;
+        depth_summary after;
+        auto const found = depths_.find_last(line, [&](depth_summary const& lines, depth_summary const& following)
+        {
+            return lines.highest_suffix + following.sum + remaining >= 0;
+        }, &after);
+        if (found == depths_.npos)
+            return std::nullopt;
+
+        depth = after.sum + remaining;
+        auto const candidates = brackets_.line(found);
+        for (auto iter = std::make_reverse_iterator(std::end(candidates)); iter != std::make_reverse_iterator(std::begin(candidates)); ++iter)
+        {
+            depth += depth_of(iter->symbol);
+            if (depth == 0)
+                return bracket_location{found, iter->column, iter->symbol};
+        }
+        return std::nullopt;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool bracket_index::is_bracket(char c)
+    {
+        return c == '(' || c == ')' || c == '[' || c == ']' || c == '{' || c == '}';
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool bracket_index::is_opening(char c)
+    {
+        return c == '(' || c == '[' || c == '{';
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    char bracket_index::counterpart(char c)
+    {
+        switch (c)
+        {
+            case '(': return ')';
+            case ')': return '(';
+            case '[': return ']';
+            case ']': return '[';
+            case '{': return '}';
+            case '}': return '{';
+            default: return c;
+        }
+    }
+//#####################################################################################################################
+}
@@ -0,0 +1,367 @@
+#include <nana-source-view/abstractions/fold_tree.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace nana_source_view
+{
+    namespace
+    {
+        /**
+         *  By header, the larger of two regions with the same header first.
+         */
+        bool header_order(fold_region const& lhs, fold_region const& rhs)
+        {
+            return lhs.header < rhs.header || (lhs.header == rhs.header && lhs.last > rhs.last);
+        }
+
+        /**
+         *  Sorts regions by header and keeps the largest per header.
+         */
+        void normalize(std::vector <fold_region>& regions)
+        {
+            std::sort(std::begin(regions), std::end(regions), header_order);
+            regions.erase(std::unique(std::begin(regions), std::end(regions), [](auto const& lhs, auto const& rhs)
+            {
+                return lhs.header == rhs.header;
+            }), std::end(regions));
+        }
+    }
+//#####################################################################################################################
+    fold_tree::fold_tree(data_store const* store, wrap_layout* layout)
+        : store_{store}
+        , layout_{layout}
+        , regions_{}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void fold_tree::assign(std::vector <fold_region> regions)
+    {
+        auto const line_count = static_cast <index_type> (store_->line_count());
+        normalize(regions);
+
+        // the regions that contain the current one.
+        std::vector <index_type> enclosing;
+        for (auto& region : regions)
+        {
+            if (region.header < 0 || region.last <= region.header || region.last >= line_count)
+                throw std::invalid_argument("fold_tree: not a region of the store");
+
+            while (!enclosing.empty() && enclosing.back() < region.header)
+                enclosing.pop_back();
+            if (!enclosing.empty() && enclosing.back() < region.last)
+                throw std::invalid_argument("fold_tree: regions overlap without nesting");
+            enclosing.push_back(region.last);
+
+            auto const previous = find(region.header);
+            region.collapsed = previous != std::end(regions_) && previous->last == region.last && previous->collapsed;
+        }
+
+        auto const collapsed = [](std::vector <fold_region> const& regions)
+        {
+            return std::any_of(std::begin(regions), std::end(regions), [](auto const& region)
+            {
+                return region.collapsed;
+            });
+        };
+
+        // without collapsed regions before or after, no line changes its visibility.
+        auto const changes = collapsed(regions_) || collapsed(regions);
+        regions_ = std::move(regions);
+        if (changes)
+            apply(0, line_count);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <fold_region> const& fold_tree::regions() const
+    {
+        return regions_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::optional <fold_region> fold_tree::region_at(index_type header) const
+    {
+        auto const region = const_cast <fold_tree*> (this)->find(header);
+        if (region == std::end(regions_))
+            return std::nullopt;
+        return *region;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool fold_tree::collapse(index_type header)
+    {
+        auto const region = find(header);
+        if (region == std::end(regions_) || region->collapsed)
+            return false;
+
+        region->collapsed = true;
+        layout_->hide(region->header + 1, region->last + 1, true);
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool fold_tree::expand(index_type header)
+    {
+        auto const region = find(header);
+        if (region == std::end(regions_) || !region->collapsed)
+            return false;
+
+        // a hidden header is within another collapsed region, which keeps the lines hidden.
+        region->collapsed = false;
+        if (!layout_->hidden(region->header))
+            apply(region->header + 1, region->last + 1);
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool fold_tree::toggle(index_type header)
+    {
+        auto const region = find(header);
+        if (region == std::end(regions_))
+            return false;
+
+        if (region->collapsed)
+            return expand(header);
+        return collapse(header);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void fold_tree::collapse_top_level()
+    {
+        index_type top_level_end = -1;
+        for (auto& region : regions_)
+        {
+            if (region.header <= top_level_end)
+                continue;
+
+            top_level_end = region.last;
+            region.collapsed = true;
+        }
+
+        // one pass over all lines instead of a splice per region.
+        apply(0, static_cast <index_type> (store_->line_count()));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void fold_tree::expand_all()
+    {
+        bool any = false;
+        for (auto& region : regions_)
+        {
+            any = any || region.collapsed;
+            region.collapsed = false;
+        }
+        if (any)
+            layout_->hide(0, static_cast <index_type> (store_->line_count()), false);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void fold_tree::on_edit(std::vector <edit_delta> const& deltas)
+    {
+        if (regions_.empty())
+            return;
+
+        auto const groups = group_deltas(deltas);
+        if (groups.empty())
+            return;
+
+        // how far lines behind a group move.
+        auto const shift_behind = [](touched_lines const& group)
+        {
+            return static_cast <index_type> (group.new_end) - static_cast <index_type> (group.old_end);
+        };
+        auto const shift_in_front = [&](auto group)
+        {
+            return group == std::begin(groups) ? index_type{0} : shift_behind(*std::prev(group));
+        };
+
+        // the lines that have to be shown again, in new line numbers.
+        auto reveal_first = std::numeric_limits <index_type>::max();
+        index_type reveal_last = -1;
+
+        // regions are updated in place, the kept ones are moved to the front.
+        auto const front = static_cast <index_type> (groups.front().old_begin);
+        auto const back = static_cast <index_type> (groups.back().old_end);
+        auto const total_shift = shift_behind(groups.back());
+        auto kept = std::begin(regions_);
+        for (auto region : regions_)
+        {
+            // most regions are entirely in front of or behind all edits.
+            if (region.last < front || region.header > back)
+            {
+                if (region.header > back)
+                {
+                    region.header += total_shift;
+                    region.last += total_shift;
+                }
+                *kept++ = region;
+                continue;
+            }
+
+            auto const header = static_cast <std::size_t> (region.header);
+            auto const last = static_cast <std::size_t> (region.last);
+
+            // the first group that touches the region, if any.
+            auto const first_group = std::lower_bound(std::begin(groups), std::end(groups), header, [](auto const& group, std::size_t line)
+            {
+                return group.old_end < line;
+            });
+            if (first_group == std::end(groups) || first_group->old_begin > last)
+            {
+                region.header += shift_in_front(first_group);
+                region.last += shift_in_front(first_group);
+                *kept++ = region;
+                continue;
+            }
+
+            // the last group that touches the region.
+            auto const last_group = std::prev(std::upper_bound(std::begin(groups), std::end(groups), last, [](std::size_t line, auto const& group)
+            {
+                return line < group.old_begin;
+            }));
+
+            auto const new_last = last <= last_group->old_end
+                ? static_cast <index_type> (last_group->new_end)
+                : region.last + shift_behind(*last_group);
+
+            // the header is merged into the line in front of it.
+            auto const merged = first_group->old_begin < header;
+            auto const new_header = first_group->old_begin == header
+                ? static_cast <index_type> (first_group->new_begin)
+                : region.header + shift_in_front(first_group);
+
+            auto const header_only =
+                first_group == last_group &&
+                first_group->old_begin == header &&
+                first_group->old_end == header &&
+                first_group->new_begin == first_group->new_end
+            ;
+
+            if (!merged && new_last > new_header)
+            {
+                if (region.collapsed && !header_only)
+                {
+                    region.collapsed = false;
+                    reveal_first = std::min(reveal_first, new_header + 1);
+                    reveal_last = std::max(reveal_last, new_last);
+                }
+                region.header = new_header;
+                region.last = new_last;
+                *kept++ = region;
+            }
+            else if (region.collapsed)
+            {
+                reveal_first = std::min(reveal_first, static_cast <index_type> (first_group->new_begin));
+                reveal_last = std::max(reveal_last, new_last);
+            }
+        }
+
+        // lines moving together can put two headers on the same line.
+        regions_.erase(std::unique(std::begin(regions_), kept, [](auto const& lhs, auto const& rhs)
+        {
+            return lhs.header == rhs.header;
+        }), std::end(regions_));
+
+        if (reveal_first <= reveal_last)
+            apply(reveal_first, reveal_last + 1);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <fold_region> fold_tree::from_brackets(bracket_index const& brackets)
+    {
+        std::vector <fold_region> regions;
+        std::vector <index_type> open;
+        for (std::size_t line = 0; line != brackets.line_count(); ++line)
+        {
+            for (auto const& found : brackets.brackets_on_line(line))
+            {
+                if (bracket_index::is_opening(found.symbol))
+                {
+                    open.push_back(static_cast <index_type> (line));
+                    continue;
+                }
+                if (open.empty())
+                    continue;
+
+                auto const header = open.back();
+                open.pop_back();
+                if (static_cast <index_type> (line) > header + 1)
+                    regions.push_back({header, static_cast <index_type> (line) - 1, false});
+            }
+        }
+
+        normalize(regions);
+        return regions;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <fold_region> fold_tree::from_indentation(data_store const& store, index_type tab_width)
+    {
+        tab_width = std::max(tab_width, index_type{1});
+
+        // headers and their indentation, each deeper than the one in front of it.
+        std::vector <std::pair <index_type, index_type>> open;
+        std::vector <fold_region> regions;
+        index_type last_filled = -1;
+
+        auto const close = [&](index_type indentation)
+        {
+            while (!open.empty() && open.back().second >= indentation)
+            {
+                if (last_filled > open.back().first)
+                    regions.push_back({open.back().first, last_filled, false});
+                open.pop_back();
+            }
+        };
+
+        auto const line_count = static_cast <index_type> (store.line_count());
+        for (index_type line = 0; line != line_count; ++line)
+        {
+            auto [begin, end] = store.line(line);
+            index_type indentation = 0;
+            for (; begin != end && (*begin == ' ' || *begin == '\t'); ++begin)
+                indentation = *begin == '\t' ? (indentation / tab_width + 1) * tab_width : indentation + 1;
+
+            // blank lines
+            if (begin == end || *begin == '\n' || *begin == '\r')
+                continue;
+
+            close(indentation);
+            open.emplace_back(line, indentation);
+            last_filled = line;
+        }
+        close(0);
+
+        normalize(regions);
+        return regions;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <fold_region>::iterator fold_tree::find(index_type header)
+    {
+        auto const region = std::lower_bound(std::begin(regions_), std::end(regions_), header, [](auto const& region, index_type line)
+        {
+            return region.header < line;
+        });
+        if (region == std::end(regions_) || region->header != header)
+            return std::end(regions_);
+        return region;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void fold_tree::apply(index_type first, index_type last)
+    {
+        // regions around the lines are not collapsed where this is used, so only those within are looked at.
+        auto const within = std::lower_bound(std::begin(regions_), std::end(regions_), first - 1, [](auto const& region, index_type line)
+        {
+            return region.header < line;
+        });
+
+        // regions within a collapsed one are hidden with it.
+        std::vector <std::pair <index_type, index_type>> hidden;
+        index_type hidden_until = -1;
+        for (auto region = within; region != std::end(regions_); ++region)
+        {
+            if (region->header >= last)
+                break;
+            if (!region->collapsed || region->header <= hidden_until || region->last < first)
+                continue;
+
+            hidden_until = region->last;
+            hidden.emplace_back(region->header + 1, region->last + 1);
+        }
+        layout_->hide(first, last, hidden);
+    }
+//#####################################################################################################################
+}
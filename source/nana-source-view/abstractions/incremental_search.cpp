@@ -0,0 +1,124 @@
+#include <nana-source-view/abstractions/incremental_search.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace nana_source_view
+{
+    namespace
+    {
+        /**
+         *  Does text end within a multi byte sequence? With case folding, the forms of a character may differ in
+         *  their first byte, so a query ending in a partial sequence does not narrow down.
+         */
+        bool ends_in_sequence(std::string_view text)
+        {
+            std::size_t continuations = 0;
+            for (auto iter = std::rbegin(text); iter != std::rend(text); ++iter)
+            {
+                auto const c = static_cast <unsigned char> (*iter);
+                if ((c & 0xC0) == 0x80)
+                {
+                    ++continuations;
+                    continue;
+                }
+                if (c < 0x80)
+                    return false;
+
+                auto const length = c >= 0xF0 ? 4u : c >= 0xE0 ? 3u : 2u;
+                return continuations + 1 < length;
+            }
+            return false;
+        }
+    }
+//#####################################################################################################################
+    incremental_search::incremental_search(data_store const* store)
+        : store_{store}
+        , query_{}
+        , mode_{find_case::exact}
+        , valid_{false}
+        , narrowed_{false}
+        , candidates_{}
+        , matches_{}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool incremental_search::extends(std::string_view query, find_case mode) const
+    {
+        return valid_
+            && mode == mode_
+            && query.size() > query_.size()
+            && query.substr(0, query_.size()) == query_
+            && !ends_in_sequence(query_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <std::size_t> const& incremental_search::update(std::string_view query, find_case mode)
+    {
+        if (valid_ && mode == mode_ && query == query_)
+            return matches_;
+
+        narrowed_ = false;
+        if (query.empty())
+        {
+            reset();
+            return matches_;
+        }
+
+        literal_finder const finder{query, mode};
+        auto const text = store_->view();
+        if (extends(query, mode))
+        {
+            candidates_.erase(std::remove_if(std::begin(candidates_), std::end(candidates_), [&](std::size_t pos)
+            {
+                return !finder.matches(text, pos);
+            }), std::end(candidates_));
+            narrowed_ = true;
+        }
+        else
+        {
+            candidates_.clear();
+            for (auto pos = finder.find_next(text, 0); pos != literal_finder::npos; pos = finder.find_next(text, pos + 1))
+                candidates_.push_back(pos);
+        }
+
+        query_ = query;
+        mode_ = mode;
+        valid_ = true;
+        select_matches(finder.size());
+        return matches_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void incremental_search::select_matches(std::size_t length)
+    {
+        matches_.clear();
+        for (auto const pos : candidates_)
+        {
+            if (matches_.empty() || pos >= matches_.back() + length)
+                matches_.push_back(pos);
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <std::size_t> const& incremental_search::matches() const
+    {
+        return matches_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool incremental_search::narrowed() const
+    {
+        return narrowed_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void incremental_search::reset()
+    {
+        query_.clear();
+        valid_ = false;
+        candidates_.clear();
+        matches_.clear();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void incremental_search::on_edit(std::vector <edit_delta> const&)
+    {
+        valid_ = false;
+    }
+//#####################################################################################################################
+}
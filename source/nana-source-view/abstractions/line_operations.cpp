@@ -0,0 +1,229 @@
+#include <nana-source-view/abstractions/line_operations.hpp>
+#include <nana-source-view/abstractions/detail/parallel_sort.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+namespace nana_source_view
+{
+    namespace
+    {
+        std::string_view line_break(line_end_type let)
+        {
+            switch (let)
+            {
+            case (line_end_type::LF):
+                return "\n";
+            case (line_end_type::CR):
+                return "\r";
+            case (line_end_type::CRLF):
+                return "\r\n";
+            }
+            return "\n";
+        }
+    }
+//#####################################################################################################################
+    line_operations::line_operations(data_store* store)
+        : store_{store}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void line_operations::validate(index_type first, index_type last) const
+    {
+        if (first < 0 || first > last || last >= static_cast <index_type> (store_->line_count()))
+            throw std::out_of_range("line_operations: not a range of lines");
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string_view line_operations::content(index_type line) const
+    {
+        auto const text = store_->view();
+        auto const begin = store_->index_from_line(line);
+        if (line + 1 == static_cast <index_type> (store_->line_count()))
+            return text.substr(static_cast <std::size_t> (begin));
+
+        auto const end = store_->index_from_line(line + 1) - static_cast <index_type> (line_break(store_->line_end()).size());
+        return text.substr(static_cast <std::size_t> (begin), static_cast <std::size_t> (end - begin));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::pair <line_operations::index_type, line_operations::index_type> line_operations::caret_lines() const
+    {
+        auto const& front = *store_->caret_begin();
+        auto const& back = *std::prev(store_->caret_end());
+
+        auto const first = store_->line_from_index(front.selection_begin());
+        auto last = store_->line_from_index(back.selection_end());
+        if (back.is_range() && last > first && store_->index_from_line(last) == back.selection_end())
+            --last;
+        return {first, last};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    line_operations::undo_type line_operations::sort(index_type first, index_type last, bool descending)
+    {
+        validate(first, last);
+
+        // keys are views into the store, the line number keeps equal lines in order.
+        std::vector <std::pair <std::string_view, index_type>> keys;
+        keys.reserve(static_cast <std::size_t> (last - first + 1));
+        for (auto line = first; line <= last; ++line)
+            keys.emplace_back(content(line), line);
+
+        if (descending)
+        {
+            detail::parallel_sort(keys, [](auto const& lhs, auto const& rhs)
+            {
+                return lhs.first > rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+            });
+        }
+        else
+            detail::parallel_sort(keys, std::less <> {});
+
+        std::vector <index_type> order;
+        order.reserve(keys.size());
+        for (auto const& key : keys)
+            order.push_back(key.second);
+
+        if (std::is_sorted(std::begin(order), std::end(order)))
+            return {};
+        return rearrange(first, last, order);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    line_operations::undo_type line_operations::unique(index_type first, index_type last)
+    {
+        validate(first, last);
+
+        std::unordered_set <std::string_view> seen;
+        seen.reserve(static_cast <std::size_t> (last - first + 1));
+        std::vector <index_type> order;
+        for (auto line = first; line <= last; ++line)
+        {
+            if (seen.insert(content(line)).second)
+                order.push_back(line);
+        }
+
+        if (order.size() == static_cast <std::size_t> (last - first + 1))
+            return {};
+        return rearrange(first, last, order);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    line_operations::undo_type line_operations::reverse(index_type first, index_type last)
+    {
+        validate(first, last);
+        if (first == last)
+            return {};
+
+        std::vector <index_type> order(static_cast <std::size_t> (last - first + 1));
+        std::iota(std::rbegin(order), std::rend(order), first);
+        return rearrange(first, last, order);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    line_operations::undo_type line_operations::move_up(index_type first, index_type last)
+    {
+        validate(first, last);
+        if (first == 0)
+            return {};
+
+        std::vector <index_type> order(static_cast <std::size_t> (last - first + 1));
+        std::iota(std::begin(order), std::end(order), first);
+        order.push_back(first - 1);
+        return rearrange(first - 1, last, order);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    line_operations::undo_type line_operations::move_down(index_type first, index_type last)
+    {
+        validate(first, last);
+        if (last + 1 == static_cast <index_type> (store_->line_count()))
+            return {};
+
+        std::vector <index_type> order(static_cast <std::size_t> (last - first + 2));
+        std::iota(std::begin(order), std::end(order), first - 1);
+        order.front() = last + 1;
+        return rearrange(first, last + 1, order);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    line_operations::undo_type line_operations::duplicate(index_type first, index_type last)
+    {
+        validate(first, last);
+
+        auto const count = static_cast <std::size_t> (last - first + 1);
+        std::vector <index_type> order(count * 2);
+        std::iota(std::begin(order), std::begin(order) + static_cast <std::ptrdiff_t> (count), first);
+        std::iota(std::begin(order) + static_cast <std::ptrdiff_t> (count), std::end(order), first);
+        return rearrange(first, last, order);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    line_operations::undo_type line_operations::rearrange(index_type first, index_type last, std::vector <index_type> const& order)
+    {
+        auto const line_count = static_cast <index_type> (store_->line_count());
+        auto const separator = line_break(store_->line_end());
+        auto const begin = store_->index_from_line(first);
+        auto const trailing = last + 1 < line_count;
+        auto const end = trailing ? store_->index_from_line(last + 1) : static_cast <index_type> (store_->size());
+
+        std::size_t length = 0;
+        for (auto const line : order)
+            length += content(line).size() + separator.size();
+        if (!trailing)
+            length -= separator.size();
+
+        // where every line begins in the new text. A repeated line is found at its last copy.
+        std::vector <index_type> moved(static_cast <std::size_t> (last - first + 1), -1);
+        std::string text;
+        text.reserve(length);
+        for (std::size_t i = 0; i != order.size(); ++i)
+        {
+            moved[static_cast <std::size_t> (order[i] - first)] = static_cast <index_type> (text.size());
+            text += content(order[i]);
+            if (i + 1 != order.size() || trailing)
+                text += separator;
+        }
+
+        // left out lines lead to the next line that is still there.
+        auto next = static_cast <index_type> (text.size());
+        std::vector <bool> left_out(moved.size(), false);
+        for (auto iter = std::rbegin(moved); iter != std::rend(moved); ++iter)
+        {
+            if (*iter < 0)
+            {
+                *iter = next;
+                left_out[static_cast <std::size_t> (std::distance(iter, std::rend(moved)) - 1)] = true;
+            }
+            else
+                next = *iter;
+        }
+
+        auto const shift = static_cast <index_type> (text.size()) - (end - begin);
+        auto const move = [&](index_type pos) -> index_type
+        {
+            if (pos < begin)
+                return pos;
+            if (pos > end || (pos == end && trailing))
+                return pos + shift;
+
+            auto const line = store_->line_from_index(pos);
+            auto const index = static_cast <std::size_t> (line - first);
+            if (left_out[index])
+                return begin + moved[index];
+
+            auto const column = std::min(pos - store_->index_from_line(line), static_cast <index_type> (content(line).size()));
+            return begin + moved[index] + column;
+        };
+
+        std::vector <data_store::caret_type> carets;
+        carets.reserve(store_->caret_count());
+        for (auto iter = store_->caret_begin(); iter != store_->caret_end(); ++iter)
+        {
+            auto const offset = move(iter->offset);
+            carets.emplace_back(offset, move(iter->offset + iter->range) - offset);
+        }
+        std::sort(std::begin(carets), std::end(carets));
+
+        auto undo = store_->replace_all({{begin, end - begin, std::move(text)}});
+        store_->replace_carets(carets);
+        return undo;
+    }
+//#####################################################################################################################
+}
@@ -0,0 +1,249 @@
+#include <nana-source-view/abstractions/literal_finder.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#   define NANA_SOURCE_VIEW_SSE2
+#   include <emmintrin.h>
+#endif
+
+namespace nana_source_view
+{
+    namespace
+    {
+        /**
+         *  Simple case folding of the letters that keep their utf8 length, which are all in 2 byte sequences.
+         *  Letters that change length, like U+0130 or U+017F, and the final sigma fold to themselves.
+         */
+        char32_t fold(char32_t c)
+        {
+            if (c >= 'A' && c <= 'Z')
+                return c + 0x20;
+            if (c >= 0xC0 && c <= 0xDE && c != 0xD7)
+                return c + 0x20;
+            if (c == 0x178)
+                return 0xFF;
+            if ((c >= 0x100 && c <= 0x12F) || (c >= 0x132 && c <= 0x137) || (c >= 0x14A && c <= 0x177))
+                return c | 1;
+            if ((c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E))
+                return c + (c & 1);
+            if (c >= 0x391 && c <= 0x3A9 && c != 0x3A2)
+                return c + 0x20;
+            if (c >= 0x410 && c <= 0x42F)
+                return c + 0x20;
+            if (c >= 0x400 && c <= 0x40F)
+                return c + 0x50;
+            return c;
+        }
+
+        /**
+         *  The other case of a letter, or c itself.
+         */
+        char32_t other_case(char32_t c)
+        {
+            if (fold(c) != c)
+                return fold(c);
+
+            for (char32_t distance : {0x20, 0x50, 0x1})
+            {
+                if (c >= distance && fold(c - distance) == c)
+                    return c - distance;
+            }
+            if (c == 0xFF)
+                return 0x178;
+            return c;
+        }
+
+        std::array <char, 2> encode_2(char32_t c)
+        {
+            return {static_cast <char> (0xC0 | (c >> 6)), static_cast <char> (0x80 | (c & 0x3F))};
+        }
+
+        bool is_continuation(char c)
+        {
+            return (static_cast <unsigned char> (c) & 0xC0) == 0x80;
+        }
+
+#ifdef NANA_SOURCE_VIEW_SSE2
+        unsigned lowest_bit(unsigned mask)
+        {
+#   if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast <unsigned> (index);
+#   else
+            return static_cast <unsigned> (__builtin_ctz(mask));
+#   endif
+        }
+
+        __m128i either(__m128i bytes, std::array <char, 2> const& forms)
+        {
+            return _mm_or_si128(
+                _mm_cmpeq_epi8(bytes, _mm_set1_epi8(forms[0])),
+                _mm_cmpeq_epi8(bytes, _mm_set1_epi8(forms[1]))
+            );
+        }
+#endif
+    }
+//#####################################################################################################################
+    literal_finder::literal_finder(std::string_view needle, find_case mode)
+        : mode_{mode}
+        , needle_{needle}
+        , units_{}
+        , first_{}
+        , last_{}
+    {
+        if (needle.empty())
+            throw std::invalid_argument("literal_finder: cannot search for nothing");
+
+        for (std::size_t i = 0; i != needle.size();)
+        {
+            auto const c = static_cast <unsigned char> (needle[i]);
+            if (mode != find_case::exact && c < 0x80)
+            {
+                auto const letter = (c | 0x20) >= 'a' && (c | 0x20) <= 'z';
+                auto const other = static_cast <char> (letter ? c ^ 0x20 : c);
+                units_.push_back({1, {needle[i], 0}, {other, 0}});
+                ++i;
+                continue;
+            }
+
+            // a two byte sequence of a letter with two cases.
+            if (mode == find_case::utf8_insensitive && (c & 0xE0) == 0xC0 && i + 1 < needle.size() && is_continuation(needle[i + 1]))
+            {
+                auto const code = static_cast <char32_t> (((c & 0x1F) << 6) | (static_cast <unsigned char> (needle[i + 1]) & 0x3F));
+                auto const other = other_case(code);
+                if (other != code && other >= 0x80 && other < 0x800)
+                {
+                    units_.push_back({2, encode_2(code), encode_2(other)});
+                    i += 2;
+                    continue;
+                }
+            }
+
+            units_.push_back({1, {needle[i], 0}, {needle[i], 0}});
+            ++i;
+        }
+
+        first_ = {units_.front().lower[0], units_.front().upper[0]};
+        auto const& back = units_.back();
+        last_ = {back.lower[back.length - 1], back.upper[back.length - 1]};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t literal_finder::size() const
+    {
+        return needle_.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool literal_finder::matches_at(std::string_view text, std::size_t pos) const
+    {
+        if (mode_ == find_case::exact)
+            return std::memcmp(text.data() + pos, needle_.data(), needle_.size()) == 0;
+
+        for (auto const& u : units_)
+        {
+            auto const* at = text.data() + pos;
+            if (std::memcmp(at, u.lower.data(), u.length) != 0 && std::memcmp(at, u.upper.data(), u.length) != 0)
+                return false;
+            pos += u.length;
+        }
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool literal_finder::matches(std::string_view text, std::size_t pos) const
+    {
+        return pos <= text.size() && text.size() - pos >= needle_.size() && matches_at(text, pos);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    template <typename FunctionT>
+    std::size_t literal_finder::scan(std::string_view text, std::size_t from, std::size_t to, FunctionT&& on_match) const
+    {
+        auto const n = needle_.size();
+        if (text.size() < n)
+            return std::max(from, to);
+
+        // past the last position a match fits in.
+        auto const end = std::min(to, text.size() - n + 1);
+        auto pos = from;
+
+#ifdef NANA_SOURCE_VIEW_SSE2
+        // 16 candidates per step: their first bytes and their last bytes are loaded side by side.
+        auto const* data = text.data();
+        auto reach = from;
+        while (pos < end && pos + n - 1 + 16 <= text.size())
+        {
+            auto const heads = _mm_loadu_si128(reinterpret_cast <__m128i const*> (data + pos));
+            auto const tails = _mm_loadu_si128(reinterpret_cast <__m128i const*> (data + pos + n - 1));
+            auto mask = static_cast <unsigned> (_mm_movemask_epi8(_mm_and_si128(either(heads, first_), either(tails, last_))));
+
+            auto next = pos + 16;
+            while (mask != 0)
+            {
+                auto const candidate = pos + lowest_bit(mask);
+                mask &= mask - 1;
+                if (candidate >= end)
+                    return std::max(reach, to);
+                if (!matches_at(text, candidate))
+                    continue;
+
+                if (!on_match(candidate))
+                    return candidate + n;
+
+                // matches do not overlap, candidates within this one are dropped.
+                reach = candidate + n;
+                next = std::max(next, reach);
+                auto const skipped = candidate + n - pos;
+                mask = skipped >= 16 ? 0 : mask & ~((1u << skipped) - 1);
+            }
+            pos = next;
+        }
+#endif
+        while (pos < end)
+        {
+            if ((text[pos] == first_[0] || text[pos] == first_[1]) && matches_at(text, pos))
+            {
+                if (!on_match(pos))
+                    return pos + n;
+                pos += n;
+            }
+            else
+                ++pos;
+        }
+        return std::max(pos, to);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t literal_finder::find_all(std::string_view text, std::size_t from, std::size_t to, std::vector <std::size_t>& found) const
+    {
+        return scan(text, from, to, [&found](std::size_t pos)
+        {
+            found.push_back(pos);
+            return true;
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t literal_finder::find_next(std::string_view text, std::size_t from) const
+    {
+        auto result = npos;
+        scan(text, from, text.size(), [&result](std::size_t pos)
+        {
+            result = pos;
+            return false;
+        });
+        return result;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <data_store::caret_type> literal_finder::select_all(data_store const& store) const
+    {
+        std::vector <data_store::caret_type> carets;
+        auto const length = static_cast <data_store::index_type> (needle_.size());
+        scan(store.view(), 0, store.size(), [&](std::size_t pos)
+        {
+            carets.push_back({static_cast <data_store::index_type> (pos) + length, -length});
+            return true;
+        });
+        return carets;
+    }
+//#####################################################################################################################
+}
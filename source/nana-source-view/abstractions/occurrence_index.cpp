@@ -0,0 +1,287 @@
+#include <nana-source-view/abstractions/occurrence_index.hpp>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <utility>
+
+namespace nana_source_view
+{
+    namespace
+    {
+        /// Shifts that are logged before all words are brought up to date at once.
+        constexpr std::size_t shift_log_limit = 256;
+
+        /**
+         *  basic_navigator::classify as a table, it is asked for every byte of the document.
+         */
+        bool is_identifier(char byte)
+        {
+            static auto const table = []
+            {
+                std::array <bool, 256> result{};
+                for (std::size_t i = 0; i != result.size(); ++i)
+                {
+                    result[i] = basic_navigator::classify(static_cast <char> (i)) ==
+                        basic_navigator::basic_character_classes::identifier;
+                }
+                return result;
+            }();
+            return table[static_cast <unsigned char> (byte)];
+        }
+    }
+//#####################################################################################################################
+    occurrence_index::occurrence_index(data_store const* store)
+        : store_{store}
+        , lines_{}
+        , ids_{}
+        , words_{}
+        , free_ids_{}
+        , shifts_{}
+        , completions_{}
+    {
+        rebuild();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void occurrence_index::rebuild()
+    {
+        lines_.reset(0);
+        ids_.clear();
+        words_.clear();
+        free_ids_.clear();
+        shifts_.clear();
+        completions_.clear();
+
+        replace_lines(0, 0, store_->line_count());
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void occurrence_index::on_edit(std::vector <edit_delta> const& deltas)
+    {
+        // groups are in order, so all lines in front of a group are already in new line numbers.
+        for (auto const& group : group_deltas(deltas))
+        {
+            replace_lines(
+                group.new_begin,
+                group.new_begin + (group.old_end - group.old_begin + 1),
+                group.new_end - group.new_begin + 1
+            );
+        }
+        sv_assert(lines_.line_count() == store_->line_count(), "occurrence index lost track of the lines")
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string_view occurrence_index::line_text(std::size_t line) const
+    {
+        auto [begin, end] = store_->line(static_cast <index_type> (line));
+        if (begin == end)
+            return {};
+        return {&*begin, static_cast <std::size_t> (end - begin)};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void occurrence_index::scan_line(std::size_t line, std::vector <occurrence>& found)
+    {
+        auto const text = line_text(line);
+        for (std::size_t pos = 0; pos < text.size();)
+        {
+            if (!is_identifier(text[pos]))
+            {
+                ++pos;
+                continue;
+            }
+
+            auto const begin = pos;
+            while (pos < text.size() && is_identifier(text[pos]))
+                ++pos;
+
+            found.push_back({
+                static_cast <std::uint32_t> (begin),
+                static_cast <std::uint32_t> (pos - begin),
+                intern(text.substr(begin, pos - begin))
+            });
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    occurrence_index::word_id occurrence_index::intern(std::string_view text)
+    {
+        auto [iter, inserted] = ids_.try_emplace(std::string{text}, 0);
+        if (!inserted)
+            return iter->second;
+
+        word_id id;
+        if (free_ids_.empty())
+        {
+            id = static_cast <word_id> (words_.size());
+            words_.emplace_back();
+        }
+        else
+        {
+            id = free_ids_.back();
+            free_ids_.pop_back();
+        }
+
+        // a new word has no lines, no shift of the past applies to it.
+        words_[id] = word_entry{iter->first, {}, shifts_.size()};
+        iter->second = id;
+        return id;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void occurrence_index::normalize(word_entry& entry) const
+    {
+        for (; entry.applied != shifts_.size(); ++entry.applied)
+        {
+            auto const& shift = shifts_[entry.applied];
+            auto from = std::lower_bound(std::begin(entry.lines), std::end(entry.lines), shift.from);
+            std::for_each(from, std::end(entry.lines), [delta = shift.delta](auto& line)
+            {
+                line = static_cast <std::size_t> (static_cast <std::ptrdiff_t> (line) + delta);
+            });
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void occurrence_index::compact()
+    {
+        for (auto& entry : words_)
+            normalize(entry);
+        shifts_.clear();
+        for (auto& entry : words_)
+            entry.applied = 0;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void occurrence_index::replace_lines(std::size_t begin, std::size_t end, std::size_t count)
+    {
+        // forget the occurrences of the replaced lines.
+        std::vector <word_id> removed;
+        for (auto const& o : lines_.lines(begin, end))
+            removed.push_back(o.word);
+        std::sort(std::begin(removed), std::end(removed));
+        removed.erase(std::unique(std::begin(removed), std::end(removed)), std::end(removed));
+
+        for (auto id : removed)
+        {
+            auto& entry = words_[id];
+            normalize(entry);
+            auto const first = std::lower_bound(std::begin(entry.lines), std::end(entry.lines), begin);
+            auto const last = std::lower_bound(first, std::end(entry.lines), end);
+            completions_.add(entry.text, -(last - first));
+            entry.lines.erase(first, last);
+            if (entry.lines.empty())
+            {
+                ids_.erase(entry.text);
+                entry.text.clear();
+                entry.text.shrink_to_fit();
+                free_ids_.push_back(id);
+            }
+        }
+
+        // all lines behind move, the replaced lines are empty now for every word.
+        auto const delta = static_cast <std::ptrdiff_t> (count) - static_cast <std::ptrdiff_t> (end - begin);
+        if (delta != 0)
+            shifts_.push_back({end, delta});
+
+        // scan the new ones.
+        std::vector <occurrence> found;
+        std::vector <std::size_t> sizes;
+        std::vector <std::pair <word_id, std::size_t>> added;
+        sizes.reserve(count);
+        for (auto line = begin; line != begin + count; ++line)
+        {
+            auto const before = found.size();
+            scan_line(line, found);
+            sizes.push_back(found.size() - before);
+            for (auto i = before; i != found.size(); ++i)
+                added.push_back({found[i].word, line});
+        }
+
+        // per word the new lines are one sorted block, that goes where the replaced lines were.
+        std::stable_sort(std::begin(added), std::end(added), [](auto const& lhs, auto const& rhs)
+        {
+            return lhs.first < rhs.first;
+        });
+
+        for (auto first = std::begin(added); first != std::end(added);)
+        {
+            auto const id = first->first;
+            auto last = std::find_if(first, std::end(added), [id](auto const& a)
+            {
+                return a.first != id;
+            });
+
+            auto& entry = words_[id];
+            normalize(entry);
+            auto at = std::lower_bound(std::begin(entry.lines), std::end(entry.lines), begin);
+            std::vector <std::size_t> block;
+            block.reserve(static_cast <std::size_t> (last - first));
+            std::transform(first, last, std::back_inserter(block), [](auto const& a)
+            {
+                return a.second;
+            });
+            entry.lines.insert(at, std::begin(block), std::end(block));
+            completions_.add(entry.text, static_cast <std::ptrdiff_t> (block.size()));
+
+            first = last;
+        }
+
+        lines_.splice(begin, end, sizes, std::begin(found), std::end(found));
+
+        if (shifts_.size() > shift_log_limit)
+            compact();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <occurrence_index::index_type> occurrence_index::occurrences(std::string_view word) const
+    {
+        std::vector <index_type> result;
+        auto iter = ids_.find(std::string{word});
+        if (iter == std::end(ids_))
+            return result;
+
+        auto const id = iter->second;
+        auto& entry = words_[id];
+        normalize(entry);
+
+        result.reserve(entry.lines.size());
+        for (auto line = std::begin(entry.lines); line != std::end(entry.lines);)
+        {
+            auto const start = store_->index_from_line(static_cast <index_type> (*line));
+            for (auto const& o : lines_.line(*line))
+            {
+                if (o.word == id)
+                    result.push_back(start + static_cast <index_type> (o.column));
+            }
+            line = std::upper_bound(line, std::end(entry.lines), *line);
+        }
+        return result;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t occurrence_index::count(std::string_view word) const
+    {
+        auto iter = ids_.find(std::string{word});
+        if (iter == std::end(ids_))
+            return 0;
+        return words_[iter->second].lines.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string_view occurrence_index::word_at(index_type offset) const
+    {
+        if (offset < 0 || offset > static_cast <index_type> (store_->size()))
+            return {};
+
+        auto const line = store_->line_from_index(offset);
+        auto const column = static_cast <std::uint32_t> (offset - store_->index_from_line(line));
+        for (auto const& o : lines_.line(static_cast <std::size_t> (line)))
+        {
+            if (o.column <= column && column <= o.column + o.length)
+                return words_[o.word].text;
+        }
+        return {};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <word_trie::candidate> occurrence_index::complete(std::string_view prefix, std::size_t count) const
+    {
+        return completions_.complete(prefix, count);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t occurrence_index::distinct_words() const
+    {
+        return ids_.size();
+    }
+//#####################################################################################################################
+}
@@ -1,5 +1,6 @@
 #include <nana-source-view/abstractions/store.hpp>
 #include <nana-source-view/abstractions/iterator.hpp>
+#include <nana-source-view/abstractions/wrap_layout.hpp>
 #include <nana-source-view/assert/assert.hpp>
 
 #include <nana-source-view/abstractions/detail/unordered_interval.hpp>
@@ -9,7 +10,9 @@
 #include <nana/charset.hpp>
 
 #include <stdexcept>
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 
 namespace nana_source_view
 {
@@ -47,11 +50,13 @@ namespace nana_source_view
 //#####################################################################################################################
     basic_navigator::basic_navigator(data_store* store)
         : store{store}
+        , layout{nullptr}
     {
     }
 //---------------------------------------------------------------------------------------------------------------------
     basic_navigator::basic_navigator(data_store const* store)
         : store{const_cast <data_store* > (store)}
+        , layout{nullptr}
     {
     }
 //---------------------------------------------------------------------------------------------------------------------
@@ -119,14 +124,14 @@ namespace nana_source_view
                     );
             }
 
-            store->carets.clear();
-
             // There CANNOT be any duplicates, where cursors overlap.
             // If there are, this means the deoverlap of the interval trees was faulty, which is tested.
+            std::vector <caret_type> updated;
             for (auto i : positive_direction_intervals)
-                store->carets.emplace(i.low(), i.size());
+                updated.emplace_back(i.low(), i.size());
             for (auto i : negative_direction_intervals)
-                store->carets.emplace(i.high(), -i.size());
+                updated.emplace_back(i.high(), -i.size());
+            store->carets.assign(std::move(updated));
         }
         else if (!shift && ctrl)
         {
@@ -153,12 +158,13 @@ namespace nana_source_view
                 itree.insert_overlap({c.offset, utf8_go_left_class(start_point)});
             }
 
-            store->carets.clear();
+            std::vector <caret_type> updated;
             for (auto const& i : itree)
             {
                 auto pair = i.unordered();
-                store->carets.insert(caret_type{pair.first, pair.second - pair.first});
+                updated.emplace_back(pair.first, pair.second - pair.first);
             }
+            store->carets.assign(std::move(updated));
         }
     }
 //---------------------------------------------------------------------------------------------------------------------
@@ -234,12 +240,9 @@ namespace nana_source_view
         if (!shift && !ctrl)
         {
             data_store::caret_container_type updated;
-            if (!shift && !ctrl)
+            for (auto const& c : store->carets)
             {
-                for (auto const& c : view::reverse(store->carets))
-                {
-                    updated.emplace(utf8_go_right(c.offset), 0);
-                }
+                updated.emplace(utf8_go_right(c.offset), 0);
             }
             store->carets = std::move(updated);
         }
@@ -264,22 +267,22 @@ namespace nana_source_view
                     );
             }
 
-            store->carets.clear();
-
             //std::cout << positive_direction_intervals.size() << "\n";
             //std::cout << negative_direction_intervals.size() << "\n";
 
             // There CANNOT be any duplicates, where cursors overlap.
             // If there are, this means the deoverlap of the interval trees was faulty, which is tested.
+            std::vector <caret_type> updated;
             for (auto i : positive_direction_intervals)
-                store->carets.emplace(i.low(), i.size());
+                updated.emplace_back(i.low(), i.size());
             for (auto i : negative_direction_intervals)
-                store->carets.emplace(i.low(), -i.size());
+                updated.emplace_back(i.low(), -i.size());
+            store->carets.assign(std::move(updated));
         }
         else if (!shift && ctrl)
         {
             data_store::caret_container_type updated;
-            for (auto const& c : view::reverse(store->carets))
+            for (auto const& c : store->carets)
             {
                 if (c.offset >= static_cast <caret_type::index_type> (store->size()))
                 {
@@ -300,12 +303,13 @@ namespace nana_source_view
                 itree.insert_overlap({c.offset, utf8_go_right_class(start_point)});
             }
 
-            store->carets.clear();
+            std::vector <caret_type> updated;
             for (auto i : itree)
             {
                 auto pair = i.unordered();
-                store->carets.insert(caret_type{pair.first, pair.second - pair.first});
+                updated.emplace_back(pair.first, pair.second - pair.first);
             }
+            store->carets.assign(std::move(updated));
 
         }
     }
@@ -315,7 +319,16 @@ namespace nana_source_view
         //auto ch = store->utf8_character_fast(offset);
 
         // is sufficient, since all utf-8 chars that are checked are within single byte range.
-        auto ch = store->operator[](offset);
+        return classify(store->operator[](offset));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    basic_navigator::basic_character_classes basic_navigator::classify(char byte)
+    {
+        // the <cctype> functions are undefined for negative values.
+        auto const ch = static_cast <unsigned char> (byte);
+        if (ch >= 0x80)
+            return basic_character_classes::other;
+
         if (std::isspace(ch))
             return basic_character_classes::whitespace;
 
@@ -373,20 +386,217 @@ namespace nana_source_view
 //---------------------------------------------------------------------------------------------------------------------
     void basic_navigator::arrow_up_impl(bool shift, bool ctrl)
     {
-
+        move_rows(-1, shift);
     }
 //---------------------------------------------------------------------------------------------------------------------
     void basic_navigator::arrow_down_impl(bool shift, bool ctrl)
     {
+        move_rows(1, shift);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void basic_navigator::row_layout(wrap_layout const* layout)
+    {
+        this->layout = layout;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void basic_navigator::move_rows(caret_type::index_type rows, bool shift)
+    {
+        if (!shift)
+        {
+            std::vector <caret_type> updated;
+            updated.reserve(store->carets.size());
+            for (auto const& c : store->carets)
+                updated.emplace_back(row_step(c.offset, rows), 0);
+            store->carets.assign(std::move(updated));
+            return;
+        }
+
+        // the offset is the moving end, the anchor is where the selection began.
+        lib_interval_tree::interval_tree <detail::unordered_interval <caret_type::index_type>> itree;
+        for (auto const& c : store->carets)
+            itree.insert_overlap({row_step(c.offset, rows), c.offset + c.range});
+
+        std::vector <caret_type> updated;
+        for (auto i : itree)
+        {
+            auto pair = i.unordered();
+            updated.emplace_back(pair.first, pair.second - pair.first);
+        }
+        store->carets.assign(std::move(updated));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    basic_navigator::caret_type::index_type basic_navigator::row_step(caret_type::index_type from, caret_type::index_type rows) const
+    {
+        using index_type = caret_type::index_type;
+
+        auto const& starts = store->line_starts;
+        auto const* const data = store->data.data();
+        auto const size = static_cast <index_type> (store->data.size());
+        auto const line_count = static_cast <index_type> (store->line_count());
+        index_type const break_length = store->let == line_end_type::CRLF ? 2 : 1;
+        auto const content_end = [&](index_type line)
+        {
+            return line + 1 < line_count ? starts[static_cast <std::size_t> (line + 1)] - break_length : size;
+        };
+
+        // the row from is in, and where that row begins.
+        auto const line = store->line_from_index(from);
+        auto row_begin = starts[static_cast <std::size_t> (line)];
+        auto row = line;
+        if (layout)
+        {
+            row = layout->row_of_line(line);
+            auto const& points = layout->wrap_points(line);
+            auto const index = std::upper_bound(std::begin(points), std::end(points), from - row_begin) - std::begin(points);
+            if (index != 0 && !layout->hidden(line))
+            {
+                row_begin += points[static_cast <std::size_t> (index - 1)];
+                row += index;
+            }
+        }
+
+        // code points, continuation bytes do not count.
+        auto column = static_cast <index_type> (std::count_if(data + row_begin, data + from, [](char byte)
+        {
+            return (byte & 0b1100'0000) != 0b1000'0000;
+        }));
+
+        auto const target = row + rows;
+        if (target < 0)
+            return 0;
+        if (target >= (layout ? layout->row_count() : line_count))
+            return size;
+
+        // a wrapped row ends where the next one begins, that offset belongs to the next row.
+        auto target_line = target;
+        auto target_begin = index_type{0};
+        auto target_end = index_type{0};
+        auto wrapped = false;
+        if (layout)
+        {
+            auto const [found_line, found_row] = layout->line_of_row(target);
+            auto const& points = layout->wrap_points(found_line);
+            auto const line_begin = starts[static_cast <std::size_t> (found_line)];
+            target_line = found_line;
+            target_begin = line_begin + (found_row == 0 ? 0 : points[static_cast <std::size_t> (found_row - 1)]);
+            wrapped = found_row < static_cast <index_type> (points.size());
+            target_end = wrapped ? line_begin + points[static_cast <std::size_t> (found_row)] : content_end(found_line);
+        }
+        else
+        {
+            target_begin = starts[static_cast <std::size_t> (target_line)];
+            target_end = content_end(target_line);
+        }
+
+        auto pos = target_begin;
+        for (; column != 0 && pos < target_end; --column)
+        {
+            for (++pos; pos < target_end && (data[pos] & 0b1100'0000) == 0b1000'0000; ++pos)
+            {
+            }
+        }
+
+        if (wrapped && pos == target_end)
+            return utf8_go_left(pos);
+        return pos;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void basic_navigator::select_box
+    (
+        caret_type::index_type anchor_line,
+        caret_type::index_type anchor_column,
+        caret_type::index_type active_line,
+        caret_type::index_type active_column
+    )
+    {
+        using index_type = caret_type::index_type;
+
+        auto const line_count = static_cast <index_type> (store->line_count());
+        if (anchor_line < 0 || active_line < 0 || anchor_line >= line_count || active_line >= line_count)
+            throw std::out_of_range("line out of bounds");
+        if (anchor_column < 0 || active_column < 0)
+            throw std::out_of_range("column has to be positive");
+
+        auto const& starts = store->line_starts;
+        auto const* const data = store->data.data();
+        auto const size = static_cast <index_type> (store->data.size());
+        index_type const break_length = store->let == line_end_type::CRLF ? 2 : 1;
+        auto const near_column = std::min(anchor_column, active_column);
+        auto const far_column = std::max(anchor_column, active_column);
+        auto const first_line = std::min(anchor_line, active_line);
+        auto const last_line = std::max(anchor_line, active_line);
+
+        // lines and columns ascend, so the carets are produced sorted and go into the container as they are.
+        std::vector <caret_type> carets;
+        carets.reserve(static_cast <std::size_t> (last_line - first_line + 1));
+        for (auto line = first_line; line <= last_line; ++line)
+        {
+            auto pos = starts[static_cast <std::size_t> (line)];
+            auto const end = line + 1 < line_count ? starts[static_cast <std::size_t> (line + 1)] - break_length : size;
+
+            auto near = end;
+            for (index_type column = 0;; ++column)
+            {
+                if (column == near_column)
+                    near = pos;
+                if (column == far_column || pos == end)
+                    break;
+
+                for (++pos; pos < end && (data[pos] & 0b1100'0000) == 0b1000'0000; ++pos)
+                {
+                }
+            }
+
+            auto const anchor = anchor_column <= active_column ? near : pos;
+            auto const active = anchor_column <= active_column ? pos : near;
+            carets.emplace_back(active, anchor - active);
+        }
+        store->carets.assign_sorted(std::move(carets));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void basic_navigator::select_word(caret_type::index_type offset)
+    {
+        using index_type = caret_type::index_type;
+
+        auto const& data = store->data;
+        auto const size = static_cast <index_type> (data.size());
+        auto const line_break = [&data](index_type pos)
+        {
+            return data[static_cast <std::size_t> (pos)] == '\n' || data[static_cast <std::size_t> (pos)] == '\r';
+        };
+
+        offset = std::clamp(offset, index_type{0}, size);
+        if (offset == size || line_break(offset))
+        {
+            // an empty line has no word.
+            if (offset == 0 || line_break(offset - 1))
+            {
+                store->carets.assign(std::vector <caret_type> {{offset, 0}});
+                return;
+            }
+            --offset;
+        }
+
+        auto const kind = classify(data[static_cast <std::size_t> (offset)]);
+        auto const same = [&](index_type pos)
+        {
+            return !line_break(pos) && classify(data[static_cast <std::size_t> (pos)]) == kind;
+        };
 
+        auto begin = offset;
+        auto end = offset + 1;
+        while (begin > 0 && same(begin - 1))
+            --begin;
+        while (end < size && same(end))
+            ++end;
+        store->carets.assign(std::vector <caret_type> {{end, begin - end}});
     }
 //#####################################################################################################################
     data_store::data_store(byte_container_type initial_data, caret_type initial_caret)
         : data{std::move(initial_data)}
         , carets{std::move(initial_caret)}
         , let{line_end_type::LF}
-        , line_ends_index_sorted{}
-        , line_ends_line_sorted{}
+        , line_starts{}
     {
         reform_line_end_tree();
     }
@@ -400,6 +610,8 @@ namespace nana_source_view
     data_store::data_store(std::basic_string_view <byte_type> const& view)
         : data(view.size())
         , carets{{static_cast <caret_type::index_type> (view.size()), 0}}
+        , let{line_end_type::LF}
+        , line_starts{}
     {
         view.copy(&data[0], view.size());
         reform_line_end_tree();
@@ -408,6 +620,8 @@ namespace nana_source_view
     data_store::data_store(byte_container_type initial_data)
         : data(std::move(initial_data))
         , carets{{static_cast <caret_type::index_type> (data.size()), 0}}
+        , let{line_end_type::LF}
+        , line_starts{}
     {
         reform_line_end_tree();
     }
@@ -422,6 +636,12 @@ namespace nana_source_view
     void data_store::set_line_end(line_end_type let)
     {
         this->let = let;
+        reform_line_end_tree();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    line_end_type data_store::line_end() const
+    {
+        return let;
     }
 //---------------------------------------------------------------------------------------------------------------------
     data_store::codepage_character data_store::utf8_character_fast(caret_type::index_type pos) const
@@ -515,6 +735,11 @@ namespace nana_source_view
     {
         return carets.cend();
     }
+//---------------------------------------------------------------------------------------------------------------------
+    data_store::caret_iterator data_store::caret_lower_bound(index_type offset) const
+    {
+        return carets.lower_bound(caret_type{offset});
+    }
 //---------------------------------------------------------------------------------------------------------------------
     void data_store::remove_caret(caret_iterator c)
     {
@@ -525,15 +750,28 @@ namespace nana_source_view
     {
         return nana::charset(std::string{std::begin(data), std::end(data)}).to_bytes(nana::unicode::utf8);
     }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string_view data_store::view() const
+    {
+        return {data.data(), data.size()};
+    }
 //---------------------------------------------------------------------------------------------------------------------
     void data_store::utf8_string(std::string_view const& text)
     {
+        edit_delta delta{0, static_cast <index_type> (data.size()), 0, 0, static_cast <index_type> (line_count()) - 1, 0};
+
         carets.clear();
         data.clear();
 
         data.resize(text.size());
         std::copy(std::begin(text), std::end(text), std::begin(data));
-        carets.insert({static_cast <caret_type::index_type> (data.size()), 0});
+        carets.insert(caret_type{static_cast <caret_type::index_type> (data.size()), 0});
+
+        reform_line_end_tree();
+
+        delta.inserted = static_cast <index_type> (data.size());
+        delta.lines_inserted = static_cast <index_type> (line_count()) - 1;
+        notify({delta});
     }
 //---------------------------------------------------------------------------------------------------------------------
     void data_store::insert_byte(byte_type byte)
@@ -544,16 +782,298 @@ namespace nana_source_view
         if (carets.size() > 1)
             return insert_byte_multi_caret(byte);
 
-        // single caret editing
-        auto caret_iter = carets.begin();
-        auto car = *caret_iter;
-        if (caret_iter->is_range())
+        // single caret editing, a selection gets overwritten.
+        auto car = *carets.begin();
+        auto delta = replace_bytes(car.selection_begin(), car.selection_end() - car.selection_begin(), {&byte, 1});
+
+        carets.clear();
+        carets.emplace(car.selection_begin() + 1, 0);
+
+        notify({delta});
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    edit_delta data_store::replace_bytes(index_type offset, index_type removed, std::basic_string_view <byte_type> inserted)
+    {
+        sv_assert(offset >= 0, "offset cannot be negative")
+        sv_assert(removed >= 0, "cannot remove a negative amount")
+        sv_assert(offset + removed <= static_cast <index_type> (data.size()), "cannot replace out of bounds")
+
+        auto const first_line = line_from_index(offset);
+        auto const inserted_size = static_cast <index_type> (inserted.size());
+        auto const difference = inserted_size - removed;
+
+        auto front = data.begin() + offset;
+        data.erase(front, front + removed);
+        data.insert(data.begin() + offset, std::begin(inserted), std::end(inserted));
+
+        // Rescan from the beginning of the first touched line until a line beginning behind the edit
+        // matches a (shifted) old one again. Everything after that is still valid.
+        std::vector <index_type> fresh;
+        auto old_line = static_cast <std::size_t> (first_line) + 1;
+        auto const edit_end = offset + inserted_size;
+        auto const end = static_cast <index_type> (data.size());
+        bool synchronized = false;
+        for (auto i = line_starts[static_cast <std::size_t> (first_line)]; i < end;)
         {
-            carets.erase(caret_iter);
-            carets.insert(remove_range_single_caret(car));
+            auto length = line_break_length(i);
+            if (length == 0)
+            {
+                ++i;
+                continue;
+            }
+            i += length;
+
+            while (old_line < line_starts.size() && line_starts[old_line] + difference < i)
+                ++old_line;
+
+            if (i > edit_end && old_line < line_starts.size() && line_starts[old_line] + difference == i)
+            {
+                synchronized = true;
+                break;
+            }
+            fresh.push_back(i);
+        }
+        if (!synchronized)
+            old_line = line_starts.size();
+
+        auto const lines_removed = old_line - (static_cast <std::size_t> (first_line) + 1);
+        auto erase_begin = line_starts.begin() + first_line + 1;
+        auto fresh_begin = line_starts.erase(erase_begin, erase_begin + static_cast <std::ptrdiff_t> (lines_removed));
+        auto tail = line_starts.insert(fresh_begin, std::begin(fresh), std::end(fresh)) + static_cast <std::ptrdiff_t> (fresh.size());
+
+        if (difference != 0)
+            for (; tail != std::end(line_starts); ++tail)
+                *tail += difference;
+
+        return {
+            offset,
+            removed,
+            inserted_size,
+            first_line,
+            static_cast <index_type> (lines_removed),
+            static_cast <index_type> (fresh.size())
+        };
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void data_store::erase_backward(bool whole_word)
+    {
+        basic_navigator const navigator{this};
+        std::vector <replacement> ranges;
+        ranges.reserve(carets.size());
+        for (auto const& car : carets)
+        {
+            if (car.is_range())
+            {
+                ranges.push_back({car.selection_begin(), car.selection_end() - car.selection_begin(), {}});
+                continue;
+            }
+            auto const begin = whole_word ? navigator.utf8_go_left_class(car.offset) : navigator.utf8_go_left(car.offset);
+            ranges.push_back({begin, car.offset - begin, {}});
+        }
+        erase_ranges(std::move(ranges));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void data_store::erase_forward(bool whole_word)
+    {
+        basic_navigator const navigator{this};
+        std::vector <replacement> ranges;
+        ranges.reserve(carets.size());
+        for (auto const& car : carets)
+        {
+            if (car.is_range())
+            {
+                ranges.push_back({car.selection_begin(), car.selection_end() - car.selection_begin(), {}});
+                continue;
+            }
+            auto const end = whole_word ? navigator.utf8_go_right_class(car.offset) : navigator.utf8_go_right(car.offset);
+            ranges.push_back({car.offset, end - car.offset, {}});
+        }
+        erase_ranges(std::move(ranges));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void data_store::erase_ranges(std::vector <replacement> ranges)
+    {
+        // every range has its caret at one end and carets are unique, so a range always ends behind the beginning
+        // of the one in front. If it begins within that, they overlap and are joined.
+        std::vector <replacement> joined;
+        joined.reserve(ranges.size());
+        for (auto& range : ranges)
+        {
+            if (range.length == 0)
+                continue;
+
+            auto end = range.offset + range.length;
+            while (!joined.empty() && joined.back().offset + joined.back().length > range.offset)
+            {
+                range.offset = std::min(range.offset, joined.back().offset);
+                end = std::max(end, joined.back().offset + joined.back().length);
+                joined.pop_back();
+            }
+            range.length = end - range.offset;
+            joined.push_back(std::move(range));
         }
 
-        low_level_ops::insert(data, car, byte);
+        if (!joined.empty())
+            replace_all(joined);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <data_store::replacement> data_store::replace_all(std::vector <replacement> const& replacements)
+    {
+        auto const old_size = static_cast <index_type> (data.size());
+        auto new_size = old_size;
+        index_type previous_end = 0;
+        for (auto const& r : replacements)
+        {
+            if (r.offset < 0 || r.length < 0 || r.offset + r.length > old_size)
+                throw std::out_of_range("replacement out of bounds");
+            if (r.offset < previous_end)
+                throw std::invalid_argument("replacements have to be sorted and must not overlap");
+            previous_end = r.offset + r.length;
+            new_size += static_cast <index_type> (r.text.size()) - r.length;
+        }
+
+        // unchanged bytes and new texts are appended in order, every byte is copied once.
+        byte_container_type fresh;
+        fresh.reserve(static_cast <std::size_t> (new_size));
+        std::vector <replacement> undo;
+        undo.reserve(replacements.size());
+        std::vector <edit_delta> deltas;
+        deltas.reserve(replacements.size());
+        index_type read = 0;
+        for (auto const& r : replacements)
+        {
+            if (r.length == 0 && r.text.empty())
+                continue;
+
+            fresh.insert(std::end(fresh), std::begin(data) + read, std::begin(data) + r.offset);
+            auto const inserted = static_cast <index_type> (r.text.size());
+            undo.push_back({static_cast <index_type> (fresh.size()), inserted, {std::begin(data) + r.offset, std::begin(data) + r.offset + r.length}});
+            fresh.insert(std::end(fresh), std::begin(r.text), std::end(r.text));
+            deltas.push_back({r.offset, r.length, inserted, 0, 0, 0});
+            read = r.offset + r.length;
+        }
+        if (deltas.empty())
+            return undo;
+        fresh.insert(std::end(fresh), std::begin(data) + read, std::end(data));
+
+        // carets within a replaced range go behind its new text, all others keep their distance to it.
+        // iter is the first delta that ends at or behind pos.
+        auto const move = [&deltas, &undo, new_size, old_size](std::vector <edit_delta>::const_iterator iter, index_type pos)
+        {
+            if (iter == std::cend(deltas))
+                return pos + new_size - old_size;
+
+            auto const& counterpart = undo[static_cast <std::size_t> (std::distance(std::cbegin(deltas), iter))];
+            if (pos <= iter->offset)
+                return pos - iter->offset + counterpart.offset;
+            return counterpart.offset + counterpart.length;
+        };
+        auto const reaching = [](edit_delta const& d, index_type pos)
+        {
+            return d.offset + d.removed < pos;
+        };
+
+        // carets are sorted by offset, so their offsets are moved in a single walk over the deltas.
+        // Carets that end up at the same offset are merged by the set.
+        caret_container_type moved;
+        auto walk = std::cbegin(deltas);
+        for (auto const& car : carets)
+        {
+            while (walk != std::cend(deltas) && reaching(*walk, car.offset))
+                ++walk;
+            auto const offset = move(walk, car.offset);
+
+            auto other = offset;
+            if (car.is_range())
+            {
+                auto const end = car.offset + car.range;
+                other = move(std::lower_bound(std::cbegin(deltas), std::cend(deltas), end, reaching), end);
+            }
+            moved.insert(std::end(moved), caret_type{offset, other - offset});
+        }
+
+        auto const old_starts = std::move(line_starts);
+        data.swap(fresh);
+        carets = std::move(moved);
+        reform_line_end_tree();
+
+        // a line beginning depends on the byte in front of it, with CRLF on the two in front of it.
+        // So deltas that close up to each other are merged, they would count the same line beginning.
+        index_type const reach = let == line_end_type::CRLF ? 1 : 0;
+        std::vector <edit_delta> merged;
+        for (auto const& delta : deltas)
+        {
+            if (merged.empty() || merged.back().offset + merged.back().removed + reach <= delta.offset)
+            {
+                merged.push_back(delta);
+                continue;
+            }
+            auto& back = merged.back();
+            back.inserted += delta.offset - (back.offset + back.removed) + delta.inserted;
+            back.removed = delta.offset + delta.removed - back.offset;
+        }
+
+        // the deltas are sorted, so both line indices are walked once instead of searched.
+        struct line_walker
+        {
+            std::vector <index_type> const& starts;
+            std::size_t line;
+
+            index_type operator()(index_type index)
+            {
+                while (line + 1 < starts.size() && starts[line + 1] <= index)
+                    ++line;
+                return static_cast <index_type> (line);
+            }
+        };
+        line_walker old_line{old_starts, 0};
+        line_walker new_line{line_starts, 0};
+        index_type shift = 0;
+        for (auto& delta : merged)
+        {
+            auto const offset = delta.offset + shift;
+            delta.first_line = old_line(delta.offset);
+            auto const first_new_line = new_line(offset);
+            delta.lines_removed = old_line(std::min(delta.offset + delta.removed + reach, old_size)) - delta.first_line;
+            delta.lines_inserted = new_line(std::min(offset + delta.inserted + reach, new_size)) - first_new_line;
+            shift += delta.inserted - delta.removed;
+        }
+
+        notify(merged);
+        return undo;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    data_store::index_type data_store::line_break_length(index_type pos) const
+    {
+        auto const upos = static_cast <std::size_t> (pos);
+        switch (let)
+        {
+        case (line_end_type::LF):
+            return data[upos] == '\n' ? 1 : 0;
+
+        case (line_end_type::CR):
+            return data[upos] == '\r' ? 1 : 0;
+
+        case (line_end_type::CRLF):
+            return data[upos] == '\r' && upos + 1 < data.size() && data[upos + 1] == '\n' ? 2 : 0;
+        }
+        return 0;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void data_store::add_observer(edit_observer* observer)
+    {
+        observers.push_back(observer);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void data_store::remove_observer(edit_observer* observer)
+    {
+        observers.erase(std::remove(std::begin(observers), std::end(observers), observer), std::end(observers));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void data_store::notify(std::vector <edit_delta> const& deltas)
+    {
+        for (auto* observer : observers)
+            observer->on_edit(deltas);
     }
 //---------------------------------------------------------------------------------------------------------------------
     data_store::caret_type data_store::remove_range_single_caret(caret_type car)
@@ -582,6 +1102,37 @@ namespace nana_source_view
 
         carets.insert(caret_type{pos, range});
     }
+//---------------------------------------------------------------------------------------------------------------------
+    void data_store::add_carets(std::vector <caret_type> const& added)
+    {
+        auto const size = static_cast <caret_type::index_type> (data.size());
+        for (auto const& c : added)
+        {
+            if (c.offset < 0 || c.offset > size)
+                throw std::out_of_range("index out of bounds");
+        }
+
+        // the hint makes appending sorted carets amortized constant.
+        for (auto const& c : added)
+            carets.insert(std::end(carets), c);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void data_store::replace_carets(std::vector <caret_type> const& added)
+    {
+        sv_assert(!added.empty(), "the store needs at least one caret")
+
+        auto previous = std::move(carets);
+        carets.clear();
+        try
+        {
+            add_carets(added);
+        }
+        catch (...)
+        {
+            carets = std::move(previous);
+            throw;
+        }
+    }
 //---------------------------------------------------------------------------------------------------------------------
     void data_store::insert_byte_multi_caret(byte_type byte)
     {
@@ -600,18 +1151,25 @@ namespace nana_source_view
 //---------------------------------------------------------------------------------------------------------------------
     void data_store::clear()
     {
+        edit_delta delta{0, static_cast <index_type> (data.size()), 0, 0, static_cast <index_type> (line_count()) - 1, 0};
+
         carets.clear();
         data.clear();
 
-        carets.insert({0, 0});
+        carets.insert(caret_type{0, 0});
+
+        reform_line_end_tree();
+        notify({delta});
     }
 //---------------------------------------------------------------------------------------------------------------------
     data_store::index_type data_store::line_from_index(index_type index) const
     {
-        auto iter = line_ends_index_sorted.upper_bound({index, 0});
-        if (iter == std::end(line_ends_index_sorted))
-            return -1;
-        return iter->line;
+        if (index < 0 || index > static_cast <index_type> (data.size()))
+            throw std::out_of_range("index out of bounds");
+
+        // the first line always starts at 0, so upper_bound never yields begin.
+        auto iter = std::upper_bound(std::begin(line_starts), std::end(line_starts), index);
+        return static_cast <index_type> (std::distance(std::begin(line_starts), iter)) - 1;
     }
 //---------------------------------------------------------------------------------------------------------------------
     data_store::index_type data_store::index_from_line(index_type line) const
@@ -619,17 +1177,16 @@ namespace nana_source_view
         if (line < 0)
             throw std::out_of_range("line has to be positive");
 
-        if (static_cast <std::size_t> (line) >= line_ends_line_sorted.size())
+        if (static_cast <std::size_t> (line) >= line_starts.size())
             throw std::out_of_range("given line is not existant");
 
-        return line_ends_line_sorted[static_cast <std::size_t> (line)];
+        return line_starts[static_cast <std::size_t> (line)];
     }
 //---------------------------------------------------------------------------------------------------------------------
     std::size_t data_store::line_count() const
     {
-        sv_assert(line_ends_line_sorted.size() == line_ends_index_sorted.size(),
-                  "Both line end containers need to have the same size")
-        return line_ends_line_sorted.size();
+        sv_assert(!line_starts.empty(), "There is always at least one line")
+        return line_starts.size();
     }
 //---------------------------------------------------------------------------------------------------------------------
     std::pair <data_store::const_iterator, data_store::const_iterator> data_store::line(index_type line) const
@@ -642,57 +1199,24 @@ namespace nana_source_view
 //--------------------------------------------------------------------------------------------------------------------
     void data_store::reform_line_end_tree()
     {
-        // add fake character at end to avoid checks against eol.
-        // this can cost some performance if data has to be resized, but its worth it on average.
-        if (let == line_end_type::CRLF)
-            data.push_back(' ');
-
-        auto is_lf = [](auto const& dataStore, std::size_t offset)
-        {
-            return dataStore[offset] == '\n';
-        };
-        auto is_cr = [](auto const& dataStore, std::size_t offset)
+        line_starts.clear();
+        line_starts.push_back(0);
+
+        // every line ending ends with the searched byte, memchr skips the bytes in between at memory speed.
+        // CRLF pairs cannot overlap, so every LF behind a CR ends a line.
+        auto const searched = let == line_end_type::CR ? '\r' : '\n';
+        auto const* const first = data.data();
+        auto const* const last = first + data.size();
+        for (auto const* pos = first; pos != last;)
         {
-            return dataStore[offset] == '\r';
-        };
-        auto is_crlf = [](auto const& dataStore, std::size_t offset)
-        {
-            return dataStore[offset] == '\r' && dataStore[offset + 1] == '\n';
-        };
+            auto const* found = static_cast <byte_type const*> (std::memchr(pos, searched, static_cast <std::size_t> (last - pos)));
+            if (found == nullptr)
+                break;
 
-        auto impl = [this](auto const fn)
-        {
-            auto end = data.size();
-            if (let == line_end_type::CRLF)
-                --end;
-
-            for (decltype(data)::size_type i = 0; i != end; ++i)
-                if (fn(data, i))
-                {
-                    auto s = static_cast<index_type>(line_ends_line_sorted.size());
-                    line_ends_line_sorted.push_back(static_cast <index_type> (i));
-                    line_ends_index_sorted.insert({static_cast <index_type> (i), s});
-                }
-        };
-
-        auto impl2 = [&, this]()
-        {
-            switch (let)
-            {
-            case (line_end_type::CR):
-                return impl(is_cr);
-
-            case (line_end_type::LF):
-                return impl(is_lf);
-
-            case (line_end_type::CRLF):
-                return impl(is_crlf);
-            }
-        };
-        impl2();
-
-        if (let == line_end_type::CRLF)
-            data.pop_back();
+            if (let != line_end_type::CRLF || (found != first && found[-1] == '\r'))
+                line_starts.push_back(static_cast <index_type> (found - first + 1));
+            pos = found + 1;
+        }
     }
 //#####################################################################################################################
 }
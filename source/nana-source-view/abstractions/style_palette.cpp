@@ -0,0 +1,45 @@
+#include <nana-source-view/abstractions/style_palette.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace nana_source_view
+{
+//#####################################################################################################################
+    style_palette::style_palette()
+        : styles_{}
+    {
+        clear();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    style_id style_palette::intern(style const& s)
+    {
+        // the default entry is a placeholder and never matches.
+        auto iter = std::find(std::begin(styles_) + 1, std::end(styles_), s);
+        if (iter != std::end(styles_))
+            return static_cast <style_id> (std::distance(std::begin(styles_), iter));
+
+        if (styles_.size() > std::numeric_limits <style_id>::max())
+            throw std::length_error("style palette is full");
+
+        styles_.push_back(s);
+        return static_cast <style_id> (styles_.size() - 1);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    style const& style_palette::operator[](style_id id) const
+    {
+        return styles_[id];
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t style_palette::size() const
+    {
+        return styles_.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void style_palette::clear()
+    {
+        styles_.assign(1, style{nana::colors::white, nana::colors::black, font_flags::nothing});
+    }
+//#####################################################################################################################
+}
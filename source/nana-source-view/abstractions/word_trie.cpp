@@ -0,0 +1,189 @@
+#include <nana-source-view/abstractions/word_trie.hpp>
+#include <nana-source-view/assert/assert.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace nana_source_view
+{
+    namespace
+    {
+        constexpr std::uint32_t nil = std::numeric_limits <std::uint32_t>::max();
+        constexpr std::uint32_t root = 0;
+
+        bool byte_less(char lhs, char rhs)
+        {
+            return static_cast <unsigned char> (lhs) < static_cast <unsigned char> (rhs);
+        }
+    }
+//#####################################################################################################################
+    word_trie::word_trie()
+        : nodes_{}
+        , free_{}
+        , words_{0}
+    {
+        clear();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void word_trie::clear()
+    {
+        nodes_.assign(1, node{nil, nil, 0, 0, '\0'});
+        free_.clear();
+        words_ = 0;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::uint32_t word_trie::child(std::uint32_t n, char byte) const
+    {
+        auto c = nodes_[n].first_child;
+        while (c != nil && byte_less(nodes_[c].byte, byte))
+            c = nodes_[c].next_sibling;
+        return c != nil && nodes_[c].byte == byte ? c : nil;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::uint32_t word_trie::make_child(std::uint32_t n, char byte)
+    {
+        // siblings are sorted, the child goes behind previous.
+        auto previous = nil;
+        auto next = nodes_[n].first_child;
+        while (next != nil && byte_less(nodes_[next].byte, byte))
+        {
+            previous = next;
+            next = nodes_[next].next_sibling;
+        }
+        if (next != nil && nodes_[next].byte == byte)
+            return next;
+
+        std::uint32_t c;
+        if (free_.empty())
+        {
+            c = static_cast <std::uint32_t> (nodes_.size());
+            nodes_.push_back(node{nil, next, 0, 0, byte});
+        }
+        else
+        {
+            c = free_.back();
+            free_.pop_back();
+            nodes_[c] = node{nil, next, 0, 0, byte};
+        }
+
+        if (previous == nil)
+            nodes_[n].first_child = c;
+        else
+            nodes_[previous].next_sibling = c;
+        return c;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void word_trie::unlink(std::uint32_t parent, std::uint32_t n)
+    {
+        auto* link = &nodes_[parent].first_child;
+        while (*link != n)
+            link = &nodes_[*link].next_sibling;
+        *link = nodes_[n].next_sibling;
+        free_.push_back(n);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::uint32_t word_trie::find(std::string_view word) const
+    {
+        auto n = root;
+        for (auto byte : word)
+        {
+            n = child(n, byte);
+            if (n == nil)
+                return nil;
+        }
+        return n;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void word_trie::add(std::string_view word, std::ptrdiff_t delta)
+    {
+        if (delta == 0)
+            return;
+
+        std::vector <std::uint32_t> path{root};
+        path.reserve(word.size() + 1);
+        for (auto byte : word)
+        {
+            auto const next = delta > 0 ? make_child(path.back(), byte) : child(path.back(), byte);
+            sv_assert(next != nil, "cannot lower the frequency of a word that is not in the trie")
+            path.push_back(next);
+        }
+
+        auto& frequency = nodes_[path.back()].frequency;
+        auto const updated = static_cast <std::ptrdiff_t> (frequency) + delta;
+        sv_assert(updated >= 0, "word frequencies cannot become negative")
+        if (frequency == 0)
+            ++words_;
+        else if (updated == 0)
+            --words_;
+        frequency = static_cast <std::uint32_t> (updated);
+
+        // the best frequencies on the path, bottom up. Nodes without words below them are dropped.
+        for (auto i = path.size(); i-- != 0;)
+        {
+            auto& n = nodes_[path[i]];
+            n.best = n.frequency;
+            for (auto c = n.first_child; c != nil; c = nodes_[c].next_sibling)
+                n.best = std::max(n.best, nodes_[c].best);
+
+            if (i != 0 && n.best == 0)
+                unlink(path[i - 1], path[i]);
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t word_trie::frequency(std::string_view word) const
+    {
+        auto const n = find(word);
+        return n == nil ? 0 : nodes_[n].frequency;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t word_trie::size() const
+    {
+        return words_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <word_trie::candidate> word_trie::complete(std::string_view prefix, std::size_t count) const
+    {
+        std::vector <candidate> result;
+        auto const start = find(prefix);
+        if (start == nil || nodes_[start].best == 0 || count == 0)
+            return result;
+
+        // subtrees and words, best first. A subtree is ordered by its prefix, which is below all its words.
+        struct entry
+        {
+            std::uint32_t priority;
+            std::uint32_t n;
+            bool is_word;
+            std::string text;
+        };
+        auto worse = [](entry const& lhs, entry const& rhs)
+        {
+            if (lhs.priority != rhs.priority)
+                return lhs.priority < rhs.priority;
+            return lhs.text > rhs.text;
+        };
+        std::priority_queue <entry, std::vector <entry>, decltype(worse)> pending{worse};
+        pending.push({nodes_[start].best, start, false, std::string{prefix}});
+
+        while (!pending.empty() && result.size() < count)
+        {
+            auto top = pending.top();
+            pending.pop();
+            if (top.is_word)
+            {
+                result.push_back({std::move(top.text), top.priority});
+                continue;
+            }
+
+            auto const& n = nodes_[top.n];
+            if (n.frequency != 0)
+                pending.push({n.frequency, top.n, true, top.text});
+            for (auto c = n.first_child; c != nil; c = nodes_[c].next_sibling)
+                pending.push({nodes_[c].best, c, false, top.text + nodes_[c].byte});
+        }
+        return result;
+    }
+//#####################################################################################################################
+}
@@ -0,0 +1,346 @@
+#include <nana-source-view/abstractions/wrap_layout.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <thread>
+
+namespace nana_source_view
+{
+    namespace
+    {
+        /// Below this many lines, starting threads costs more than it saves.
+        constexpr std::size_t parallel_wrap_threshold = 1 << 14;
+
+        /**
+         *  Calls work(begin, end) for parts of [0, count), on threads of their own if there are enough.
+         */
+        template <typename FunctionT>
+        void split_work(std::size_t count, std::size_t threads, FunctionT const& work)
+        {
+            if (threads < 2 || count < parallel_wrap_threshold)
+            {
+                work(std::size_t{0}, count);
+                return;
+            }
+
+            std::vector <std::thread> workers;
+            for (std::size_t i = 0; i != threads; ++i)
+                workers.emplace_back(work, count * i / threads, count * (i + 1) / threads);
+            for (auto& worker : workers)
+                worker.join();
+        }
+
+        /**
+         *  Calls emit with every offset a row begins at but the first, see wrap_layout::wrap.
+         */
+        template <typename FunctionT>
+        void for_each_wrap(std::string_view text, std::int64_t columns, FunctionT&& emit)
+        {
+            if (columns <= 0)
+                return;
+
+            std::size_t row_begin = 0;
+            std::size_t blank_end = 0;
+            std::int64_t column = 0;
+            for (std::size_t pos = 0; pos != text.size(); ++pos)
+            {
+                // code points, continuation bytes do not count.
+                auto const c = static_cast <unsigned char> (text[pos]);
+                if ((c & 0b1100'0000) == 0b1000'0000)
+                    continue;
+
+                if (column == columns)
+                {
+                    row_begin = blank_end > row_begin ? blank_end : pos;
+                    emit(row_begin);
+
+                    column = std::count_if(&text[row_begin], &text[pos], [](char byte)
+                    {
+                        return (byte & 0b1100'0000) != 0b1000'0000;
+                    });
+                }
+
+                ++column;
+                if (c == ' ' || c == '\t')
+                    blank_end = pos + 1;
+            }
+        }
+
+        std::uint32_t count_rows(std::string_view text, std::int64_t columns)
+        {
+            std::uint32_t rows = 1;
+            for_each_wrap(text, columns, [&rows](std::size_t)
+            {
+                ++rows;
+            });
+            return rows;
+        }
+    }
+//#####################################################################################################################
+    wrap_layout::row_summary wrap_layout::row_traits::identity()
+    {
+        return {0, 0};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    wrap_layout::row_summary wrap_layout::row_traits::summarize(wrapped_line const& line)
+    {
+        if (line.hidden)
+            return {0, 0};
+        return {static_cast <index_type> (line.rows), line.stale ? 1 : 0};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    wrap_layout::row_summary wrap_layout::row_traits::combine(row_summary const& lhs, row_summary const& rhs)
+    {
+        return {lhs.rows + rhs.rows, lhs.stale + rhs.stale};
+    }
+//#####################################################################################################################
+    wrap_layout::wrap_layout(data_store const* store)
+        : store_{store}
+        , columns_{0}
+        , lines_{}
+        , cached_line_{-1}
+        , cached_points_{}
+    {
+        std::vector <wrapped_line> lines(store_->line_count(), wrapped_line{1, false, false});
+        lines_.splice(0, 0, std::begin(lines), std::end(lines));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void wrap_layout::columns(index_type columns)
+    {
+        columns = std::max(columns, index_type{0});
+        if (columns == columns_)
+            return;
+
+        columns_ = columns;
+        cached_line_ = -1;
+
+        // lines stay hidden, their rows are unknown until they are refreshed.
+        auto lines = lines_.values(0, lines_.size());
+        for (auto& line : lines)
+            line = {1, enabled(), line.hidden};
+        lines_.clear();
+        lines_.splice(0, 0, std::begin(lines), std::end(lines));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    wrap_layout::index_type wrap_layout::columns() const
+    {
+        return columns_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool wrap_layout::enabled() const
+    {
+        return columns_ > 0;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    wrap_layout::index_type wrap_layout::row_count() const
+    {
+        return lines_.summary(0, lines_.size()).rows;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    wrap_layout::index_type wrap_layout::rows(index_type line) const
+    {
+        return row_traits::summarize(lines_[static_cast <std::size_t> (line)]).rows;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    wrap_layout::index_type wrap_layout::row_of_line(index_type line) const
+    {
+        return lines_.summary(0, static_cast <std::size_t> (line)).rows;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::pair <wrap_layout::index_type, wrap_layout::index_type> wrap_layout::line_of_row(index_type row) const
+    {
+        auto const line_count = static_cast <index_type> (store_->line_count());
+        row_summary before;
+        auto const found = lines_.find_first(0, [row](row_summary const& preceding, row_summary const& lines)
+        {
+            return preceding.rows + lines.rows > row;
+        }, &before);
+
+        if (row < 0 || found == lines_.npos)
+            return {line_count, 0};
+        return {static_cast <index_type> (found), row - before.rows};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <wrap_layout::index_type> const& wrap_layout::wrap_points(index_type line) const
+    {
+        if (line != cached_line_)
+        {
+            cached_points_ = enabled() ? wrap(content(line), columns_) : std::vector <index_type> {};
+            cached_line_ = line;
+        }
+        return cached_points_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void wrap_layout::hide(index_type first, index_type last, bool hidden)
+    {
+        if (first >= last)
+            return;
+
+        auto lines = lines_.values(static_cast <std::size_t> (first), static_cast <std::size_t> (last));
+        for (auto& line : lines)
+            line.hidden = hidden;
+        lines_.splice(static_cast <std::size_t> (first), static_cast <std::size_t> (last), std::begin(lines), std::end(lines));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void wrap_layout::hide(index_type first, index_type last, std::vector <std::pair <index_type, index_type>> const& hidden)
+    {
+        if (first >= last)
+            return;
+
+        auto lines = lines_.values(static_cast <std::size_t> (first), static_cast <std::size_t> (last));
+        for (auto& line : lines)
+            line.hidden = false;
+        for (auto const& [begin, end] : hidden)
+        {
+            for (auto line = std::max(begin, first); line < std::min(end, last); ++line)
+                lines[static_cast <std::size_t> (line - first)].hidden = true;
+        }
+        lines_.splice(static_cast <std::size_t> (first), static_cast <std::size_t> (last), std::begin(lines), std::end(lines));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool wrap_layout::hidden(index_type line) const
+    {
+        return lines_[static_cast <std::size_t> (line)].hidden;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    wrap_layout::index_type wrap_layout::next_visible(index_type line) const
+    {
+        auto const found = lines_.find_first(static_cast <std::size_t> (line + 1), [](row_summary const&, row_summary const& lines)
+        {
+            return lines.rows != 0;
+        });
+        return found == lines_.npos ? static_cast <index_type> (lines_.size()) : static_cast <index_type> (found);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    wrap_layout::index_type wrap_layout::previous_visible(index_type line) const
+    {
+        if (line <= 0)
+            return -1;
+
+        auto const found = lines_.find_last(static_cast <std::size_t> (line), [](row_summary const& lines, row_summary const&)
+        {
+            return lines.rows != 0;
+        });
+        return found == lines_.npos ? -1 : static_cast <index_type> (found);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool wrap_layout::stale() const
+    {
+        return lines_.summary(0, lines_.size()).stale != 0;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool wrap_layout::refresh(index_type first, index_type last)
+    {
+        if (first >= last || lines_.summary(static_cast <std::size_t> (first), static_cast <std::size_t> (last)).stale == 0)
+            return false;
+
+        // only the stale lines are visited, not the hidden ones in between.
+        auto const is_stale = [](row_summary const&, row_summary const& lines)
+        {
+            return lines.stale != 0;
+        };
+        for (auto line = lines_.find_first(static_cast <std::size_t> (first), is_stale);
+             line < static_cast <std::size_t> (last);
+             line = lines_.find_first(line + 1, is_stale))
+        {
+            lines_.assign(line, {count_rows(content(static_cast <index_type> (line)), columns_), false, false});
+        }
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void wrap_layout::refresh_all(std::size_t threads)
+    {
+        auto const stale_lines = lines_.summary(0, lines_.size()).stale;
+        if (stale_lines == 0)
+            return;
+
+        // after a change of columns, everything is stale and rebuilt at once.
+        if (stale_lines == static_cast <index_type> (lines_.size()))
+        {
+            auto wrapped = wrap_lines(0, static_cast <index_type> (lines_.size()), threads);
+            lines_.clear();
+            lines_.splice(0, 0, std::begin(wrapped), std::end(wrapped));
+            return;
+        }
+
+        std::vector <index_type> pending;
+        pending.reserve(static_cast <std::size_t> (stale_lines));
+        auto const is_stale = [](row_summary const&, row_summary const& lines)
+        {
+            return lines.stale != 0;
+        };
+        for (auto line = lines_.find_first(0, is_stale); line != lines_.npos; line = lines_.find_first(line + 1, is_stale))
+            pending.push_back(static_cast <index_type> (line));
+
+        auto const wrapped = wrap_lines(pending, threads);
+        for (std::size_t i = 0; i != pending.size(); ++i)
+            lines_.assign(static_cast <std::size_t> (pending[i]), wrapped[i]);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <wrap_layout::index_type> wrap_layout::wrap(std::string_view text, index_type columns)
+    {
+        std::vector <index_type> points;
+        for_each_wrap(text, columns, [&points](std::size_t point)
+        {
+            points.push_back(static_cast <index_type> (point));
+        });
+        return points;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::string_view wrap_layout::content(index_type line) const
+    {
+        auto [begin, end] = store_->line(line);
+        while (begin != end && (*(end - 1) == '\n' || *(end - 1) == '\r'))
+            --end;
+        if (begin == end)
+            return {};
+        return {&*begin, static_cast <std::size_t> (end - begin)};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <wrap_layout::wrapped_line> wrap_layout::wrap_lines(std::vector <index_type> const& lines, std::size_t threads) const
+    {
+        std::vector <wrapped_line> wrapped(lines.size());
+        split_work(lines.size(), threads, [&](std::size_t begin, std::size_t end)
+        {
+            for (auto i = begin; i != end; ++i)
+                wrapped[i] = {count_rows(content(lines[i]), columns_), false, false};
+        });
+        return wrapped;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <wrap_layout::wrapped_line> wrap_layout::wrap_lines(index_type first, index_type last, std::size_t threads) const
+    {
+        std::vector <wrapped_line> wrapped(static_cast <std::size_t> (last - first));
+        split_work(wrapped.size(), threads, [&](std::size_t begin, std::size_t end)
+        {
+            for (auto i = begin; i != end; ++i)
+                wrapped[i] = {count_rows(content(first + static_cast <index_type> (i)), columns_), false, false};
+        });
+        return wrapped;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void wrap_layout::on_edit(std::vector <edit_delta> const& deltas)
+    {
+        cached_line_ = -1;
+
+        // groups are in order, so all lines in front of a group are already in new line numbers.
+        // Touched lines are shown, folds decide whether they are hidden again.
+        for (auto const& group : group_deltas(deltas))
+        {
+            auto wrapped = wrap_lines(
+                static_cast <index_type> (group.new_begin),
+                static_cast <index_type> (group.new_end + 1),
+                enabled() ? detail::sort_threads() : 1
+            );
+            lines_.splice(
+                group.new_begin,
+                group.new_begin + (group.old_end - group.old_begin + 1),
+                std::begin(wrapped),
+                std::end(wrapped)
+            );
+        }
+        sv_assert(lines_.size() == store_->line_count(), "wrap layout lost track of the lines")
+    }
+//#####################################################################################################################
+}
@@ -0,0 +1,469 @@
+#include <nana-source-view/c_styler.hpp>
+#include <nana-source-view/lexing/dfa.hpp>
+#include <nana-source-view/lexing/keyword_set.hpp>
+#include <nana-source-view/lexing/scan.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+namespace nana_source_view::styles
+{
+    namespace
+    {
+        constexpr std::string_view keyword_list[] = {
+            "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch",
+            "char", "char16_t", "char32_t", "char8_t", "class", "co_await", "co_return", "co_yield", "compl", "concept",
+            "const", "const_cast", "consteval", "constexpr", "constinit", "continue", "decltype", "default", "delete",
+            "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "final", "float",
+            "for", "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not",
+            "not_eq", "nullptr", "operator", "or", "or_eq", "override", "private", "protected", "public", "register",
+            "reinterpret_cast", "requires", "restrict", "return", "short", "signed", "sizeof", "static",
+            "static_assert", "static_cast", "struct", "switch", "template", "this", "thread_local", "throw", "true",
+            "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual", "void", "volatile",
+            "wchar_t", "while", "xor", "xor_eq"
+        };
+
+        constexpr auto keywords = lexing::make_keyword_set(keyword_list);
+
+        /**
+         *  The tokens the automaton tells apart. Comments and literals are only recognized by their opening bytes,
+         *  their ends are searched for directly.
+         */
+        enum token : std::uint8_t
+        {
+            blanks = 1,
+            identifier,
+            number,
+            punctuation,
+            line_comment,
+            block_comment,
+            string_quote,
+            character_quote
+        };
+
+        enum character_class : std::uint8_t
+        {
+            other,
+            blank,
+            letter,
+            exponent,
+            digit,
+            dot,
+            quote,
+            apostrophe,
+            slash,
+            star,
+            sign
+        };
+
+        enum state : std::uint8_t
+        {
+            dead,
+            start,
+            in_blanks,
+            in_identifier,
+            in_number,
+            in_exponent,
+            in_separator,
+            in_slash,
+            in_line_comment,
+            in_block_comment,
+            in_dot,
+            in_quote,
+            in_apostrophe,
+            in_punctuation,
+            state_count
+        };
+
+        using c_automaton = lexing::dfa <state_count, sign + 1>;
+
+        /**
+         *  Recognizes C tokens by pp-number rules, so suffixes, digit separators and signed exponents are
+         *  part of numbers.
+         */
+        constexpr c_automaton make_automaton()
+        {
+            c_automaton a{};
+            a.classify(0x80, 0xFF, letter);
+            a.classify("abcdfghijklmnoqrstuvwxyzABCDFGHIJKLMNOQRSTUVWXYZ_", letter);
+            a.classify("eEpP", exponent);
+            a.classify("0123456789", digit);
+            a.classify(" \t", blank);
+            a.classify(".", dot);
+            a.classify("\"", quote);
+            a.classify("'", apostrophe);
+            a.classify("/", slash);
+            a.classify("*", star);
+            a.classify("+-", sign);
+
+            a.transition(start, {other, star, sign}, in_punctuation);
+            a.transition(start, {blank}, in_blanks);
+            a.transition(start, {letter, exponent}, in_identifier);
+            a.transition(start, {digit}, in_number);
+            a.transition(start, {dot}, in_dot);
+            a.transition(start, {quote}, in_quote);
+            a.transition(start, {apostrophe}, in_apostrophe);
+            a.transition(start, {slash}, in_slash);
+
+            // blanks and punctuation look the same, so runs of both are a single token.
+            a.transition(in_blanks, {blank}, in_blanks);
+            a.transition(in_blanks, {other, star, sign}, in_punctuation);
+            a.transition(in_punctuation, {other, star, sign}, in_punctuation);
+            a.transition(in_punctuation, {blank}, in_blanks);
+            a.transition(in_identifier, {letter, exponent, digit}, in_identifier);
+            a.transition(in_number, {letter, digit, dot}, in_number);
+            a.transition(in_number, {exponent}, in_exponent);
+            a.transition(in_number, {apostrophe}, in_separator);
+            a.transition(in_exponent, {letter, digit, dot, sign}, in_number);
+            a.transition(in_exponent, {exponent}, in_exponent);
+            a.transition(in_exponent, {apostrophe}, in_separator);
+            a.transition(in_separator, {letter, exponent, digit}, in_number);
+            a.transition(in_slash, {slash}, in_line_comment);
+            a.transition(in_slash, {star}, in_block_comment);
+            a.transition(in_dot, {digit}, in_number);
+
+            a.accepts[in_blanks] = blanks;
+            a.accepts[in_identifier] = identifier;
+            a.accepts[in_number] = number;
+            a.accepts[in_exponent] = number;
+            a.accepts[in_slash] = punctuation;
+            a.accepts[in_line_comment] = line_comment;
+            a.accepts[in_block_comment] = block_comment;
+            a.accepts[in_dot] = punctuation;
+            a.accepts[in_quote] = string_quote;
+            a.accepts[in_apostrophe] = character_quote;
+            a.accepts[in_punctuation] = punctuation;
+
+            a.skips[in_blanks] = lexing::run_skip::blanks;
+            a.skips[in_identifier] = lexing::run_skip::identifier;
+            return a;
+        }
+
+        constexpr auto automaton = make_automaton();
+
+        /**
+         *  Is word a prefix of a string literal? Raw string prefixes end with 'R'.
+         */
+        bool is_string_prefix(std::string_view word)
+        {
+            return word == "L" || word == "u" || word == "U" || word == "u8"
+                || word == "R" || word == "LR" || word == "uR" || word == "UR" || word == "u8R";
+        }
+
+        /**
+         *  Finds the end of a quoted literal, starting within it.
+         *  @return Past the closing quote or npos if the line ends before.
+         */
+        std::size_t find_closing(std::string_view text, std::size_t from, char quote)
+        {
+            for (auto i = lexing::find_either(text, from, quote, '\\'); i < text.size(); i = lexing::find_either(text, i + 2, quote, '\\'))
+            {
+                if (text[i] == quote)
+                    return i + 1;
+            }
+            return std::string_view::npos;
+        }
+
+        c_style::theme default_theme()
+        {
+            auto make = [](unsigned rgb, unsigned char mods = font_flags::nothing)
+            {
+                return style{static_cast <nana::color_rgb> (rgb), static_cast <nana::color_rgb> (0x303030), mods};
+            };
+            return {
+                make(0x569CD6),
+                make(0x6A9955),
+                make(0xCE9178),
+                make(0xB5CEA8),
+                make(0xC586C0)
+            };
+        }
+    }
+//#####################################################################################################################
+    c_style::c_style(data_store const* store)
+        : c_style{store, default_theme()}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    c_style::c_style(data_store const* store, theme const& colors)
+        : styler{store}
+        , theme_{colors}
+        , keyword_{style_palette::default_id}
+        , comment_{style_palette::default_id}
+        , string_{style_palette::default_id}
+        , number_{style_palette::default_id}
+        , preprocessor_{style_palette::default_id}
+        , states_{}
+        , delimiters_(1, std::string{})
+        , delimiter_ids_{{std::string{}, 0}}
+        , relexed_{0}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void c_style::initialize()
+    {
+        palette.clear();
+        keyword_ = palette.intern(theme_.keyword);
+        comment_ = palette.intern(theme_.comment);
+        string_ = palette.intern(theme_.string);
+        number_ = palette.intern(theme_.number);
+        preprocessor_ = palette.intern(theme_.preprocessor);
+
+        // ids of a former text are not referred to anymore.
+        delimiters_.assign(1, std::string{});
+        delimiter_ids_.clear();
+        delimiter_ids_.emplace(std::string{}, 0);
+
+        auto const line_count = store->line_count();
+        styles.reset(line_count);
+        brackets.reset(line_count);
+        states_.assign(line_count + 1, line_state{});
+
+        on_multi_line_change(0, static_cast <index_type> (line_count));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void c_style::on_multi_line_change(index_type begin, index_type end)
+    {
+        relexed_ = relex(states_, begin, end, [this](std::string_view text, auto state, auto& ranges, auto& found)
+        {
+            return lex_line(text, state, ranges, found);
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::uint16_t c_style::delimiter_id(std::string_view delimiter)
+    {
+        std::string key{delimiter};
+        if (auto found = delimiter_ids_.find(key); found != std::end(delimiter_ids_))
+            return found->second;
+
+        if (delimiters_.size() > std::numeric_limits <std::uint16_t>::max())
+            throw std::length_error("c_style: too many raw string delimiters");
+
+        auto const id = static_cast <std::uint16_t> (delimiters_.size());
+        delimiters_.push_back(key);
+        delimiter_ids_.emplace(std::move(key), id);
+        return id;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    c_style::line_state c_style::lex_line
+    (
+        std::string_view text,
+        line_state state,
+        std::vector <style_range>& ranges,
+        std::vector <bracket>& found
+    )
+    {
+        using context = line_state::context;
+        constexpr auto npos = std::string_view::npos;
+
+        auto const first_range = ranges.size();
+        auto emit = [&](std::size_t from, std::size_t to, style_id id)
+        {
+            if (from >= to || id == style_palette::default_id)
+                return;
+
+            if (ranges.size() > first_range && ranges.back().id == id && ranges.back().start + ranges.back().length == from)
+                ranges.back().length += static_cast <std::uint32_t> (to - from);
+            else
+                ranges.push_back({static_cast <std::uint32_t> (from), static_cast <std::uint32_t> (to - from), id});
+        };
+
+        auto add_brackets = [&](std::size_t from, std::size_t to)
+        {
+            for (; from != to; ++from)
+                if (bracket_index::is_bracket(text[from]))
+                    found.push_back({static_cast <std::uint32_t> (from), text[from]});
+        };
+
+        auto const size = text.size();
+        auto const continued = size != 0 && text.back() == '\\';
+        auto preprocessor = state.preprocessor;
+        std::size_t pos = 0;
+
+        // finish what the previous line left open.
+        switch (state.ctx)
+        {
+            case context::code:
+                break;
+            case context::block_comment:
+            {
+                auto close = text.find("*/");
+                if (close == npos)
+                {
+                    emit(0, size, comment_);
+                    return state;
+                }
+                emit(0, close + 2, comment_);
+                pos = close + 2;
+                break;
+            }
+            case context::line_comment:
+            {
+                emit(0, size, comment_);
+                return continued ? state : line_state{};
+            }
+            case context::string:
+            {
+                pos = find_closing(text, 0, '"');
+                if (pos == npos)
+                {
+                    emit(0, size, string_);
+                    return continued ? state : line_state{context::code, preprocessor && continued, 0};
+                }
+                emit(0, pos, string_);
+                break;
+            }
+            case context::raw_string:
+            {
+                auto const closing = ")" + delimiters_[state.delimiter] + "\"";
+                auto close = text.find(closing);
+                if (close == npos)
+                {
+                    emit(0, size, string_);
+                    return state;
+                }
+                pos = close + closing.size();
+                emit(0, pos, string_);
+                break;
+            }
+        }
+
+        // a directive starts with the first non blank character of a line.
+        if (!preprocessor && state.ctx == context::code)
+        {
+            auto hash = lexing::skip_blanks(text, 0);
+            if (hash < size && text[hash] == '#')
+            {
+                preprocessor = true;
+                auto name = lexing::skip_blanks(text, hash + 1);
+                auto name_end = lexing::skip_identifier(text, name);
+                emit(hash, name_end, preprocessor_);
+                pos = name_end;
+
+                auto directive = text.substr(name, name_end - name);
+                auto header = lexing::skip_blanks(text, pos);
+                if ((directive == "include" || directive == "include_next" || directive == "import") && header < size && text[header] == '<')
+                {
+                    pos = std::min(text.find('>', header), size - 1) + 1;
+                    emit(header, pos, string_);
+                }
+            }
+        }
+
+        // directives are highlighted as a whole, except for comments, strings and keywords.
+        auto const code_style = preprocessor ? preprocessor_ : style_palette::default_id;
+        auto const line_end = [&]()
+        {
+            return line_state{context::code, preprocessor && continued, 0};
+        };
+
+        auto quoted = [&](std::size_t start, std::size_t quote) -> bool
+        {
+            auto end = find_closing(text, quote + 1, text[quote]);
+            if (end == npos)
+            {
+                emit(start, size, string_);
+                return false;
+            }
+            emit(start, end, string_);
+            pos = end;
+            return true;
+        };
+
+        while (pos < size)
+        {
+            auto const match = automaton.longest_match(text, pos, start);
+            auto const end = match.end;
+
+            switch (match.token)
+            {
+                case line_comment:
+                    emit(pos, size, comment_);
+                    return continued ? line_state{context::line_comment, preprocessor, 0} : line_state{};
+                case block_comment:
+                {
+                    auto close = text.find("*/", end);
+                    if (close == npos)
+                    {
+                        emit(pos, size, comment_);
+                        return {context::block_comment, preprocessor, 0};
+                    }
+                    emit(pos, close + 2, comment_);
+                    pos = close + 2;
+                    continue;
+                }
+                case string_quote:
+                    if (!quoted(pos, pos))
+                        return continued ? line_state{context::string, preprocessor, 0} : line_end();
+                    continue;
+                case character_quote:
+                    if (!quoted(pos, pos))
+                        return line_end();
+                    continue;
+                case number:
+                    emit(pos, end, number_);
+                    pos = end;
+                    continue;
+                case identifier:
+                    break;
+                default:
+                    emit(pos, end, code_style);
+                    add_brackets(pos, end);
+                    pos = end;
+                    continue;
+            }
+
+            auto word = text.substr(pos, end - pos);
+            if (end < size && text[end] == '"' && is_string_prefix(word))
+            {
+                if (word.back() != 'R')
+                {
+                    if (!quoted(pos, end))
+                        return continued ? line_state{context::string, preprocessor, 0} : line_end();
+                    continue;
+                }
+
+                // R"delimiter( ... )delimiter"
+                auto paren = text.find('(', end + 1);
+                if (paren != npos)
+                {
+                    auto delimiter = text.substr(end + 1, paren - end - 1);
+                    auto closing = ")" + std::string{delimiter} + "\"";
+                    auto close = text.find(closing, paren + 1);
+                    if (close == npos)
+                    {
+                        emit(pos, size, string_);
+                        return {context::raw_string, preprocessor, delimiter_id(delimiter)};
+                    }
+                    emit(pos, close + closing.size(), string_);
+                    pos = close + closing.size();
+                    continue;
+                }
+            }
+
+            if (end < size && text[end] == '\'' && (word == "L" || word == "u" || word == "U" || word == "u8"))
+            {
+                if (!quoted(pos, end))
+                    return line_end();
+                continue;
+            }
+
+            emit(pos, end, keywords.contains(word) ? keyword_ : code_style);
+            pos = end;
+        }
+        return line_end();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    c_style::line_state c_style::state_at(index_type line) const
+    {
+        return states_.at(static_cast <std::size_t> (line));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t c_style::relexed_lines() const
+    {
+        return relexed_;
+    }
+//#####################################################################################################################
+}
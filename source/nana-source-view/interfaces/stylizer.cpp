@@ -1,5 +1,47 @@
 #include <nana-source-view/interfaces/styler.hpp>
 
+#include <iterator>
+
 namespace nana_source_view
 {
+//#####################################################################################################################
+    std::string_view styler::line_text(index_type line) const
+    {
+        auto [begin, end] = store->line(line);
+        while (begin != end && (*(end - 1) == '\n' || *(end - 1) == '\r'))
+            --end;
+
+        if (begin == end)
+            return {};
+        return {&*begin, static_cast <std::size_t> (end - begin)};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <std::pair <styler::index_type, styler::index_type>> styler::on_edit(std::vector <edit_delta> const& deltas)
+    {
+        auto const groups = group_deltas(deltas);
+        auto const inserted = [](touched_lines const& group)
+        {
+            return static_cast <index_type> (group.new_end - group.new_begin) - static_cast <index_type> (group.old_end - group.old_begin);
+        };
+
+        unvisited_lines = 0;
+        for (auto const& group : groups)
+            unvisited_lines += inserted(group);
+
+        // groups are in order, so all lines in front of a group are already restyled in new line numbers.
+        std::vector <std::pair <index_type, index_type>> result;
+        for (auto group = std::begin(groups); group != std::end(groups); ++group)
+        {
+            unvisited_lines -= inserted(*group);
+            next_group = std::next(group) == std::end(groups)
+                ? std::numeric_limits <index_type>::max()
+                : static_cast <index_type> (std::next(group)->new_begin)
+            ;
+            on_multi_line_change(static_cast <index_type> (group->new_begin), static_cast <index_type> (group->new_end + 1));
+            result.push_back(restyled);
+        }
+        next_group = std::numeric_limits <index_type>::max();
+        return result;
+    }
+//#####################################################################################################################
 }
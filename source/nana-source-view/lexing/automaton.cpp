@@ -0,0 +1,414 @@
+#include <nana-source-view/lexing/automaton.hpp>
+#include <nana-source-view/lexing/scan.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+namespace nana_source_view::lexing
+{
+    namespace
+    {
+        constexpr std::size_t no_node = std::numeric_limits <std::size_t>::max();
+
+        std::bitset <256> byte_set(unsigned char low, unsigned char high)
+        {
+            std::bitset <256> set;
+            for (unsigned c = low; c <= high; ++c)
+                set.set(c);
+            return set;
+        }
+
+        std::bitset <256> byte_set(std::string_view chars)
+        {
+            std::bitset <256> set;
+            for (auto c : chars)
+                set.set(static_cast <unsigned char> (c));
+            return set;
+        }
+
+        /**
+         *  The set of \d, \w or \s, or none if c names no set.
+         */
+        std::bitset <256> escape_set(char c)
+        {
+            switch (c)
+            {
+                case 'd':
+                    return byte_set('0', '9');
+                case 's':
+                    return byte_set(" \t");
+                case 'w':
+                {
+                    std::bitset <256> set;
+                    for (unsigned b = 0; b != 256; ++b)
+                        set[b] = is_identifier_byte(static_cast <char> (b));
+                    return set;
+                }
+                case 't':
+                    return byte_set("\t");
+                case 'n':
+                    return byte_set("\n");
+                default:
+                    return byte_set(std::string_view{&c, 1});
+            }
+        }
+    }
+//#####################################################################################################################
+    /**
+     *  Translates a pattern into nodes, by recursive descent:
+     *  alternatives := sequence ('|' sequence)*
+     *  sequence := repetition*
+     *  repetition := atom ('*' | '+' | '?')*
+     *  atom := '(' alternatives ')' | '[' set ']' | '.' | '\' byte | byte
+     */
+    class automaton_builder::parser
+    {
+    public:
+        parser(automaton_builder& builder, std::string_view pattern)
+            : builder_{builder}
+            , pattern_{pattern}
+            , pos_{0}
+        {
+        }
+
+        fragment parse()
+        {
+            auto result = alternatives();
+            if (pos_ != pattern_.size())
+                fail("unexpected ')'");
+            return result;
+        }
+
+    private:
+        [[noreturn]] void fail(char const* what) const
+        {
+            throw std::invalid_argument(
+                "automaton_builder: " + std::string{what} + " at " + std::to_string(pos_) + " in " + std::string{pattern_}
+            );
+        }
+
+        bool at_end() const
+        {
+            return pos_ == pattern_.size();
+        }
+
+        fragment empty()
+        {
+            auto n = builder_.make_node();
+            return {n, n};
+        }
+
+        fragment bytes(std::bitset <256> const& set)
+        {
+            auto first = builder_.make_node();
+            auto last = builder_.make_node();
+            builder_.nodes_[first].bytes = set;
+            builder_.nodes_[first].next = last;
+            return {first, last};
+        }
+
+        void link(std::size_t from, std::size_t to)
+        {
+            builder_.nodes_[from].epsilon.push_back(to);
+        }
+
+        fragment alternatives()
+        {
+            auto result = sequence();
+            if (at_end() || pattern_[pos_] != '|')
+                return result;
+
+            auto first = builder_.make_node();
+            auto last = builder_.make_node();
+            link(first, result.first);
+            link(result.last, last);
+            while (!at_end() && pattern_[pos_] == '|')
+            {
+                ++pos_;
+                auto alternative = sequence();
+                link(first, alternative.first);
+                link(alternative.last, last);
+            }
+            return {first, last};
+        }
+
+        fragment sequence()
+        {
+            auto result = empty();
+            while (!at_end() && pattern_[pos_] != '|' && pattern_[pos_] != ')')
+            {
+                auto next = repetition();
+                link(result.last, next.first);
+                result.last = next.last;
+            }
+            return result;
+        }
+
+        fragment repetition()
+        {
+            auto result = atom();
+            while (!at_end() && (pattern_[pos_] == '*' || pattern_[pos_] == '+' || pattern_[pos_] == '?'))
+            {
+                auto const op = pattern_[pos_++];
+                auto first = builder_.make_node();
+                auto last = builder_.make_node();
+                link(first, result.first);
+                if (op != '+')
+                    link(first, last);
+                if (op != '?')
+                    link(result.last, result.first);
+                link(result.last, last);
+                result = {first, last};
+            }
+            return result;
+        }
+
+        fragment atom()
+        {
+            auto const c = pattern_[pos_++];
+            switch (c)
+            {
+                case '(':
+                {
+                    auto result = alternatives();
+                    if (at_end() || pattern_[pos_] != ')')
+                        fail("missing ')'");
+                    ++pos_;
+                    return result;
+                }
+                case '[':
+                    return bytes(set());
+                case '.':
+                    return bytes(std::bitset <256>{}.set());
+                case '\\':
+                    if (at_end())
+                        fail("dangling '\\'");
+                    return bytes(escape_set(pattern_[pos_++]));
+                case '*':
+                case '+':
+                case '?':
+                    fail("nothing to repeat");
+                default:
+                    return bytes(byte_set(std::string_view{&c, 1}));
+            }
+        }
+
+        std::bitset <256> set()
+        {
+            std::bitset <256> result;
+            auto const negated = !at_end() && pattern_[pos_] == '^';
+            if (negated)
+                ++pos_;
+
+            while (!at_end() && pattern_[pos_] != ']')
+            {
+                if (pattern_[pos_] == '\\')
+                {
+                    if (++pos_ == pattern_.size())
+                        fail("dangling '\\'");
+                    result |= escape_set(pattern_[pos_++]);
+                    continue;
+                }
+
+                auto const low = static_cast <unsigned char> (pattern_[pos_++]);
+                if (pos_ + 1 < pattern_.size() && pattern_[pos_] == '-' && pattern_[pos_ + 1] != ']')
+                {
+                    auto const high = static_cast <unsigned char> (pattern_[pos_ + 1]);
+                    if (high < low)
+                        fail("reversed range");
+                    result |= byte_set(low, high);
+                    pos_ += 2;
+                }
+                else
+                    result.set(low);
+            }
+            if (at_end())
+                fail("missing ']'");
+            ++pos_;
+
+            return negated ? ~result : result;
+        }
+
+    private:
+        automaton_builder& builder_;
+        std::string_view pattern_;
+        std::size_t pos_;
+    };
+//#####################################################################################################################
+    automaton::automaton()
+        : classes_{}
+        , class_count_{1}
+        , next_(1, dead)
+        , accepts_(1, no_token)
+        , starts_{}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    automaton::state_type automaton::start(std::size_t group) const
+    {
+        return starts_.at(group);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t automaton::state_count() const
+    {
+        return accepts_.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t automaton::class_count() const
+    {
+        return class_count_;
+    }
+//#####################################################################################################################
+    automaton_builder::automaton_builder()
+        : nodes_{}
+        , groups_{}
+        , patterns_{0}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t automaton_builder::make_node()
+    {
+        nodes_.push_back({{}, no_node, {}, automaton::no_token, 0});
+        return nodes_.size() - 1;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t automaton_builder::group()
+    {
+        groups_.push_back(make_node());
+        return groups_.size() - 1;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void automaton_builder::add(std::size_t group, std::string_view pattern, token_type token)
+    {
+        if (token == automaton::no_token)
+            throw std::invalid_argument("automaton_builder: no_token can not be matched");
+
+        // a failing pattern must not leave dangling nodes behind.
+        auto const node_count = nodes_.size();
+        try
+        {
+            auto const fragment = parser{*this, pattern}.parse();
+
+            std::vector <std::size_t> reachable{fragment.first};
+            closure(reachable);
+            if (std::binary_search(std::begin(reachable), std::end(reachable), fragment.last))
+                throw std::invalid_argument("automaton_builder: " + std::string{pattern} + " matches the empty text");
+
+            nodes_[fragment.last].accept = token;
+            nodes_[fragment.last].priority = patterns_++;
+            nodes_.at(groups_.at(group)).epsilon.push_back(fragment.first);
+        }
+        catch (...)
+        {
+            nodes_.resize(node_count);
+            throw;
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void automaton_builder::closure(std::vector <std::size_t>& nodes) const
+    {
+        std::vector <bool> seen(nodes_.size(), false);
+        for (auto n : nodes)
+            seen[n] = true;
+
+        for (std::size_t i = 0; i != nodes.size(); ++i)
+        {
+            for (auto next : nodes_[nodes[i]].epsilon)
+            {
+                if (!seen[next])
+                {
+                    seen[next] = true;
+                    nodes.push_back(next);
+                }
+            }
+        }
+        std::sort(std::begin(nodes), std::end(nodes));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    automaton automaton_builder::build() const
+    {
+        automaton result;
+
+        // bytes that no pattern tells apart share a class, refined by every byte set in use.
+        std::array <std::uint16_t, 256> classes{};
+        std::size_t class_count = 1;
+        for (auto const& n : nodes_)
+        {
+            if (n.next == no_node)
+                continue;
+
+            std::map <std::pair <std::uint16_t, bool>, std::uint16_t> split;
+            for (unsigned b = 0; b != 256; ++b)
+                classes[b] = split.emplace(std::make_pair(classes[b], n.bytes[b]), static_cast <std::uint16_t> (split.size())).first->second;
+            class_count = split.size();
+        }
+
+        std::array <unsigned char, 256> representatives{};
+        for (unsigned b = 256; b-- != 0;)
+        {
+            result.classes_[b] = static_cast <std::uint8_t> (classes[b]);
+            representatives[classes[b]] = static_cast <unsigned char> (b);
+        }
+        result.class_count_ = class_count;
+
+        // subset construction, state 0 is the empty set and dead.
+        std::map <std::vector <std::size_t>, automaton::state_type> states;
+        std::vector <std::vector <std::size_t>> pending;
+        auto state_of = [&](std::vector <std::size_t> set)
+        {
+            if (set.empty())
+                return automaton::dead;
+
+            closure(set);
+            auto iter = states.find(set);
+            if (iter != std::end(states))
+                return iter->second;
+
+            if (states.size() + 1 > std::numeric_limits <automaton::state_type>::max())
+                throw std::length_error("automaton_builder: too many states");
+
+            auto const id = static_cast <automaton::state_type> (states.size() + 1);
+            states.emplace(set, id);
+            pending.push_back(std::move(set));
+            return id;
+        };
+
+        result.next_.assign(class_count, automaton::dead);
+        result.accepts_.assign(1, automaton::no_token);
+        for (auto group : groups_)
+            result.starts_.push_back(state_of({group}));
+
+        for (std::size_t state = 1; state <= pending.size(); ++state)
+        {
+            auto const set = pending[state - 1];
+
+            auto accept = automaton::no_token;
+            auto priority = no_node;
+            for (auto n : set)
+            {
+                if (nodes_[n].accept != automaton::no_token && nodes_[n].priority < priority)
+                {
+                    accept = nodes_[n].accept;
+                    priority = nodes_[n].priority;
+                }
+            }
+            result.accepts_.push_back(accept);
+
+            result.next_.resize((state + 1) * class_count, automaton::dead);
+            for (std::size_t c = 0; c != class_count; ++c)
+            {
+                std::vector <std::size_t> moved;
+                for (auto n : set)
+                    if (nodes_[n].next != no_node && nodes_[n].bytes[representatives[c]])
+                        moved.push_back(nodes_[n].next);
+
+                auto const target = state_of(std::move(moved));
+                result.next_[state * class_count + c] = target;
+            }
+        }
+        return result;
+    }
+//#####################################################################################################################
+}
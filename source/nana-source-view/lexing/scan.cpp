@@ -0,0 +1,108 @@
+#include <nana-source-view/lexing/scan.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#   define NANA_SOURCE_VIEW_SSE2
+#   include <emmintrin.h>
+#endif
+
+namespace nana_source_view::lexing
+{
+    namespace
+    {
+#ifdef NANA_SOURCE_VIEW_SSE2
+        /**
+         *  Index of the lowest set bit.
+         */
+        unsigned lowest_bit(unsigned mask)
+        {
+#   if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast <unsigned> (index);
+#   else
+            return static_cast <unsigned> (__builtin_ctz(mask));
+#   endif
+        }
+
+        /**
+         *  Bytes in [low, high], signed comparison after shifting the range to start at -128.
+         */
+        __m128i in_range(__m128i bytes, char low, char high)
+        {
+            auto const bias = _mm_set1_epi8(static_cast <char> (-128 - low));
+            auto const shifted = _mm_add_epi8(bytes, bias);
+            return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast <char> (-128 + (high - low) + 1)));
+        }
+
+        /**
+         *  Runs find over 16 byte blocks. find returns a mask with a bit set for every byte that ends the search.
+         */
+        template <typename FunctionT>
+        std::size_t scan_blocks(std::string_view text, std::size_t pos, FunctionT&& find)
+        {
+            auto const* data = text.data();
+            for (; pos + 16 <= text.size(); pos += 16)
+            {
+                auto const bytes = _mm_loadu_si128(reinterpret_cast <__m128i const*> (data + pos));
+                auto const mask = static_cast <unsigned> (_mm_movemask_epi8(find(bytes)));
+                if (mask != 0)
+                    return pos + lowest_bit(mask);
+            }
+            return pos;
+        }
+#endif
+    }
+//#####################################################################################################################
+    std::size_t skip_identifier(std::string_view text, std::size_t pos)
+    {
+#ifdef NANA_SOURCE_VIEW_SSE2
+        pos = scan_blocks(text, pos, [](__m128i bytes)
+        {
+            // bytes >= 0x80 are negative.
+            auto identifier = _mm_cmplt_epi8(bytes, _mm_setzero_si128());
+            identifier = _mm_or_si128(identifier, in_range(bytes, 'a', 'z'));
+            identifier = _mm_or_si128(identifier, in_range(bytes, 'A', 'Z'));
+            identifier = _mm_or_si128(identifier, in_range(bytes, '0', '9'));
+            identifier = _mm_or_si128(identifier, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('_')));
+            return _mm_xor_si128(identifier, _mm_set1_epi8(static_cast <char> (0xFF)));
+        });
+#endif
+        while (pos < text.size() && is_identifier_byte(text[pos]))
+            ++pos;
+        return pos;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t skip_blanks(std::string_view text, std::size_t pos)
+    {
+#ifdef NANA_SOURCE_VIEW_SSE2
+        pos = scan_blocks(text, pos, [](__m128i bytes)
+        {
+            auto const blank = _mm_or_si128(
+                _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')),
+                _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t'))
+            );
+            return _mm_xor_si128(blank, _mm_set1_epi8(static_cast <char> (0xFF)));
+        });
+#endif
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t'))
+            ++pos;
+        return pos;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t find_either(std::string_view text, std::size_t pos, char first, char second)
+    {
+#ifdef NANA_SOURCE_VIEW_SSE2
+        pos = scan_blocks(text, pos, [first, second](__m128i bytes)
+        {
+            return _mm_or_si128(
+                _mm_cmpeq_epi8(bytes, _mm_set1_epi8(first)),
+                _mm_cmpeq_epi8(bytes, _mm_set1_epi8(second))
+            );
+        });
+#endif
+        while (pos < text.size() && text[pos] != first && text[pos] != second)
+            ++pos;
+        return pos;
+    }
+//#####################################################################################################################
+}
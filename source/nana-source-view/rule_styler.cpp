@@ -0,0 +1,153 @@
+#include <nana-source-view/rule_styler.hpp>
+
+#include <limits>
+#include <stdexcept>
+
+namespace nana_source_view::styles
+{
+//#####################################################################################################################
+    rule_style::rule_style(data_store const* store, rule_set rules)
+        : styler{store}
+        , automaton_{}
+        , actions_{}
+        , starts_{}
+        , scope_looks_{}
+        , scope_ids_{}
+        , single_line_{}
+        , scopes_{}
+        , relexed_{0}
+    {
+        if (rules.scopes.size() >= std::numeric_limits <scope_index>::max())
+            throw std::invalid_argument("rule_style: too many scopes");
+
+        lexing::automaton_builder builder;
+        actions_.push_back({0, std::nullopt, style_palette::default_id});
+
+        auto add = [&](std::size_t group, std::string const& pattern, scope_index next_scope, std::optional <style> const& look)
+        {
+            if (actions_.size() > std::numeric_limits <lexing::automaton::token_type>::max())
+                throw std::invalid_argument("rule_style: too many rules");
+
+            builder.add(group, pattern, static_cast <lexing::automaton::token_type> (actions_.size()));
+            actions_.push_back({next_scope, look, style_palette::default_id});
+        };
+
+        // outside of all scopes: tokens and the beginnings of all scopes.
+        auto const outside = builder.group();
+        scope_looks_.push_back(style{});
+        single_line_.push_back(false);
+        for (auto const& token : rules.tokens)
+            add(outside, token.pattern, 0, token.look);
+        for (std::size_t i = 0; i != rules.scopes.size(); ++i)
+            add(outside, rules.scopes[i].begin, static_cast <scope_index> (i + 1), rules.scopes[i].look);
+
+        // within a scope: its tokens and its end.
+        for (std::size_t i = 0; i != rules.scopes.size(); ++i)
+        {
+            auto const& scope = rules.scopes[i];
+            auto const group = builder.group();
+            auto const index = static_cast <scope_index> (i + 1);
+            for (auto const& token : scope.tokens)
+                add(group, token.pattern, index, token.look ? token.look : scope.look);
+            if (!scope.end.empty())
+                add(group, scope.end, 0, scope.look);
+
+            scope_looks_.push_back(scope.look);
+            single_line_.push_back(scope.single_line || scope.end.empty());
+        }
+
+        automaton_ = builder.build();
+        for (std::size_t group = 0; group != scope_looks_.size(); ++group)
+            starts_.push_back(automaton_.start(group));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void rule_style::initialize()
+    {
+        palette.clear();
+        scope_ids_.assign(1, style_palette::default_id);
+        for (std::size_t i = 1; i < scope_looks_.size(); ++i)
+            scope_ids_.push_back(palette.intern(scope_looks_[i]));
+        for (auto& a : actions_)
+            a.id = a.look ? palette.intern(*a.look) : style_palette::default_id;
+
+        auto const line_count = store->line_count();
+        styles.reset(line_count);
+        brackets.reset(line_count);
+        scopes_.assign(line_count + 1, 0);
+
+        on_multi_line_change(0, static_cast <index_type> (line_count));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void rule_style::on_multi_line_change(index_type begin, index_type end)
+    {
+        relexed_ = relex(scopes_, begin, end, [this](std::string_view text, auto scope, auto& ranges, auto& found)
+        {
+            return lex_line(text, scope, ranges, found);
+        });
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    rule_style::scope_index rule_style::lex_line
+    (
+        std::string_view text,
+        scope_index scope,
+        std::vector <style_range>& ranges,
+        std::vector <bracket>& found
+    ) const
+    {
+        auto const first_range = ranges.size();
+        auto emit = [&](std::size_t from, std::size_t to, style_id id)
+        {
+            if (id == style_palette::default_id)
+                return;
+
+            if (ranges.size() > first_range && ranges.back().id == id && ranges.back().start + ranges.back().length == from)
+                ranges.back().length += static_cast <std::uint32_t> (to - from);
+            else
+                ranges.push_back({static_cast <std::uint32_t> (from), static_cast <std::uint32_t> (to - from), id});
+        };
+
+        // brackets count in unstyled text outside of scopes only.
+        auto add_brackets = [&](std::size_t from, std::size_t to)
+        {
+            if (scope != 0)
+                return;
+            for (; from != to; ++from)
+                if (bracket_index::is_bracket(text[from]))
+                    found.push_back({static_cast <std::uint32_t> (from), text[from]});
+        };
+
+        std::size_t pos = 0;
+        while (pos < text.size())
+        {
+            auto const match = automaton_.longest_match(text, pos, starts_[scope]);
+            if (match.token == lexing::automaton::no_token)
+            {
+                // no rule matches here, the byte and all behind that can not start a match belong to the scope.
+                auto const next = automaton_.skip_dead(text, pos + 1, starts_[scope]);
+                emit(pos, next, scope_ids_[scope]);
+                add_brackets(pos, next);
+                pos = next;
+                continue;
+            }
+
+            auto const& a = actions_[match.token];
+            emit(pos, match.end, a.look ? a.id : scope_ids_[scope]);
+            if (!a.look)
+                add_brackets(pos, match.end);
+            scope = a.next_scope;
+            pos = match.end;
+        }
+        return single_line_[scope] ? 0 : scope;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    rule_style::scope_index rule_style::scope_at(index_type line) const
+    {
+        return scopes_.at(static_cast <std::size_t> (line));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t rule_style::relexed_lines() const
+    {
+        return relexed_;
+    }
+//#####################################################################################################################
+}
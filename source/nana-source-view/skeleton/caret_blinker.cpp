@@ -0,0 +1,169 @@
+#include <nana-source-view/skeleton/caret_blinker.hpp>
+#include <nana-source-view/skeleton/text_renderer.hpp>
+
+namespace nana_source_view::skeletons
+{
+    namespace
+    {
+        /// Width of a caret in pixels.
+        constexpr unsigned caret_width = 2;
+    }
+//#####################################################################################################################
+    caret_blinker::caret_blinker(data_store const* store)
+        : store_{store}
+        , color_{nana::colors::white}
+        , interval_{530}
+        , typing_pause_{700}
+        , idle_timeout_{15'000}
+        , last_activity_{}
+        , areas_{}
+        , saved_{}
+        , saved_sink_{nullptr}
+        , focused_{false}
+        , shown_{true}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void caret_blinker::color(nana::color const& color)
+    {
+        color_ = color;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void caret_blinker::timing
+    (
+        std::chrono::milliseconds interval,
+        std::chrono::milliseconds typing_pause,
+        std::chrono::milliseconds idle_timeout
+    )
+    {
+        interval_ = interval;
+        typing_pause_ = typing_pause;
+        idle_timeout_ = idle_timeout;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::chrono::milliseconds caret_blinker::interval() const
+    {
+        return interval_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void caret_blinker::render(text_renderer const& layout, paint_sink& sink, bool focused, clock_type::time_point now)
+    {
+        // saves of another sink died with it.
+        if (saved_ && saved_sink_ == &sink)
+            sink.release_areas(*saved_);
+        saved_.reset();
+
+        focused_ = focused;
+        areas_.clear();
+        if (!focused_)
+            return;
+
+        auto const [first, last] = layout.visible_lines();
+        if (first >= last)
+            return;
+
+        auto const line_count = static_cast <index_type> (store_->line_count());
+        auto const document_end = static_cast <index_type> (store_->size());
+        auto line_start = [&](index_type line)
+        {
+            return line < line_count ? store_->index_from_line(line) : document_end;
+        };
+
+        auto const visible_end = line_start(last);
+        auto const area = layout.text_area();
+        auto const line_height = layout.line_height();
+
+        text_renderer::x_cursor cursor{};
+        auto line = first;
+        auto caret = store_->caret_lower_bound(line_start(first));
+        for (auto const caret_end = store_->caret_end(); caret != caret_end; ++caret)
+        {
+            // a caret at the very end of the document sits on the last line.
+            if (caret->offset > visible_end || (caret->offset == visible_end && last != line_count))
+                break;
+
+            // carets in folded lines are not shown.
+            line = std::max(line, store_->line_from_index(caret->offset));
+            if (layout.hidden(line))
+                continue;
+
+            // the first visible line may be scrolled into, when it is wrapped.
+            auto const position = layout.position(sink, line, caret->offset, &cursor);
+            if (position.y + static_cast <int> (line_height) <= area.y)
+                continue;
+
+            areas_.emplace_back(position.x, position.y, caret_width, line_height);
+        }
+
+        if (areas_.empty())
+            return;
+
+        saved_ = sink.save_areas(areas_);
+        saved_sink_ = &sink;
+
+        if (now - last_activity_ < typing_pause_ || now - last_activity_ >= idle_timeout_)
+            shown_ = true;
+        if (shown_)
+            paint(sink);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool caret_blinker::tick(paint_sink& sink, clock_type::time_point now)
+    {
+        if (!saved_ || saved_sink_ != &sink)
+            return false;
+
+        // solid while typing and after the editor went idle.
+        auto show = !shown_;
+        if (now - last_activity_ < typing_pause_ || now - last_activity_ >= idle_timeout_)
+            show = true;
+
+        if (show == shown_)
+            return false;
+
+        shown_ = show;
+        paint(sink);
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool caret_blinker::activity(paint_sink& sink, clock_type::time_point now)
+    {
+        last_activity_ = now;
+        if (shown_)
+            return false;
+
+        shown_ = true;
+        if (!saved_ || saved_sink_ != &sink)
+            return false;
+
+        paint(sink);
+        return true;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool caret_blinker::blinking(clock_type::time_point now) const
+    {
+        return saved_.has_value() && now - last_activity_ < idle_timeout_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <nana::rectangle> const& caret_blinker::areas() const
+    {
+        return areas_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool caret_blinker::shown() const
+    {
+        return shown_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void caret_blinker::paint(paint_sink& sink)
+    {
+        if (!shown_)
+        {
+            sink.restore_areas(*saved_);
+            return;
+        }
+
+        for (auto const& area : areas_)
+            sink.rectangle(area, color_, true);
+    }
+//#####################################################################################################################
+}
@@ -0,0 +1,265 @@
+#include <nana-source-view/skeleton/minimap.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+namespace nana_source_view::skeletons
+{
+    namespace
+    {
+        /// Height of a downsampled row in pixels.
+        constexpr unsigned row_height = 2;
+
+        /// Columns a tab advances to.
+        constexpr unsigned tab_width = 4;
+
+        std::uint16_t clamp16(std::size_t value)
+        {
+            return static_cast <std::uint16_t> (std::min <std::size_t> (value, std::numeric_limits <std::uint16_t>::max()));
+        }
+    }
+//#####################################################################################################################
+    minimap::range_summary minimap::summary_traits::identity()
+    {
+        return {0, 0, std::numeric_limits <std::uint16_t>::max(), 0, 0, 0};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    minimap::range_summary minimap::summary_traits::summarize(line_summary const& line)
+    {
+        if (line.length == 0)
+            return {1, 0, std::numeric_limits <std::uint16_t>::max(), 0, 0, 0};
+        return {1, 1, line.indent, clamp16(std::size_t{line.indent} + line.length), line.length, line.style_class};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    minimap::range_summary minimap::summary_traits::combine(range_summary const& lhs, range_summary const& rhs)
+    {
+        // of equally long lines, the last one decides the style.
+        auto const& longest = rhs.filled != 0 && rhs.longest >= lhs.longest ? rhs : lhs;
+        return {
+            lhs.lines + rhs.lines,
+            lhs.filled + rhs.filled,
+            std::min(lhs.indent, rhs.indent),
+            std::max(lhs.extent, rhs.extent),
+            longest.longest,
+            longest.style_class
+        };
+    }
+//#####################################################################################################################
+    minimap::minimap(data_store const* store)
+        : store_{store}
+        , summaries_{}
+        , class_colors_{static_cast <nana::color_rgb> (0xA0A0A0)}
+        , bgcolor_{static_cast <nana::color_rgb> (0x252525)}
+        , rows_{}
+        , row_scale_{0}
+        , dirty_begin_{0}
+        , dirty_end_{0}
+    {
+        rebuild();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void minimap::rebuild()
+    {
+        auto const line_count = store_->line_count();
+
+        std::vector <line_summary> summaries(line_count);
+        for (std::size_t line = 0; line != line_count; ++line)
+            summaries[line] = summarize(static_cast <index_type> (line));
+        summaries_.splice(0, summaries_.size(), std::begin(summaries), std::end(summaries));
+
+        invalidate(0, line_count);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    minimap::line_summary minimap::summarize(index_type line) const
+    {
+        auto [begin, end] = store_->line(line);
+
+        std::size_t indent = 0;
+        for (; begin != end && (*begin == ' ' || *begin == '\t'); ++begin)
+            indent = *begin == '\t' ? (indent / tab_width + 1) * tab_width : indent + 1;
+
+        while (begin != end && (*(end - 1) == '\n' || *(end - 1) == '\r'))
+            --end;
+
+        // code points, continuation bytes do not count.
+        auto length = std::count_if(begin, end, [](auto c)
+        {
+            return (c & 0b1100'0000) != 0b1000'0000;
+        });
+
+        return {clamp16(indent), clamp16(static_cast <std::size_t> (length)), 0};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void minimap::on_edit(std::vector <edit_delta> const& deltas)
+    {
+        if (deltas.empty())
+            return;
+
+        // groups are in new line numbers, which the lines in front of them already have.
+        auto const groups = group_deltas(deltas);
+        std::vector <line_summary> summaries;
+        for (auto const& group : groups)
+        {
+            summaries.clear();
+            for (auto line = group.new_begin; line <= group.new_end; ++line)
+                summaries.push_back(summarize(static_cast <index_type> (line)));
+            summaries_.splice(group.new_begin, group.new_begin + group.old_end - group.old_begin + 1, std::begin(summaries), std::end(summaries));
+        }
+
+        // with the line count changed, all rows behind the first edit moved.
+        auto const same_shape = std::all_of(std::begin(groups), std::end(groups), [](auto const& group)
+        {
+            return group.old_end - group.old_begin == group.new_end - group.new_begin;
+        });
+        if (!same_shape)
+        {
+            invalidate(groups.front().new_begin, summaries_.size());
+            return;
+        }
+        for (auto const& group : groups)
+            invalidate(group.new_begin, group.new_end + 1);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void minimap::restyle(styler& sty, index_type begin, index_type end)
+    {
+        // style classes are the ids of the palette, 0 stays the unstyled text color.
+        auto const& palette = sty.get_palette();
+        class_colors_.resize(std::max <std::size_t> (palette.size(), 1));
+        for (std::size_t id = 1; id < palette.size(); ++id)
+            class_colors_[id] = palette[static_cast <style_id> (id)].fgcolor;
+
+        end = std::min(end, static_cast <index_type> (summaries_.size()));
+        if (begin >= end)
+            return;
+
+        // replaced in one splice, restyling the whole document is linear.
+        auto summaries = summaries_.values(static_cast <std::size_t> (begin), static_cast <std::size_t> (end));
+        for (auto line = begin; line < end; ++line)
+        {
+            // sum up the covered bytes per class and take the largest.
+            std::vector <std::pair <style_id, std::int64_t>> coverage;
+            for (auto const& range : sty.styles_on_line(line))
+            {
+                auto entry = std::find_if(std::begin(coverage), std::end(coverage), [&range](auto const& e)
+                {
+                    return e.first == range.id;
+                });
+                if (entry == std::end(coverage))
+                    coverage.emplace_back(range.id, range.length);
+                else
+                    entry->second += range.length;
+            }
+
+            auto dominant = std::max_element(std::begin(coverage), std::end(coverage), [](auto const& lhs, auto const& rhs)
+            {
+                return lhs.second < rhs.second;
+            });
+            summaries[static_cast <std::size_t> (line - begin)].style_class = dominant == std::end(coverage) ? 0 : dominant->first;
+        }
+        summaries_.splice(static_cast <std::size_t> (begin), static_cast <std::size_t> (end), std::begin(summaries), std::end(summaries));
+        invalidate(static_cast <std::size_t> (begin), static_cast <std::size_t> (end));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void minimap::colors(nana::color const& fgcolor, nana::color const& bgcolor)
+    {
+        class_colors_.front() = fgcolor;
+        bgcolor_ = bgcolor;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    minimap::line_summary const& minimap::summary(index_type line) const
+    {
+        if (line < 0 || static_cast <std::size_t> (line) >= summaries_.size())
+            throw std::out_of_range("minimap: no such line");
+        return summaries_[static_cast <std::size_t> (line)];
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t minimap::lines_per_row(std::size_t row_count) const
+    {
+        if (row_count == 0)
+            return 1;
+        return std::max <std::size_t> ((summaries_.size() + row_count - 1) / row_count, 1);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void minimap::invalidate(std::size_t begin, std::size_t end)
+    {
+        if (dirty_begin_ >= dirty_end_)
+        {
+            dirty_begin_ = begin;
+            dirty_end_ = end;
+            return;
+        }
+        dirty_begin_ = std::min(dirty_begin_, begin);
+        dirty_end_ = std::max(dirty_end_, end);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void minimap::update_rows(std::size_t row_count)
+    {
+        auto const scale = lines_per_row(row_count);
+        auto const needed = (summaries_.size() + scale - 1) / scale;
+        if (scale != row_scale_ || rows_.size() != needed)
+        {
+            row_scale_ = scale;
+            rows_.resize(needed);
+            invalidate(0, summaries_.size());
+        }
+
+        if (dirty_begin_ >= dirty_end_)
+            return;
+
+        auto const last_row = std::min((dirty_end_ + scale - 1) / scale, rows_.size());
+        for (auto r = dirty_begin_ / scale; r < last_row; ++r)
+        {
+            auto const begin = r * scale;
+            auto const end = std::min(begin + scale, summaries_.size());
+
+            auto const lines = summaries_.summary(begin, end);
+            rows_[r] = {
+                lines.filled == 0 ? std::uint16_t{0} : lines.indent,
+                lines.extent,
+                lines.style_class,
+                static_cast <std::uint8_t> (lines.filled * 255 / (end - begin))
+            };
+        }
+
+        dirty_begin_ = 0;
+        dirty_end_ = 0;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void minimap::render(paint_sink& sink, nana::rectangle const& area, std::pair <index_type, index_type> visible_lines)
+    {
+        sink.rectangle(area, bgcolor_, true);
+        if (area.empty())
+            return;
+
+        update_rows(area.height / row_height);
+
+        auto y = area.y;
+        for (auto const& r : rows_)
+        {
+            if (r.density != 0 && r.indent < area.width)
+            {
+                auto const width = std::min <unsigned> (r.extent - r.indent, area.width - r.indent);
+                auto const opacity = 0.35 + 0.65 * r.density / 255.;
+                sink.rectangle(
+                    {area.x + r.indent, y, std::max(width, 1u), row_height},
+                    class_colors_[r.style_class].blend(bgcolor_, opacity),
+                    true
+                );
+            }
+            y += static_cast <int> (row_height);
+        }
+
+        // frame the part of the document that is visible in the text area.
+        auto const scale = static_cast <index_type> (row_scale_);
+        auto const top = static_cast <int> (visible_lines.first / scale * row_height);
+        auto const bottom = static_cast <int> ((visible_lines.second + scale - 1) / scale * row_height);
+        sink.rectangle(
+            {area.x, area.y + top, area.width, static_cast <unsigned> (std::max(bottom - top, static_cast <int> (row_height)))},
+            class_colors_.front(),
+            false
+        );
+    }
+//#####################################################################################################################
+}
@@ -0,0 +1,320 @@
+#include <nana-source-view/skeleton/paint_sink.hpp>
+
+#include <algorithm>
+
+namespace nana_source_view::skeletons
+{
+    namespace
+    {
+        /**
+         *  Splits a utf8 string into its code points.
+         */
+        std::vector <std::string_view> split_code_points(std::string_view text)
+        {
+            std::vector <std::string_view> result;
+            for (std::size_t i = 0; i < text.size();)
+            {
+                auto length = std::size_t{1};
+                while (i + length < text.size() && (text[i + length] & 0b1100'0000) == 0b1000'0000)
+                    ++length;
+
+                result.push_back(text.substr(i, length));
+                i += length;
+            }
+            return result;
+        }
+    }
+//#####################################################################################################################
+    graphics_paint_sink::graphics_paint_sink(graph_reference graph)
+        : graph_{graph}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void graphics_paint_sink::typeface(nana::paint::font const& font)
+    {
+        graph_.typeface(font);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    nana::size graphics_paint_sink::text_extent_size(std::string_view text) const
+    {
+        return graph_.text_extent_size(text);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void graphics_paint_sink::rectangle(nana::rectangle const& rect, nana::color const& color, bool solid)
+    {
+        graph_.rectangle(rect, solid, color);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void graphics_paint_sink::line(nana::point const& from, nana::point const& to, nana::color const& color)
+    {
+        graph_.line(from, to, color);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void graphics_paint_sink::string(nana::point const& pos, std::string_view text, nana::color const& color)
+    {
+        graph_.string(pos, std::string{text}, color);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    paint_sink::glyph_atlas graphics_paint_sink::make_atlas
+    (
+        std::string_view glyphs,
+        nana::color const& fgcolor,
+        nana::color const& bgcolor
+    )
+    {
+        auto code_points = split_code_points(glyphs);
+
+        nana::size cell{};
+        for (auto const& glyph : code_points)
+        {
+            auto extent = graph_.text_extent_size(glyph);
+            cell.width = std::max(cell.width, extent.width);
+            cell.height = std::max(cell.height, extent.height);
+        }
+
+        auto atlas = std::make_unique <nana::paint::graphics> (
+            nana::size{std::max(cell.width * static_cast <unsigned> (code_points.size()), 1u), std::max(cell.height, 1u)}
+        );
+        atlas->typeface(graph_.typeface());
+        atlas->rectangle(true, bgcolor);
+
+        int x = 0;
+        for (auto const& glyph : code_points)
+        {
+            atlas->string({x, 0}, std::string{glyph}, fgcolor);
+            x += static_cast <int> (cell.width);
+        }
+
+        auto slot = std::find(std::begin(atlases_), std::end(atlases_), nullptr);
+        if (slot == std::end(atlases_))
+        {
+            atlases_.push_back(std::move(atlas));
+            return {atlases_.size() - 1, cell};
+        }
+        *slot = std::move(atlas);
+        return {static_cast <std::size_t> (std::distance(std::begin(atlases_), slot)), cell};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void graphics_paint_sink::blit_glyph(glyph_atlas const& atlas, std::size_t index, nana::point const& pos)
+    {
+        graph_.bitblt(
+            nana::rectangle{pos, atlas.cell},
+            *atlases_[atlas.id],
+            nana::point{static_cast <int> (index * atlas.cell.width), 0}
+        );
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void graphics_paint_sink::release_atlas(glyph_atlas const& atlas)
+    {
+        atlases_[atlas.id].reset();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t graphics_paint_sink::save_areas(std::vector <nana::rectangle> const& areas)
+    {
+        nana::size packed{};
+        for (auto const& area : areas)
+        {
+            packed.width += area.width;
+            packed.height = std::max(packed.height, area.height);
+        }
+
+        saved_areas save{
+            std::make_unique <nana::paint::graphics> (nana::size{std::max(packed.width, 1u), std::max(packed.height, 1u)}),
+            areas
+        };
+
+        int x = 0;
+        for (auto const& area : areas)
+        {
+            save.pixels->bitblt(nana::rectangle{x, 0, area.width, area.height}, graph_, nana::point{area.x, area.y});
+            x += static_cast <int> (area.width);
+        }
+
+        auto slot = std::find_if(std::begin(saves_), std::end(saves_), [](auto const& s)
+        {
+            return !s.pixels;
+        });
+        if (slot == std::end(saves_))
+        {
+            saves_.push_back(std::move(save));
+            return saves_.size() - 1;
+        }
+        *slot = std::move(save);
+        return static_cast <std::size_t> (std::distance(std::begin(saves_), slot));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void graphics_paint_sink::restore_areas(std::size_t id)
+    {
+        auto const& save = saves_[id];
+
+        int x = 0;
+        for (auto const& area : save.areas)
+        {
+            graph_.bitblt(area, *save.pixels, nana::point{x, 0});
+            x += static_cast <int> (area.width);
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void graphics_paint_sink::release_areas(std::size_t id)
+    {
+        saves_[id] = {};
+    }
+//#####################################################################################################################
+    recording_paint_sink::recording_paint_sink(nana::size const& glyph_size, bool record_commands)
+        : glyph_size_{glyph_size}
+        , record_commands_{record_commands}
+        , stats_{}
+        , commands_{}
+        , atlases_{}
+        , saves_{}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void recording_paint_sink::typeface(nana::paint::font const&)
+    {
+        ++stats_.typeface_changes;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    nana::size recording_paint_sink::text_extent_size(std::string_view text) const
+    {
+        ++stats_.measurements;
+        return measure(text);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    nana::size recording_paint_sink::measure(std::string_view text) const
+    {
+        // every code point is one glyph, continuation bytes do not count.
+        auto code_points = std::count_if(std::begin(text), std::end(text), [](char c)
+        {
+            return (c & 0b1100'0000) != 0b1000'0000;
+        });
+
+        return {static_cast <unsigned> (code_points) * glyph_size_.width, glyph_size_.height};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void recording_paint_sink::rectangle(nana::rectangle const& rect, nana::color const& color, bool)
+    {
+        ++stats_.draw_calls;
+        ++stats_.rectangles;
+
+        if (record_commands_)
+            commands_.push_back({command_kind::rectangle, rect, color, {}});
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void recording_paint_sink::line(nana::point const& from, nana::point const& to, nana::color const& color)
+    {
+        ++stats_.draw_calls;
+        ++stats_.lines;
+
+        if (record_commands_)
+        {
+            commands_.push_back({
+                command_kind::line,
+                nana::rectangle{
+                    from.x,
+                    from.y,
+                    static_cast <unsigned> (to.x - from.x),
+                    static_cast <unsigned> (to.y - from.y)
+                },
+                color,
+                {}
+            });
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void recording_paint_sink::string(nana::point const& pos, std::string_view text, nana::color const& color)
+    {
+        ++stats_.draw_calls;
+        ++stats_.text_runs;
+        stats_.text_bytes += text.size();
+
+        if (record_commands_)
+            commands_.push_back({command_kind::string, nana::rectangle{pos, measure(text)}, color, std::string{text}});
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    paint_sink::glyph_atlas recording_paint_sink::make_atlas
+    (
+        std::string_view glyphs,
+        nana::color const&,
+        nana::color const&
+    )
+    {
+        ++stats_.atlases_made;
+
+        std::vector <std::string> cells;
+        for (auto const& glyph : split_code_points(glyphs))
+            cells.emplace_back(glyph);
+
+        auto slot = std::find(std::begin(atlases_), std::end(atlases_), std::nullopt);
+        if (slot == std::end(atlases_))
+        {
+            atlases_.push_back(std::move(cells));
+            return {atlases_.size() - 1, glyph_size_};
+        }
+        *slot = std::move(cells);
+        return {static_cast <std::size_t> (std::distance(std::begin(atlases_), slot)), glyph_size_};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void recording_paint_sink::blit_glyph(glyph_atlas const& atlas, std::size_t index, nana::point const& pos)
+    {
+        ++stats_.draw_calls;
+        ++stats_.blits;
+
+        if (record_commands_)
+            commands_.push_back({command_kind::blit, nana::rectangle{pos, atlas.cell}, {}, (*atlases_[atlas.id])[index]});
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void recording_paint_sink::release_atlas(glyph_atlas const& atlas)
+    {
+        ++stats_.atlases_released;
+        atlases_[atlas.id].reset();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t recording_paint_sink::save_areas(std::vector <nana::rectangle> const& areas)
+    {
+        stats_.areas_saved += areas.size();
+
+        auto slot = std::find(std::begin(saves_), std::end(saves_), std::nullopt);
+        if (slot == std::end(saves_))
+        {
+            saves_.push_back(areas);
+            return saves_.size() - 1;
+        }
+        *slot = areas;
+        return static_cast <std::size_t> (std::distance(std::begin(saves_), slot));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void recording_paint_sink::restore_areas(std::size_t id)
+    {
+        for (auto const& area : *saves_[id])
+        {
+            ++stats_.draw_calls;
+            ++stats_.areas_restored;
+
+            if (record_commands_)
+                commands_.push_back({command_kind::restore, area, {}, {}});
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void recording_paint_sink::release_areas(std::size_t id)
+    {
+        saves_[id].reset();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    recording_paint_sink::statistics const& recording_paint_sink::stats() const
+    {
+        return stats_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <recording_paint_sink::command> const& recording_paint_sink::commands() const
+    {
+        return commands_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void recording_paint_sink::reset()
+    {
+        stats_ = {};
+        commands_.clear();
+    }
+//#####################################################################################################################
+}
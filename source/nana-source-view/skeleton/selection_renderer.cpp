@@ -0,0 +1,162 @@
+#include <nana-source-view/skeleton/selection_renderer.hpp>
+#include <nana-source-view/skeleton/text_renderer.hpp>
+
+#include <algorithm>
+
+namespace nana_source_view::skeletons
+{
+//#####################################################################################################################
+    selection_renderer::selection_renderer(data_store const* store)
+        : store_{store}
+        , color_{static_cast <nana::color_rgb> (0x3399FF)}
+        , spans_{}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void selection_renderer::color(nana::color const& color)
+    {
+        color_ = color;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void selection_renderer::add_span(int y, int left, int right, unsigned height)
+    {
+        if (!spans_.empty())
+        {
+            auto& previous = spans_.back();
+            if (previous.y == y && left <= previous.right())
+            {
+                previous.width = static_cast <unsigned> (std::max(right, previous.right()) - previous.x);
+                return;
+            }
+        }
+        spans_.emplace_back(left, y, static_cast <unsigned> (std::max(right - left, 0)), height);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    selection_renderer::index_type selection_renderer::line_start(index_type line) const
+    {
+        return line < static_cast <index_type> (store_->line_count()) ? store_->index_from_line(line) : static_cast <index_type> (store_->size());
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    selection_renderer::sweep selection_renderer::begin_sweep(text_renderer const& layout)
+    {
+        spans_.clear();
+
+        auto const [first, last] = layout.visible_lines();
+        if (first >= last)
+            return {first, last, 0, 0, first};
+        return {first, last, line_start(first), line_start(last), first};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    template <typename CursorT>
+    void selection_renderer::add_range
+    (
+        text_renderer const& layout,
+        paint_sink& sink,
+        sweep& state,
+        CursorT& cursor,
+        index_type begin,
+        index_type end
+    )
+    {
+        begin = std::max(begin, state.visible_begin);
+        end = std::min(end, state.visible_end);
+        if (begin >= end)
+            return;
+
+        auto const area = layout.text_area();
+        auto const line_height = layout.line_height();
+
+        // lines folded away are jumped over, not walked through.
+        auto& line = state.line;
+        line = std::max(line, store_->line_from_index(begin));
+        if (layout.hidden(line))
+            line = layout.next_line(line);
+
+        for (; line < state.last; line = layout.next_line(line))
+        {
+            auto const next_line = line_start(line + 1);
+
+            auto [text_begin, text_end] = store_->line(line);
+            while (text_begin != text_end && (*(text_end - 1) == '\n' || *(text_end - 1) == '\r'))
+                --text_end;
+            auto const content_end = next_line - static_cast <index_type> (store_->line(line).second - text_end);
+
+            auto const span_begin = std::max(begin, line_start(line));
+            auto const span_end = std::min(end, next_line);
+
+            // a span per row of a wrapped line. The last row also holds the line break.
+            auto const& points = layout.wrap_points(line);
+            auto y = layout.line_top(line);
+            for (std::size_t row = 0; row <= points.size(); ++row, y += static_cast <int> (line_height))
+            {
+                auto const last_row = row == points.size();
+                auto const row_begin = line_start(line) + (row == 0 ? 0 : points[row - 1]);
+                auto const row_end = last_row ? content_end : line_start(line) + points[row];
+                if (span_end <= row_begin || span_begin >= (last_row ? next_line : row_end))
+                    continue;
+
+                auto const left = layout.offset_x(sink, line, std::max(std::min(span_begin, content_end), row_begin), &cursor);
+                auto right = layout.offset_x(sink, line, std::min(span_end, row_end), &cursor, !last_row);
+
+                // a selected line break is shown as one glyph behind the text.
+                if (last_row && span_end > content_end)
+                    right += static_cast <int> (layout.glyph_width());
+
+                if (y + static_cast <int> (line_height) > area.y)
+                    add_span(y, left, right, line_height);
+            }
+
+            if (end <= next_line)
+                break;
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <nana::rectangle> const& selection_renderer::collect(text_renderer const& layout, paint_sink& sink)
+    {
+        auto state = begin_sweep(layout);
+        if (state.first >= state.last)
+            return spans_;
+
+        // selections do not overlap, so only the caret in front of the view can select into it from above.
+        auto caret = store_->caret_lower_bound(state.visible_begin);
+        if (caret != store_->caret_begin())
+            --caret;
+
+        text_renderer::x_cursor cursor{};
+        for (auto const caret_end = store_->caret_end(); caret != caret_end; ++caret)
+        {
+            if (caret->selection_begin() >= state.visible_end)
+                break;
+            add_range(layout, sink, state, cursor, caret->selection_begin(), caret->selection_end());
+        }
+        return spans_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <nana::rectangle> const& selection_renderer::collect
+    (
+        text_renderer const& layout,
+        paint_sink& sink,
+        std::vector <anchored_range> const& ranges
+    )
+    {
+        auto state = begin_sweep(layout);
+        if (state.first >= state.last)
+            return spans_;
+
+        text_renderer::x_cursor cursor{};
+        for (auto const& range : ranges)
+        {
+            if (range.begin >= state.visible_end)
+                break;
+            add_range(layout, sink, state, cursor, range.begin, range.end);
+        }
+        return spans_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void selection_renderer::render(text_renderer const& layout, paint_sink& sink)
+    {
+        for (auto const& span : collect(layout, sink))
+            sink.rectangle(span, color_, true);
+    }
+//#####################################################################################################################
+}
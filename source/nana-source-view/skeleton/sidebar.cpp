@@ -0,0 +1,135 @@
+#include <nana-source-view/skeleton/sidebar.hpp>
+
+namespace nana_source_view::skeletons
+{
+    namespace
+    {
+        /// Free space left and right of the line numbers in pixels.
+        constexpr unsigned gutter_padding = 6;
+    }
+//#####################################################################################################################
+    sidebar::sidebar(data_store const* store)
+        : store_{store}
+        , font_{}
+        , fgcolor_{static_cast <nana::color_rgb> (0x858585)}
+        , bgcolor_{static_cast <nana::color_rgb> (0x282828)}
+        , atlas_{}
+        , atlas_sink_{nullptr}
+        , digits_{0}
+        , width_{0}
+    {
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    sidebar::~sidebar()
+    {
+        release();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void sidebar::font(nana::paint::font const& font)
+    {
+        font_ = font;
+        release();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void sidebar::colors(nana::color const& fgcolor, nana::color const& bgcolor)
+    {
+        fgcolor_ = fgcolor;
+        bgcolor_ = bgcolor;
+        release();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void sidebar::release()
+    {
+        if (atlas_ && atlas_sink_)
+            atlas_sink_->release_atlas(*atlas_);
+
+        atlas_.reset();
+        atlas_sink_ = nullptr;
+        digits_ = 0;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void sidebar::prepare(paint_sink& sink)
+    {
+        if (atlas_ && atlas_sink_ == &sink)
+            return;
+
+        // the atlas of another sink is released through that one.
+        release();
+
+        sink.typeface(font_);
+        atlas_ = sink.make_atlas("0123456789", fgcolor_, bgcolor_);
+        atlas_sink_ = &sink;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    unsigned sidebar::digit_count(std::size_t number)
+    {
+        unsigned digits = 1;
+        for (; number >= 10; number /= 10)
+            ++digits;
+        return digits;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    unsigned sidebar::width(paint_sink& sink)
+    {
+        prepare(sink);
+
+        auto digits = digit_count(store_->line_count());
+        if (digits != digits_)
+        {
+            digits_ = digits;
+            width_ = digits_ * atlas_->cell.width + 2 * gutter_padding;
+        }
+        return width_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void sidebar::render
+    (
+        paint_sink& sink,
+        nana::rectangle const& area,
+        std::pair <index_type, index_type> visible_lines,
+        unsigned line_height
+    )
+    {
+        std::vector <std::pair <index_type, int>> line_tops;
+        for (auto line = visible_lines.first; line < visible_lines.second; ++line)
+            line_tops.emplace_back(line, area.y + static_cast <int> ((line - visible_lines.first) * line_height));
+        render(sink, area, line_tops, line_height);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void sidebar::render
+    (
+        paint_sink& sink,
+        nana::rectangle const& area,
+        std::vector <std::pair <index_type, int>> const& line_tops,
+        unsigned line_height
+    )
+    {
+        prepare(sink);
+
+        sink.rectangle(area, bgcolor_, true);
+
+        auto const cell = atlas_->cell;
+        auto const baseline_offset = (static_cast <int> (line_height) - static_cast <int> (cell.height)) / 2;
+        auto const right = area.right() - static_cast <int> (gutter_padding);
+
+        for (auto const& [line, top] : line_tops)
+        {
+            // a wrapped line that is scrolled into has its number above the area.
+            if (top < area.y)
+                continue;
+
+            auto const y = top + baseline_offset;
+
+            // compose the number right aligned, from the last digit to the first.
+            auto number = static_cast <std::size_t> (line) + 1;
+            auto x = right;
+            do
+            {
+                x -= static_cast <int> (cell.width);
+                sink.blit_glyph(*atlas_, number % 10, {x, y});
+                number /= 10;
+            } while (number != 0);
+        }
+    }
+//#####################################################################################################################
+}
@@ -2,8 +2,40 @@
 
 #include <nana-source-view/abstractions/store.hpp>
 
+#include <algorithm>
+#include <optional>
+#include <string>
+
 namespace nana_source_view::skeletons
 {
+    namespace
+    {
+        /// Width of the overview strip on the right in pixels.
+        constexpr unsigned minimap_width = 100;
+
+        /**
+         *  The bracket at offset and its match, as offsets.
+         */
+        std::optional <std::pair <data_store::index_type, data_store::index_type>> bracket_pair_at
+        (
+            data_store const& store,
+            bracket_index const& brackets,
+            data_store::index_type offset
+        )
+        {
+            if (offset < 0 || offset >= static_cast <data_store::index_type> (store.size()))
+                return std::nullopt;
+
+            auto const line = store.line_from_index(offset);
+            auto const column = static_cast <std::uint32_t> (offset - store.index_from_line(line));
+            auto const match = brackets.match(static_cast <std::size_t> (line), column);
+            if (!match)
+                return std::nullopt;
+
+            auto const matched = store.index_from_line(static_cast <data_store::index_type> (match->line)) + match->column;
+            return std::make_pair(offset, matched);
+        }
+    }
 //#####################################################################################################################
     struct source_editor_impl::implementation
     {
@@ -24,12 +56,75 @@ namespace nana_source_view::skeletons
         , renderer_{&impl_->store}
         , window_{wd}
         , graph_{graph}
+        , sink_{graph}
+        , sidebar_{&impl_->store}
+        , gutter_width_{0}
+        , minimap_{&impl_->store}
+        , occurrences_{&impl_->store}
+        , overlays_{}
+        , search_{&impl_->store}
+        , typed_search_{&impl_->store}
+        , wrap_{&impl_->store}
+        , folds_{&impl_->store, &wrap_}
+        , carets_{&impl_->store}
+        , drag_{false, false, 0, 0, 0, {}}
+        , blink_timer_{}
+        , search_timer_{}
+        , wrap_timer_{}
+        , drag_timer_{}
         , scheme_{scheme}
     {
+        // the minimap has to follow the edit before the styles are passed on to it.
+        impl_->store.add_observer(&minimap_);
+        impl_->store.add_observer(&occurrences_);
+        impl_->store.add_observer(&overlays_);
+        impl_->store.add_observer(&search_);
+        impl_->store.add_observer(&typed_search_);
+        impl_->store.add_observer(&wrap_);
+        impl_->store.add_observer(&folds_);
+        impl_->store.add_observer(this);
+
+        // wrapped and folded lines take their rows from the layout.
+        renderer_.row_layout(&wrap_);
+
+        blink_timer_.interval(carets_.interval());
+        blink_timer_.elapse([this]{blink_();});
+
+        // the search runs on its own thread, matches are taken over on this one.
+        search_timer_.interval(std::chrono::milliseconds{30});
+        search_timer_.elapse([this]{poll_search_();});
 
+        // lines outside of the view are wrapped after the view is drawn.
+        wrap_timer_.interval(std::chrono::milliseconds{1});
+        wrap_timer_.elapse([this]{rewrap_();});
+
+        // dragging above or below the text scrolls as long as the mouse stays there.
+        drag_timer_.interval(std::chrono::milliseconds{30});
+        drag_timer_.elapse([this]{autoscroll_();});
     }
 //---------------------------------------------------------------------------------------------------------------------
-    source_editor_impl::~source_editor_impl() = default;
+    source_editor_impl::~source_editor_impl()
+    {
+        impl_->store.remove_observer(this);
+        impl_->store.remove_observer(&folds_);
+        impl_->store.remove_observer(&wrap_);
+        impl_->store.remove_observer(&typed_search_);
+        impl_->store.remove_observer(&search_);
+        impl_->store.remove_observer(&overlays_);
+        impl_->store.remove_observer(&occurrences_);
+        impl_->store.remove_observer(&minimap_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::on_edit(std::vector <edit_delta> const& deltas)
+    {
+        auto* sty = renderer_.get_styler <styler> ();
+        if (!sty || deltas.empty())
+            return;
+
+        // carets far apart are restyled separately, not with all lines between them.
+        for (auto const& [begin, end] : sty->on_edit(deltas))
+            minimap_.restyle(*sty, begin, end);
+    }
 //---------------------------------------------------------------------------------------------------------------------
     void source_editor_impl::render(bool focused)
     {
@@ -44,14 +139,194 @@ namespace nana_source_view::skeletons
 
         if (nana::API::widget_borderless(window_))
         {
-            graph_.rectangle(true, bgcolor);
+            sink_.rectangle(nana::rectangle{graph_.size()}, bgcolor, true);
+        }
+        else
+        {
+            sink_.rectangle(nana::rectangle{graph_.size()}, bgcolor, true);
+        }
+
+        // the gutter only changes its width when the line count gains or loses a digit.
+        if (auto gutter_width = sidebar_.width(sink_); gutter_width != gutter_width_)
+        {
+            gutter_width_ = gutter_width;
+            layout_();
+        }
+
+        renderer_.foreground(fgcolor);
+        renderer_.selection_color(focused ? scheme_->selection.get_color() : scheme_->selection_unfocused.get_color());
+        renderer_.highlight(&search_.results(), scheme_->search_result.get_color());
+        renderer_.highlight(&overlays_, scheme_->overlay.get_color());
+        renderer_.render(sink_);
+        if (wrap_.stale() && !wrap_timer_.started())
+            wrap_timer_.start();
+
+        auto const [first, last] = renderer_.visible_lines();
+        std::vector <std::pair <data_store::index_type, int>> line_tops;
+        for (auto line = first; line < last; line = renderer_.next_line(line))
+            line_tops.emplace_back(line, renderer_.line_top(line));
+
+        sidebar_.render(
+            sink_,
+            nana::rectangle{impl_->area.x, impl_->area.y, gutter_width_, impl_->area.height},
+            line_tops,
+            renderer_.line_height()
+        );
+
+        minimap_.render(sink_, minimap_area_(), renderer_.visible_lines());
+
+        carets_.color(fgcolor);
+        carets_.render(renderer_, sink_, focused, caret_blinker::clock_type::now());
+        update_blink_timer_();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::focus(bool getting)
+    {
+        if (getting)
+            caret_activity();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::caret_activity()
+    {
+        if (carets_.activity(sink_, caret_blinker::clock_type::now()))
+            nana::API::update_window(window_);
+        update_blink_timer_();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::mouse_down(nana::point const& point, bool shift, bool ctrl, bool alt)
+    {
+        auto& store = impl_->store;
+        auto const offset = renderer_.hit_test(sink_, point);
+        drag_ = {true, alt, offset, store.line_from_index(offset), box_column_(point.x), point};
+
+        if (alt)
+            select_box(drag_.anchor_line, drag_.anchor_column, drag_.anchor_line, drag_.anchor_column);
+        else if (ctrl)
+        {
+            store.add_caret(offset);
+            drag_.active = false;
+        }
+        else if (shift)
+        {
+            auto const first = *store.caret_begin();
+            drag_.anchor = first.offset + first.range;
+            store.replace_carets({{offset, drag_.anchor - offset}});
         }
         else
+            store.replace_carets({{offset, 0}});
+
+        caret_activity();
+        nana::API::refresh_window(window_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::mouse_move(nana::point const& point)
+    {
+        if (!drag_.active)
+            return;
+
+        drag_.point = point;
+        drag_to_(point);
+
+        auto const area = renderer_.text_area();
+        if ((point.y < area.y || point.y >= area.bottom()) && !drag_timer_.started())
+            drag_timer_.start();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::mouse_up()
+    {
+        drag_.active = false;
+        drag_timer_.stop();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::double_click(nana::point const& point)
+    {
+        mouse_up();
+        basic_navigator{&impl_->store}.select_word(renderer_.hit_test(sink_, point));
+        caret_activity();
+        nana::API::refresh_window(window_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::drag_to_(nana::point const& point)
+    {
+        auto& store = impl_->store;
+        auto const offset = renderer_.hit_test(sink_, point);
+        if (drag_.box)
+            select_box(drag_.anchor_line, drag_.anchor_column, store.line_from_index(offset), box_column_(point.x));
+        else
+            store.replace_carets({{offset, drag_.anchor - offset}});
+
+        caret_activity();
+        nana::API::refresh_window(window_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::autoscroll_()
+    {
+        auto const area = renderer_.text_area();
+        auto const height = static_cast <int> (std::max(renderer_.line_height(), 1u));
+
+        data_store::index_type rows = 0;
+        if (drag_.point.y < area.y)
+            rows = (drag_.point.y - area.y) / height - 1;
+        else if (drag_.point.y >= area.bottom())
+            rows = (drag_.point.y - area.bottom()) / height + 1;
+
+        if (!drag_.active || rows == 0)
         {
-            graph_.rectangle(true, bgcolor);
+            drag_timer_.stop();
+            return;
         }
 
-        renderer_.render(graph_);
+        scroll_by_(rows);
+        drag_to_(drag_.point);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::scroll_by_(data_store::index_type rows)
+    {
+        auto const last = std::max(renderer_.scroll_extent() - 1, data_store::index_type{0});
+        renderer_.update_scroll(std::clamp(renderer_.scroll_top() + rows, data_store::index_type{0}, last));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    data_store::index_type source_editor_impl::box_column_(int x) const
+    {
+        // columns are as wide as the glyphs of a monospace font.
+        auto const width = static_cast <int> (std::max(renderer_.glyph_width(), 1u));
+        return std::max(x - renderer_.text_area().x + width / 2, 0) / width;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::blink_()
+    {
+        // maps the buffer without rendering the widget again, only the caret areas changed.
+        if (carets_.tick(sink_, caret_blinker::clock_type::now()))
+            nana::API::update_window(window_);
+        update_blink_timer_();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::update_blink_timer_()
+    {
+        auto const blinking = carets_.blinking(caret_blinker::clock_type::now());
+        if (blinking && !blink_timer_.started())
+            blink_timer_.start();
+        else if (!blinking && blink_timer_.started())
+            blink_timer_.stop();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::poll_search_()
+    {
+        // the first hits show as soon as they are found.
+        if (search_.poll() != 0)
+            nana::API::refresh_window(window_);
+        if (!search_.running())
+            search_timer_.stop();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::rewrap_()
+    {
+        wrap_timer_.stop();
+        if (!wrap_.stale())
+            return;
+
+        wrap_.refresh_all();
+        nana::API::refresh_window(window_);
     }
 //---------------------------------------------------------------------------------------------------------------------
     ::nana::color source_editor_impl::bgcolor_() const
@@ -66,11 +341,235 @@ namespace nana_source_view::skeletons
     void source_editor_impl::area(nana::rectangle const& rect)
     {
         impl_->area = rect;
+        layout_();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::layout_()
+    {
+        auto text_area = impl_->area;
+        auto const gutter = std::min(gutter_width_, text_area.width);
+        text_area.x += static_cast <int> (gutter);
+        text_area.width -= gutter;
+        text_area.width -= std::min(minimap_width, text_area.width);
+
+        renderer_.text_area(text_area);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    nana::rectangle source_editor_impl::minimap_area_() const
+    {
+        auto const& area = impl_->area;
+        auto const width = std::min(minimap_width, area.width);
+        return {area.right() - static_cast <int> (width), area.y, width, area.height};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::styler_replaced_(styler* sty)
+    {
+        sty->initialize();
+        minimap_.restyle(*sty, 0, static_cast <data_store::index_type> (impl_->store.line_count()));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::typeface(nana::paint::font const& font)
+    {
+        renderer_.font(font);
+        sidebar_.font(font);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <std::pair <data_store::index_type, data_store::index_type>> source_editor_impl::matching_brackets()
+    {
+        std::vector <std::pair <data_store::index_type, data_store::index_type>> pairs;
+        auto* sty = renderer_.get_styler <styler> ();
+        if (!sty)
+            return pairs;
+
+        auto const& store = impl_->store;
+        for (auto iter = store.caret_begin(); iter != store.caret_end(); ++iter)
+        {
+            auto pair = bracket_pair_at(store, sty->get_brackets(), iter->offset);
+            if (!pair)
+                pair = bracket_pair_at(store, sty->get_brackets(), iter->offset - 1);
+            if (pair)
+                pairs.push_back(*pair);
+        }
+        return pairs;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::jump_to_matching_brackets()
+    {
+        auto* sty = renderer_.get_styler <styler> ();
+        if (!sty)
+            return;
+
+        // carets that do not jump keep their selection.
+        auto& store = impl_->store;
+        std::vector <data_store::caret_type> carets;
+        carets.reserve(store.caret_count());
+        for (auto iter = store.caret_begin(); iter != store.caret_end(); ++iter)
+        {
+            if (auto pair = bracket_pair_at(store, sty->get_brackets(), iter->offset))
+                carets.push_back({pair->second, 0});
+            else if (auto pair = bracket_pair_at(store, sty->get_brackets(), iter->offset - 1))
+                carets.push_back({pair->second + 1, 0});
+            else
+                carets.push_back(*iter);
+        }
+
+        // replaced at once, an insert or erase per caret would move all carets behind it. Of carets that meet,
+        // the first one stays.
+        std::stable_sort(std::begin(carets), std::end(carets));
+        store.replace_carets(carets);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <data_store::index_type> source_editor_impl::occurrences_of_word()
+    {
+        auto const word = occurrences_.word_at(impl_->store.caret_begin()->offset);
+        if (word.empty())
+            return {};
+        return occurrences_.occurrences(word);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::select_all_occurrences()
+    {
+        auto const word = occurrences_.word_at(impl_->store.caret_begin()->offset);
+        if (word.empty())
+            return;
+
+        // carets behind the words, selecting them backwards. The offsets are sorted already.
+        auto const length = static_cast <data_store::index_type> (word.size());
+        std::vector <data_store::caret_type> carets;
+        for (auto offset : occurrences_.occurrences(word))
+            carets.push_back({offset + length, -length});
+        impl_->store.replace_carets(carets);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <word_trie::candidate> source_editor_impl::word_completions(std::size_t count)
+    {
+        auto const& store = impl_->store;
+        auto const end = store.caret_begin()->offset;
+        auto begin = end;
+        while (begin > 0 && basic_navigator::classify(store[begin - 1]) == basic_navigator::basic_character_classes::identifier)
+            --begin;
+        if (begin == end)
+            return {};
+
+        std::string prefix(static_cast <std::size_t> (end - begin), '\0');
+        for (auto i = begin; i != end; ++i)
+            prefix[static_cast <std::size_t> (i - begin)] = store[i];
+
+        // the word being typed is in the document too, it does not complete itself.
+        auto candidates = occurrences_.complete(prefix, count + 1);
+        candidates.erase(std::remove_if(std::begin(candidates), std::end(candidates), [&prefix](auto const& c)
+        {
+            return c.word == prefix;
+        }), std::end(candidates));
+        candidates.resize(std::min(candidates.size(), count));
+        return candidates;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    anchor_set& source_editor_impl::overlays()
+    {
+        return overlays_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t source_editor_impl::select_all_matches(std::string_view needle, find_case mode)
+    {
+        auto const carets = literal_finder{needle, mode}.select_all(impl_->store);
+        if (!carets.empty())
+            impl_->store.replace_carets(carets);
+        return carets.size();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::select_box
+    (
+        data_store::index_type anchor_line,
+        data_store::index_type anchor_column,
+        data_store::index_type active_line,
+        data_store::index_type active_column
+    )
+    {
+        basic_navigator{&impl_->store}.select_box(anchor_line, anchor_column, active_line, active_column);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::arrow_up(bool shift)
+    {
+        basic_navigator navigator{&impl_->store};
+        navigator.row_layout(&wrap_);
+        navigator.arrow_up(shift, false);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::arrow_down(bool shift)
+    {
+        basic_navigator navigator{&impl_->store};
+        navigator.row_layout(&wrap_);
+        navigator.arrow_down(shift, false);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <data_store::replacement> source_editor_impl::replace_all_matches
+    (
+        std::string_view needle,
+        std::string_view text,
+        find_case mode
+    )
+    {
+        literal_finder const finder{needle, mode};
+        std::vector <std::size_t> found;
+        finder.find_all(impl_->store.view(), 0, impl_->store.size(), found);
+
+        std::vector <data_store::replacement> replacements;
+        replacements.reserve(found.size());
+        for (auto const offset : found)
+            replacements.push_back({static_cast <data_store::index_type> (offset), static_cast <data_store::index_type> (finder.size()), std::string{text}});
+        return impl_->store.replace_all(replacements);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    line_operations source_editor_impl::lines()
+    {
+        return line_operations{&impl_->store};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::find_pattern(std::string_view pattern)
+    {
+        search_.start(pattern);
+        if (!search_timer_.started())
+            search_timer_.start();
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <std::size_t> const& source_editor_impl::find_as_you_type(std::string_view query, find_case mode)
+    {
+        return typed_search_.update(query, mode);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    background_search const& source_editor_impl::search() const
+    {
+        return search_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::word_wrap(bool enabled)
+    {
+        renderer_.word_wrap(enabled);
+        nana::API::refresh_window(window_);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    fold_tree& source_editor_impl::folds()
+    {
+        return folds_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void source_editor_impl::derive_folds()
+    {
+        // stylers that report no brackets leave the indentation.
+        auto* sty = renderer_.get_styler <styler> ();
+        auto regions = sty ? fold_tree::from_brackets(sty->get_brackets()) : std::vector <fold_region> {};
+        if (regions.empty())
+            regions = fold_tree::from_indentation(impl_->store);
+
+        folds_.assign(std::move(regions));
+        nana::API::refresh_window(window_);
     }
 //---------------------------------------------------------------------------------------------------------------------
     void source_editor_impl::text(std::string_view const& text)
     {
         impl_->store.utf8_string(text);
+        folds_.assign({});
     }
 //---------------------------------------------------------------------------------------------------------------------
     bool source_editor_impl::try_refresh()
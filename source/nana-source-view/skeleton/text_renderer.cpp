@@ -1,14 +1,45 @@
 #include <nana-source-view/skeleton/text_renderer.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+#include <tuple>
+
 namespace nana_source_view::skeletons
 {
+    namespace
+    {
+        /**
+         *  The row of a wrapped line a column is in. A column where a row begins is in that row,
+         *  or at the end of the row before with before_wrap.
+         */
+        std::size_t row_of(std::vector <data_store::index_type> const& wrap_points, data_store::index_type column, bool before_wrap)
+        {
+            auto const row = before_wrap
+                ? std::lower_bound(std::begin(wrap_points), std::end(wrap_points), column)
+                : std::upper_bound(std::begin(wrap_points), std::end(wrap_points), column)
+            ;
+            return static_cast <std::size_t> (std::distance(std::begin(wrap_points), row));
+        }
+    }
 //#####################################################################################################################
     text_renderer::text_renderer(data_store const* store)
         : store_{store}
         , area_{}
         , styler_{}
         , font_{}
+        , fgcolor_{nana::colors::white}
+        , selection_{store}
+        , highlights_{}
+        , wrap_{nullptr}
+        , word_wrap_{false}
         , scroll_top_{0}
+        , scroll_row_{0}
+        , line_height_{0}
+        , glyph_width_{0}
+        , monospace_{false}
+        , metrics_dirty_{true}
+        , advances_{}
     {
     }
 //---------------------------------------------------------------------------------------------------------------------
@@ -17,30 +48,457 @@ namespace nana_source_view::skeletons
         area_ = rect;
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void text_renderer::render(text_renderer::graph_reference graph)
+    nana::rectangle text_renderer::text_area() const
+    {
+        return area_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void text_renderer::render(paint_sink& sink)
+    {
+        sink.typeface(font_);
+        if (metrics_dirty_)
+            update_metrics(sink);
+        if (wrap_)
+            update_wrap();
+
+        selection_.render(*this, sink);
+
+        auto [first, last] = visible_lines();
+        if (first >= last)
+            return;
+
+        // hits are framed, so the selections below stay visible.
+        auto const line_count = static_cast <index_type> (store_->line_count());
+        auto const visible_begin = store_->index_from_line(first);
+        auto const visible_end = last < line_count ? store_->index_from_line(last) : static_cast <index_type> (store_->size());
+        for (auto const& [ranges, color] : highlights_)
+        {
+            for (auto const& span : selection_.collect(*this, sink, ranges->overlapping(visible_begin, visible_end)))
+                sink.rectangle(span, color, false);
+        }
+
+        // without a styler no line is styled, the empty view says so.
+        auto const styled = styler_
+            ? styler_->styles_on_lines(first, last)
+            : styler::range_type{nullptr, 0, 0}
+        ;
+
+        auto const bottom = area_.y + static_cast <int> (area_.height);
+        auto y = line_top(first);
+        for (auto line = first; line < last; line = next_line(line))
+        {
+            auto [begin, end] = store_->line(line);
+
+            // the line ending is not drawn.
+            while (begin != end && (*(end - 1) == '\n' || *(end - 1) == '\r'))
+                --end;
+
+            auto const text = begin == end
+                ? std::string_view{}
+                : std::string_view{&*begin, static_cast <std::size_t> (end - begin)}
+            ;
+
+            // a line that is not wrapped is a single row.
+            auto const& points = wrap_points(line);
+            for (std::size_t row = 0; row <= points.size(); ++row, y += static_cast <int> (line_height_))
+            {
+                auto const row_begin = row == 0 ? std::size_t{0} : static_cast <std::size_t> (points[row - 1]);
+                auto const row_end = row == points.size() ? text.size() : static_cast <std::size_t> (points[row]);
+                if (row_begin == row_end || y + static_cast <int> (line_height_) <= area_.y || y >= bottom)
+                    continue;
+
+                // only the glyphs left of the right border are drawn.
+                auto const visible = visible_row_end(sink, text, row_begin, row_end);
+                if (static_cast <std::size_t> (line) >= styled.last_line())
+                {
+                    sink.string({area_.x, y}, text.substr(row_begin, visible - row_begin), fgcolor_);
+                    continue;
+                }
+
+                render_runs(sink, line, y, text, styled.line(static_cast <std::size_t> (line)), row_begin, visible);
+            }
+        }
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void text_renderer::render_runs
+    (
+        paint_sink& sink,
+        index_type line,
+        int y,
+        std::string_view text,
+        styler::range_type const& styles,
+        std::size_t row_begin,
+        std::size_t row_end
+    )
+    {
+        auto const& palette = styler_->get_palette();
+        auto const line_begin = store_->index_from_line(line);
+        auto const row_offset = line_begin + static_cast <index_type> (row_begin);
+
+        // runs are cut to the row, which begins at the left of the text area.
+        x_cursor cursor{line, row_offset, area_.x, row_offset};
+        auto run = [&](std::size_t from, std::size_t to, style_id id)
+        {
+            from = std::max(from, row_begin);
+            to = std::min(to, row_end);
+            if (from >= to)
+                return;
+
+            auto const x = offset_x(sink, line, line_begin + static_cast <index_type> (from), &cursor);
+            sink.string(
+                {x, y},
+                text.substr(from, to - from),
+                id == style_palette::default_id ? fgcolor_ : palette[id].fgcolor
+            );
+        };
+
+        // ranges are sorted and do not overlap, gaps are unstyled. Neighbours with equal ids form one run.
+        std::size_t position = 0;
+        std::size_t run_begin = 0;
+        style_id run_id = style_palette::default_id;
+        for (auto const& range : styles)
+        {
+            auto const start = std::min <std::size_t> (range.start, text.size());
+            auto const end = std::min <std::size_t> (start + range.length, text.size());
+
+            // nothing behind the row is drawn, the rest is one run cut off at its end.
+            if (start >= row_end)
+                break;
+
+            auto const gap_id = start > position ? style_palette::default_id : range.id;
+            if (gap_id != run_id)
+            {
+                run(run_begin, position, run_id);
+                run_begin = position;
+                run_id = gap_id;
+            }
+            if (range.id != run_id)
+            {
+                run(run_begin, start, run_id);
+                run_begin = start;
+                run_id = range.id;
+            }
+            position = end;
+        }
+        if (position < text.size() && run_id != style_palette::default_id)
+        {
+            run(run_begin, position, run_id);
+            run_begin = position;
+            run_id = style_palette::default_id;
+        }
+        run(run_begin, text.size(), run_id);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    int text_renderer::offset_x
+    (
+        paint_sink& sink,
+        index_type line,
+        index_type offset,
+        x_cursor* cursor,
+        bool before_wrap
+    ) const
+    {
+        auto row_begin = store_->index_from_line(line);
+        if (laid_out())
+        {
+            auto const& points = wrap_->wrap_points(line);
+            auto const row = row_of(points, offset - row_begin, before_wrap);
+            if (row != 0)
+                row_begin += points[row - 1];
+        }
+
+        auto from = row_begin;
+        auto x = area_.x;
+        if (cursor && cursor->line == line && cursor->row_begin == row_begin && cursor->offset <= offset)
+        {
+            from = cursor->offset;
+            x = cursor->x;
+        }
+
+        // glyphs past the right edge are not drawn, so they are not measured either.
+        auto const text = std::begin(*store_);
+        auto const right = area_.x + static_cast <int> (area_.width);
+        while (from < offset && x <= right)
+        {
+            auto next = from + 1;
+            while (next < offset && (text[next] & 0b1100'0000) == 0b1000'0000)
+                ++next;
+
+            x += static_cast <int> (monospace_ ? glyph_width_ : advance(sink, {&*(text + from), static_cast <std::size_t> (next - from)}));
+            from = next;
+        }
+
+        if (cursor)
+            *cursor = {line, offset, x, row_begin};
+        return x;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    nana::point text_renderer::position(paint_sink& sink, index_type line, index_type offset, x_cursor* cursor) const
+    {
+        auto const row = row_of(wrap_points(line), offset - store_->index_from_line(line), false);
+        return {
+            offset_x(sink, line, offset, cursor),
+            line_top(line) + static_cast <int> (row * line_height_)
+        };
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    text_renderer::index_type text_renderer::hit_test(paint_sink& sink, nana::point const& point) const
+    {
+        if (line_height_ == 0)
+            return 0;
+
+        // rows above the text area count negative.
+        auto const height = static_cast <int> (line_height_);
+        auto const distance = point.y - area_.y;
+        auto const row = scroll_top() + (distance >= 0 ? distance / height : (distance - height + 1) / height);
+        if (row < 0)
+            return 0;
+        if (row >= scroll_extent())
+            return static_cast <index_type> (store_->size());
+
+        auto line = row;
+        auto row_of_line = index_type{0};
+        if (laid_out())
+            std::tie(line, row_of_line) = wrap_->line_of_row(row);
+
+        auto [begin, end] = store_->line(line);
+        while (begin != end && (*(end - 1) == '\n' || *(end - 1) == '\r'))
+            --end;
+
+        auto const line_begin = store_->index_from_line(line);
+        auto const& points = wrap_points(line);
+        auto const index = static_cast <std::size_t> (row_of_line);
+        auto const wrapped = index < points.size();
+        auto const row_begin = line_begin + (index == 0 ? 0 : points[index - 1]);
+        auto const row_end = wrapped ? line_begin + points[index] : line_begin + static_cast <index_type> (end - begin);
+
+        // glyphs are passed while the point is right of their middle, but none right of the area are measured.
+        auto const text = std::begin(*store_);
+        auto const target = std::min(point.x, area_.x + static_cast <int> (area_.width));
+        auto pos = row_begin;
+        auto x = area_.x;
+        while (pos < row_end)
+        {
+            auto next = pos + 1;
+            while (next < row_end && (text[next] & 0b1100'0000) == 0b1000'0000)
+                ++next;
+
+            auto const width = static_cast <int> (monospace_ ? glyph_width_ : advance(sink, {&*(text + pos), static_cast <std::size_t> (next - pos)}));
+            if (target < x + width / 2)
+                break;
+
+            x += width;
+            pos = next;
+        }
+
+        // the end of a wrapped row is where the next one begins, so the caret stays in front of its last glyph.
+        if (wrapped && pos == row_end && pos > row_begin)
+        {
+            for (--pos; pos > row_begin && (text[pos] & 0b1100'0000) == 0b1000'0000; --pos)
+            {
+            }
+        }
+        return pos;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    int text_renderer::line_top(index_type line) const
+    {
+        auto const [first, row] = scroll_anchor();
+        auto const rows = laid_out() ? wrap_->row_of_line(line) - wrap_->row_of_line(first) : line - first;
+        return area_.y + static_cast <int> ((rows - row) * static_cast <index_type> (line_height_));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::vector <text_renderer::index_type> const& text_renderer::wrap_points(index_type line) const
+    {
+        static std::vector <index_type> const unwrapped{};
+        return laid_out() ? wrap_->wrap_points(line) : unwrapped;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void text_renderer::update_metrics(paint_sink& sink)
+    {
+        auto extent = sink.text_extent_size("M");
+        line_height_ = std::max(extent.height, 1u);
+        glyph_width_ = std::max(extent.width, 1u);
+        metrics_dirty_ = false;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::size_t text_renderer::visible_row_end(paint_sink& sink, std::string_view text, std::size_t begin, std::size_t end) const
+    {
+        auto const right = area_.x + static_cast <int> (area_.width);
+        auto x = area_.x;
+        auto pos = begin;
+        while (pos < end && x < right)
+        {
+            auto next = pos + 1;
+            while (next < end && (text[next] & 0b1100'0000) == 0b1000'0000)
+                ++next;
+
+            x += static_cast <int> (monospace_ ? glyph_width_ : advance(sink, text.substr(pos, next - pos)));
+            pos = next;
+        }
+        return pos;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    unsigned text_renderer::advance(paint_sink& sink, std::string_view glyph) const
+    {
+        std::uint32_t key = 0;
+        for (auto const byte : glyph.substr(0, 4))
+            key = (key << 8) | static_cast <unsigned char> (byte);
+
+        auto found = advances_.find(key);
+        if (found == std::end(advances_))
+            found = advances_.emplace(key, sink.text_extent_size(glyph).width).first;
+        return found->second;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void text_renderer::update_scroll(index_type scroll_top_row)
+    {
+        if (!laid_out())
+        {
+            scroll_top_ = scroll_top_row;
+            scroll_row_ = 0;
+            return;
+        }
+
+        std::tie(scroll_top_, scroll_row_) = wrap_->line_of_row(std::max(scroll_top_row, index_type{0}));
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    text_renderer::index_type text_renderer::scroll_top() const
+    {
+        auto const [line, row] = scroll_anchor();
+        return laid_out() ? wrap_->row_of_line(line) + row : line;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    text_renderer::index_type text_renderer::scroll_extent() const
     {
-        nana::paint::font f{12, "Tahoma", nana::paint::font::font_style{
-            400, false, true, true
-        }};
+        return laid_out() ? wrap_->row_count() : static_cast <index_type> (store_->line_count());
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::pair <text_renderer::index_type, text_renderer::index_type> text_renderer::scroll_anchor() const
+    {
+        auto const line_count = static_cast <index_type> (store_->line_count());
+        auto const line = std::min(std::max(scroll_top_, static_cast <index_type> (0)), line_count);
+        if (!laid_out() || line == line_count)
+            return {line, 0};
 
-        graph.typeface(f);
+        // the line was folded away after scrolling to it.
+        if (wrap_->hidden(line))
+        {
+            auto const header = wrap_->previous_visible(line);
+            return {header >= 0 ? header : wrap_->next_visible(line), 0};
+        }
 
-        graph.string({0,0}, "lorem ipsum", nana::colors::white);
+        // rewrapping may have left the line with fewer rows.
+        return {line, std::min(scroll_row_, wrap_->rows(line) - 1)};
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void text_renderer::row_layout(wrap_layout* layout)
+    {
+        if (wrap_ && wrap_ != layout)
+            wrap_->columns(0);
+        wrap_ = layout;
+        scroll_row_ = 0;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void text_renderer::word_wrap(bool enabled)
+    {
+        word_wrap_ = enabled;
+        scroll_row_ = 0;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool text_renderer::hidden(index_type line) const
+    {
+        return laid_out() && wrap_->hidden(line);
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void text_renderer::update_scroll(index_type scroll_top_line)
+    text_renderer::index_type text_renderer::next_line(index_type line) const
     {
-        scroll_top_ = scroll_top_line;
+        return laid_out() ? wrap_->next_visible(line) : line + 1;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    bool text_renderer::laid_out() const
+    {
+        return wrap_ != nullptr;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void text_renderer::update_wrap()
+    {
+        if (!word_wrap_)
+        {
+            wrap_->columns(0);
+            return;
+        }
+        if (area_.width == 0 || glyph_width_ == 0)
+            return;
+
+        // proportional fonts are wrapped by the width of an 'M'.
+        wrap_->columns(static_cast <index_type> (std::max(area_.width / glyph_width_, 1u)));
+
+        // wrapped lines may push lines out of the view, those need not be wrapped now.
+        auto [first, last] = visible_lines();
+        while (wrap_->refresh(first, last))
+            std::tie(first, last) = visible_lines();
     }
 //---------------------------------------------------------------------------------------------------------------------
     void text_renderer::font(nana::paint::font const& font, bool assume_monospace)
     {
         font_ = font;
+        monospace_ = assume_monospace;
+        metrics_dirty_ = true;
+        advances_.clear();
     }
 //---------------------------------------------------------------------------------------------------------------------
     nana::paint::font text_renderer::font() const
     {
         return font_;
     }
+//---------------------------------------------------------------------------------------------------------------------
+    void text_renderer::foreground(nana::color const& color)
+    {
+        fgcolor_ = color;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void text_renderer::highlight(anchor_set const* ranges, nana::color const& color)
+    {
+        auto known = std::find_if(std::begin(highlights_), std::end(highlights_), [ranges](auto const& entry)
+        {
+            return entry.first == ranges;
+        });
+        if (known == std::end(highlights_))
+            highlights_.emplace_back(ranges, color);
+        else
+            known->second = color;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    void text_renderer::selection_color(nana::color const& color)
+    {
+        selection_.color(color);
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    unsigned text_renderer::glyph_width() const
+    {
+        return glyph_width_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    unsigned text_renderer::line_height() const
+    {
+        return line_height_;
+    }
+//---------------------------------------------------------------------------------------------------------------------
+    std::pair <text_renderer::index_type, text_renderer::index_type> text_renderer::visible_lines() const
+    {
+        auto const line_count = static_cast <index_type> (store_->line_count());
+        if (line_height_ == 0)
+            return {0, 0};
+
+        // a partially visible line at the bottom is still drawn.
+        auto const fitting = static_cast <index_type> ((area_.height + line_height_ - 1) / line_height_);
+        auto const [first, row] = scroll_anchor();
+        if (!laid_out())
+            return {first, std::min(first + fitting, line_count)};
+
+        auto const last_row = wrap_->row_of_line(first) + row + fitting - 1;
+        return {first, std::min(wrap_->line_of_row(last_row).first + 1, line_count)};
+    }
 //#####################################################################################################################
 }
@@ -54,6 +54,7 @@ namespace nana_source_view::drawerbase::source_editor
         editor_ = std::make_unique <skeletons::source_editor_impl> (
             wd, graph, dynamic_cast<skeletons::source_editor_scheme*>(scheme)
         );
+        editor_->area(nana::rectangle{graph.size()});
     }
 //---------------------------------------------------------------------------------------------------------------------
     void drawer::detached()
@@ -66,32 +67,41 @@ namespace nana_source_view::drawerbase::source_editor
         editor_->render(nana::API::is_focus_ready(*widget_));
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void drawer::focus(graph_reference, const nana::arg_focus&)
+    void drawer::focus(graph_reference, const nana::arg_focus& arg)
     {
         //if (!editor_->focus_changed(arg))
         //    refresh(graph);
 
+        editor_->focus(arg.getting);
         nana::API::dev::lazy_refresh();
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void drawer::mouse_down(graph_reference, const nana::arg_mouse&)
+    void drawer::mouse_down(graph_reference, const nana::arg_mouse& arg)
     {
+        if (!arg.is_left_button())
+            return;
 
+        // the mouse is captured, so dragging goes on outside of the widget.
+        nana::API::focus_window(widget_->handle());
+        nana::API::capture_window(widget_->handle(), true);
+        editor_->mouse_down(arg.pos, arg.shift, arg.ctrl, arg.alt);
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void drawer::mouse_move(graph_reference, const nana::arg_mouse&)
+    void drawer::mouse_move(graph_reference, const nana::arg_mouse& arg)
     {
-
+        if (arg.left_button)
+            editor_->mouse_move(arg.pos);
     }
 //---------------------------------------------------------------------------------------------------------------------
     void drawer::mouse_up(graph_reference, const nana::arg_mouse&)
     {
-
+        editor_->mouse_up();
+        nana::API::capture_window(widget_->handle(), false);
     }
 //---------------------------------------------------------------------------------------------------------------------
     void drawer::mouse_enter(graph_reference, const nana::arg_mouse&)
     {
-
+        nana::API::window_cursor(widget_->handle(), nana::cursor::iterm);
     }
 //---------------------------------------------------------------------------------------------------------------------
     void drawer::mouse_leave(graph_reference, const nana::arg_mouse&)
@@ -99,19 +109,20 @@ namespace nana_source_view::drawerbase::source_editor
 
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void drawer::dbl_click(graph_reference, const nana::arg_mouse&)
+    void drawer::dbl_click(graph_reference, const nana::arg_mouse& arg)
     {
-
+        if (arg.is_left_button())
+            editor_->double_click(arg.pos);
     }
 //---------------------------------------------------------------------------------------------------------------------
     void drawer::key_press(graph_reference, const nana::arg_keyboard&)
     {
-
+        editor_->caret_activity();
     }
 //---------------------------------------------------------------------------------------------------------------------
     void drawer::key_char(graph_reference, const nana::arg_keyboard&)
     {
-
+        editor_->caret_activity();
     }
 //---------------------------------------------------------------------------------------------------------------------
     void drawer::mouse_wheel(graph_reference, const nana::arg_wheel&)
@@ -119,14 +130,16 @@ namespace nana_source_view::drawerbase::source_editor
 
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void drawer::resized(graph_reference, const nana::arg_resized&)
+    void drawer::resized(graph_reference graph, const nana::arg_resized&)
     {
-
+        editor_->area(nana::rectangle{graph.size()});
+        refresh(graph);
+        nana::API::dev::lazy_refresh();
     }
 //---------------------------------------------------------------------------------------------------------------------
-    void drawer::typeface_changed(graph_reference)
+    void drawer::typeface_changed(graph_reference graph)
     {
-
+        editor_->typeface(graph.typeface());
     }
 //#####################################################################################################################
 }
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/abstractions/anchor_set.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+class AnchorSetTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    using ranges = std::vector <nana_source_view::anchored_range>;
+
+    /**
+     *  Moves every range through every delta, the straightforward way.
+     */
+    struct naive_anchors : nana_source_view::edit_observer
+    {
+        ranges all;
+
+        void on_edit(std::vector <nana_source_view::edit_delta> const& deltas) override
+        {
+            for (auto delta = std::rbegin(deltas); delta != std::rend(deltas); ++delta)
+            {
+                auto const removed_end = delta->offset + delta->removed;
+                auto const shift = delta->inserted - delta->removed;
+                for (auto& r : all)
+                {
+                    auto begin = r.begin < delta->offset ? r.begin : r.begin >= removed_end ? r.begin + shift : delta->offset + delta->inserted;
+                    auto end = r.end <= delta->offset ? r.end : r.end >= removed_end ? r.end + shift : delta->offset;
+                    if (end < begin)
+                        begin = end = delta->offset;
+                    r.begin = begin;
+                    r.end = end;
+                }
+                std::stable_sort(std::begin(all), std::end(all), [](auto const& lhs, auto const& rhs)
+                {
+                    return lhs.begin < rhs.begin;
+                });
+            }
+        }
+    };
+};
+
+TEST_F(AnchorSetTests, ShiftsAndShrinksWithEdits)
+{
+    nana_source_view::data_store store{"int x = y + z;"};
+    nana_source_view::anchor_set anchors;
+    anchors.assign({{8, 9, 1}, {12, 13, 2}, {4, 5, 3}});
+    store.add_observer(&anchors);
+
+    // typing in front of y moves y and z, not x.
+    store.remove_caret(store.caret_begin());
+    store.add_caret(8);
+    store.insert_byte('(');
+    EXPECT_EQ(anchors.overlapping(0, 100), (ranges{{4, 5, 3}, {9, 10, 1}, {13, 14, 2}}));
+
+    // overwriting "x = (y" collapses both: x where the removal began, y at its end behind the new byte.
+    store.remove_caret(store.caret_begin());
+    store.add_caret(10, -6);
+    store.insert_byte('a');
+    EXPECT_EQ(store.utf8_string(), "int a + z;");
+    EXPECT_EQ(anchors.overlapping(0, 100), (ranges{{4, 4, 3}, {5, 5, 1}, {8, 9, 2}}));
+
+    store.remove_observer(&anchors);
+}
+
+TEST_F(AnchorSetTests, QueriesAndRemovesByRange)
+{
+    nana_source_view::anchor_set anchors;
+    for (std::uint32_t i = 0; i != 100; ++i)
+        anchors.insert({i * 10, i * 10 + 5, i % 2});
+
+    EXPECT_EQ(anchors.overlapping(23, 41), (ranges{{20, 25, 0}, {30, 35, 1}, {40, 45, 0}}));
+    EXPECT_EQ(anchors.overlapping(25, 30), (ranges{}));
+
+    EXPECT_EQ(anchors.remove(0, 50, 1), 2);
+    EXPECT_EQ(anchors.size(), 98);
+    EXPECT_EQ(anchors.overlapping(0, 52), (ranges{{0, 5, 0}, {20, 25, 0}, {40, 45, 0}, {50, 55, 1}}));
+
+    EXPECT_THROW(anchors.insert({5, 4, 0}), std::invalid_argument);
+}
+
+TEST_F(AnchorSetTests, FollowsEditsLikeANaiveMapping)
+{
+    std::mt19937 rng{11};
+    std::string initial(3000, 'x');
+    nana_source_view::data_store store{initial};
+
+    naive_anchors naive;
+    for (std::uint32_t i = 0; i != 400; ++i)
+    {
+        auto const begin = static_cast <index_type> (rng() % 3000);
+        naive.all.push_back({begin, std::min <index_type> (begin + static_cast <index_type> (rng() % 20), 3000), i});
+    }
+    nana_source_view::anchor_set anchors;
+    anchors.assign(naive.all);
+    std::stable_sort(std::begin(naive.all), std::end(naive.all), [](auto const& lhs, auto const& rhs)
+    {
+        return lhs.begin < rhs.begin;
+    });
+
+    store.add_observer(&anchors);
+    store.add_observer(&naive);
+    for (int round = 0; round != 200; ++round)
+    {
+        auto const size = static_cast <index_type> (store.size());
+        std::vector <caret_type> carets;
+        for (index_type offset = static_cast <index_type> (rng() % 100); offset < size; offset += 100 + static_cast <index_type> (rng() % 500))
+            carets.push_back({offset, std::min <index_type> (static_cast <index_type> (rng() % 8), size - offset)});
+        if (carets.empty())
+            carets.push_back({size, 0});
+
+        store.replace_carets(carets);
+        store.insert_byte('y');
+    }
+    store.remove_observer(&naive);
+    store.remove_observer(&anchors);
+
+    // ranges with equal begins may be in a different order.
+    auto sorted = [](ranges r)
+    {
+        std::sort(std::begin(r), std::end(r), [](auto const& lhs, auto const& rhs)
+        {
+            return std::tie(lhs.begin, lhs.tag) < std::tie(rhs.begin, rhs.tag);
+        });
+        return r;
+    };
+    EXPECT_EQ(sorted(anchors.overlapping(0, static_cast <index_type> (store.size()) + 1)), sorted(naive.all));
+}
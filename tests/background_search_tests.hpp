@@ -0,0 +1,150 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/abstractions/background_search.hpp>
+
+#include <atomic>
+#include <cctype>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+class BackgroundSearchTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    using search_type = nana_source_view::background_search;
+    using range = nana_source_view::anchored_range;
+
+    /**
+     *  Polls like the editor does, until the search is done.
+     */
+    static void wait(search_type& search)
+    {
+        while (search.running())
+        {
+            search.poll();
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     *  The matches of x\d+, the straightforward way.
+     */
+    static std::vector <range> naive_numbers(std::string const& text)
+    {
+        std::vector <range> result;
+        for (std::size_t pos = 0; pos + 1 < text.size(); ++pos)
+        {
+            if (text[pos] != 'x' || !std::isdigit(static_cast <unsigned char> (text[pos + 1])))
+                continue;
+            auto end = pos + 1;
+            while (end < text.size() && std::isdigit(static_cast <unsigned char> (text[end])))
+                ++end;
+            result.push_back({static_cast <range::index_type> (pos), static_cast <range::index_type> (end), 0});
+            pos = end - 1;
+        }
+        return result;
+    }
+};
+
+TEST_F(BackgroundSearchTests, FindsAllMatchesInBatches)
+{
+    std::mt19937 rng{3};
+    std::string text(1'500'000, ' ');
+    for (auto& c : text)
+        c = "x12 \nab"[rng() % 7];
+
+    nana_source_view::data_store store{text};
+    search_type search{&store};
+    std::atomic <int> notified{0};
+    search.on_progress([&notified]{++notified;});
+
+    search.start("x\\d+");
+    wait(search);
+
+    auto const expected = naive_numbers(text);
+    ASSERT_GT(expected.size(), 1000u);
+    EXPECT_EQ(search.results().overlapping(0, static_cast <range::index_type> (text.size())), expected);
+
+    // a batch per slice and one when done.
+    EXPECT_GT(notified.load(), 2);
+    EXPECT_THROW(search.start("x("), std::invalid_argument);
+    EXPECT_EQ(search.results().size(), expected.size());
+}
+
+TEST_F(BackgroundSearchTests, NewQueryReplacesTheOldOne)
+{
+    std::string text;
+    for (int i = 0; i != 100'000; ++i)
+        text += "alpha beta gamma\n";
+
+    nana_source_view::data_store store{text};
+    search_type search{&store};
+
+    search.start("alpha|gamma");
+    search.start("be+ta");
+    wait(search);
+    EXPECT_EQ(search.results().size(), 100'000u);
+    EXPECT_EQ(search.results().overlapping(0, 17), (std::vector <range>{{6, 10, 0}}));
+
+    search.start("z");
+    wait(search);
+    EXPECT_TRUE(search.results().empty());
+}
+
+TEST_F(BackgroundSearchTests, EditsCancelAndMoveResults)
+{
+    nana_source_view::data_store store{"one two one two one"};
+    search_type search{&store};
+    store.add_observer(&search);
+
+    search.start("one");
+    wait(search);
+    ASSERT_EQ(search.results().size(), 3u);
+
+    search.start("two");
+    store.remove_caret(store.caret_begin());
+    store.add_caret(0);
+    store.insert_byte('#');
+    EXPECT_FALSE(search.running());
+
+    // the found matches moved behind the inserted byte, the search restarts on the new text.
+    for (auto const& r : search.results().overlapping(0, static_cast <range::index_type> (store.size())))
+        EXPECT_EQ(store.view().substr(static_cast <std::size_t> (r.begin), 3), "two");
+
+    search.start("one");
+    wait(search);
+    EXPECT_EQ(search.results().overlapping(0, 5), (std::vector <range>{{1, 4, 0}}));
+    store.remove_observer(&search);
+}
+
+TEST_F(BackgroundSearchTests, FailedStartsAreNotScannedAgain)
+{
+    // tried from every start separately, both patterns would take quadratic time.
+    nana_source_view::data_store store{std::string(300'000, 'a')};
+    search_type search{&store};
+    store.add_observer(&search);
+
+    search.start("a[^z]*z");
+    search.start("a[^z]*zz");
+    wait(search);
+    EXPECT_TRUE(search.results().empty());
+
+    search.start("a[^z]*z|a");
+    wait(search);
+    EXPECT_EQ(search.results().size(), 300'000u);
+    EXPECT_EQ(search.results().overlapping(5, 6), (std::vector <range>{{5, 6, 0}}));
+
+    // the kept snapshot follows edits.
+    store.remove_caret(store.caret_begin());
+    store.add_caret(10);
+    store.insert_byte('z');
+    search.start("a[^z]*z");
+    wait(search);
+    EXPECT_EQ(search.results().overlapping(0, 20), (std::vector <range>{{0, 11, 0}}));
+    store.remove_observer(&search);
+}
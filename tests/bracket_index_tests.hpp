@@ -0,0 +1,143 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/abstractions/bracket_index.hpp>
+#include <nana-source-view/c_styler.hpp>
+
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+class BracketIndexTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    using location = std::pair <std::size_t, std::uint32_t>;
+
+    static std::optional <location> matched(nana_source_view::bracket_index const& index, std::size_t line, std::uint32_t column)
+    {
+        auto match = index.match(line, column);
+        if (!match)
+            return std::nullopt;
+        return location{match->line, match->column};
+    }
+
+    /**
+     *  Matches every bracket of lines by a stack, the straightforward way.
+     */
+    static std::vector <std::pair <location, location>> naive_pairs(std::vector <std::string> const& lines)
+    {
+        std::vector <std::pair <location, location>> pairs;
+        std::vector <location> open;
+        for (std::size_t line = 0; line != lines.size(); ++line)
+        {
+            for (std::uint32_t column = 0; column != lines[line].size(); ++column)
+            {
+                if (nana_source_view::bracket_index::is_opening(lines[line][column]))
+                    open.push_back({line, column});
+                else if (!open.empty())
+                {
+                    pairs.push_back({open.back(), {line, column}});
+                    open.pop_back();
+                }
+            }
+        }
+        return pairs;
+    }
+
+    static void splice(nana_source_view::bracket_index& index, std::size_t begin, std::size_t end, std::vector <std::string> const& lines)
+    {
+        std::vector <std::size_t> sizes;
+        std::vector <nana_source_view::bracket> brackets;
+        for (auto const& line : lines)
+        {
+            sizes.push_back(line.size());
+            for (std::size_t column = 0; column != line.size(); ++column)
+                brackets.push_back({static_cast <std::uint32_t> (column), line[column]});
+        }
+        index.splice(begin, end, sizes, brackets);
+    }
+};
+
+TEST_F(BracketIndexTests, IgnoresBracketsInStringsAndComments)
+{
+    nana_source_view::data_store store{
+        "int main() {\n"
+        "    auto s = \"}\"; // )\n"
+        "    /* { */ f(a[1]);\n"
+        "}\n"
+    };
+    nana_source_view::styles::c_style sty{&store};
+    sty.initialize();
+
+    auto const& brackets = sty.get_brackets();
+    EXPECT_EQ(brackets.brackets_on_line(1).size(), 0);
+    EXPECT_EQ(matched(brackets, 0, 11), (location{3, 0}));
+    EXPECT_EQ(matched(brackets, 3, 0), (location{0, 11}));
+    EXPECT_EQ(matched(brackets, 2, 15), (location{2, 17}));
+    EXPECT_EQ(matched(brackets, 2, 18), (location{2, 13}));
+    EXPECT_FALSE(brackets.match(0, 0));
+}
+
+TEST_F(BracketIndexTests, MatchesLikeAStack)
+{
+    std::mt19937 rng{42};
+    auto random_line = [&rng]
+    {
+        static constexpr char symbols[] = "()[]{}((";
+        std::string line(rng() % 5, ' ');
+        for (auto& c : line)
+            c = symbols[rng() % 8];
+        return line;
+    };
+
+    std::vector <std::string> lines(300);
+    for (auto& line : lines)
+        line = random_line();
+
+    nana_source_view::bracket_index index{0};
+    splice(index, 0, 0, lines);
+
+    // replace, insert and remove lines at random, then compare every bracket with the naive matching.
+    for (int round = 0; round != 50; ++round)
+    {
+        auto const begin = rng() % lines.size();
+        auto const end = std::min <std::size_t> (begin + rng() % 4, lines.size());
+        std::vector <std::string> fresh(rng() % 4);
+        for (auto& line : fresh)
+            line = random_line();
+
+        splice(index, begin, end, fresh);
+        lines.erase(std::begin(lines) + static_cast <std::ptrdiff_t> (begin), std::begin(lines) + static_cast <std::ptrdiff_t> (end));
+        lines.insert(std::begin(lines) + static_cast <std::ptrdiff_t> (begin), std::begin(fresh), std::end(fresh));
+    }
+    ASSERT_EQ(index.line_count(), lines.size());
+
+    std::size_t matches = 0;
+    for (auto const& [open, close] : naive_pairs(lines))
+    {
+        EXPECT_EQ(matched(index, open.first, open.second), close);
+        EXPECT_EQ(matched(index, close.first, close.second), open);
+        ++matches;
+    }
+    EXPECT_GT(matches, 100u);
+}
+
+TEST_F(BracketIndexTests, EditsMoveMatches)
+{
+    nana_source_view::data_store store{"f(\n  g()\n)\n"};
+    nana_source_view::styles::c_style sty{&store};
+    sty.initialize();
+    EXPECT_EQ(matched(sty.get_brackets(), 0, 1), (location{2, 0}));
+
+    // a closing bracket on the middle line now closes the first.
+    store.remove_caret(store.caret_begin());
+    store.add_caret(store.index_from_line(1) + 5);
+    store.insert_byte(')');
+    sty.on_line_change(1);
+    EXPECT_EQ(matched(sty.get_brackets(), 0, 1), (location{1, 5}));
+    EXPECT_FALSE(sty.get_brackets().match(2, 0));
+}
@@ -0,0 +1,259 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/c_styler.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class CStylerTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    using line_state = nana_source_view::styles::c_style::line_state;
+
+    /**
+     *  Renders the styles of a line as the styled text, one entry per range.
+     */
+    std::vector <std::string> styled(nana_source_view::styles::c_style& sty, index_type line)
+    {
+        auto [begin, end] = store.line(line);
+        std::string text{begin, end};
+
+        std::vector <std::string> result;
+        for (auto const& range : sty.styles_on_line(line))
+            result.push_back(text.substr(range.start, range.length));
+        return result;
+    }
+
+    /**
+     *  Inserts text at offset and informs the styler like the editor does.
+     */
+    void type(nana_source_view::styles::c_style& sty, index_type offset, std::string const& text)
+    {
+        store.remove_caret(store.caret_begin());
+        store.add_caret(offset);
+
+        auto const line = store.line_from_index(offset);
+        index_type breaks = 0;
+        for (auto c : text)
+        {
+            store.insert_byte(c);
+            breaks += c == '\n';
+        }
+        sty.on_multi_line_change(line, line + breaks + 1);
+    }
+
+    /**
+     *  Hands the deltas of every edit to the styler, like the editor does with several carets.
+     */
+    struct forwarder : nana_source_view::edit_observer
+    {
+        explicit forwarder(nana_source_view::styles::c_style* sty)
+            : sty{sty}
+        {
+        }
+
+        void on_edit(std::vector <nana_source_view::edit_delta> const& deltas) override
+        {
+            restyled = sty->on_edit(deltas);
+        }
+
+        nana_source_view::styles::c_style* sty;
+        std::vector <std::pair <index_type, index_type>> restyled;
+    };
+
+    /**
+     *  Expects the same styles and states as lexing the whole text again.
+     */
+    void expect_fresh(nana_source_view::styles::c_style& sty)
+    {
+        nana_source_view::styles::c_style fresh{&store};
+        fresh.initialize();
+        for (index_type line = 0; line != static_cast <index_type> (store.line_count()); ++line)
+        {
+            EXPECT_EQ(styled(sty, line), styled(fresh, line)) << "line " << line;
+            EXPECT_EQ(sty.state_at(line).ctx, fresh.state_at(line).ctx) << "line " << line;
+        }
+    }
+
+    nana_source_view::data_store store{
+        "#include <vector>\n"
+        "int main() // entry\n"
+        "{\n"
+        "    auto s = \"text\";\n"
+        "    return 0x1F;\n"
+        "}\n"
+    };
+};
+
+TEST_F(CStylerTests, HighlightsTokenClasses)
+{
+    nana_source_view::styles::c_style sty{&store};
+    sty.initialize();
+
+    EXPECT_EQ(styled(sty, 0), (std::vector <std::string>{"#include", "<vector>"}));
+    EXPECT_EQ(styled(sty, 1), (std::vector <std::string>{"int", "// entry"}));
+    EXPECT_TRUE(styled(sty, 2).empty());
+    EXPECT_EQ(styled(sty, 3), (std::vector <std::string>{"auto", "\"text\""}));
+    EXPECT_EQ(styled(sty, 4), (std::vector <std::string>{"return", "0x1F"}));
+
+    auto const& palette = sty.get_palette();
+    auto keyword = sty.styles_on_line(1).begin()->id;
+    EXPECT_EQ(sty.styles_on_line(3).begin()->id, keyword);
+    EXPECT_NE((sty.styles_on_line(1).begin() + 1)->id, keyword);
+    EXPECT_EQ(palette.size(), 6);
+}
+
+TEST_F(CStylerTests, OpenedCommentRestylesFollowingLines)
+{
+    nana_source_view::styles::c_style sty{&store};
+    sty.initialize();
+
+    type(sty, store.index_from_line(2) + 1, "/*");
+    EXPECT_EQ(sty.relexed_lines(), 5);
+    EXPECT_EQ(sty.restyled_lines(), (std::pair <index_type, index_type>{2, 7}));
+    EXPECT_EQ(styled(sty, 4), (std::vector <std::string>{"    return 0x1F;"}));
+    EXPECT_EQ(sty.state_at(5).ctx, line_state::context::block_comment);
+
+    type(sty, store.index_from_line(3), "*/");
+    EXPECT_EQ(styled(sty, 3), (std::vector <std::string>{"*/", "auto", "\"text\""}));
+    EXPECT_EQ(sty.state_at(5).ctx, line_state::context::code);
+}
+
+TEST_F(CStylerTests, TypingRelexesOnlyTheEditedLine)
+{
+    std::string text;
+    for (int i = 0; i != 10'000; ++i)
+        text += "    int value = compute(" + std::to_string(i) + "); /* comment */\n";
+    store.utf8_string(text);
+
+    nana_source_view::styles::c_style sty{&store};
+    sty.initialize();
+    EXPECT_EQ(sty.relexed_lines(), 10'001);
+
+    type(sty, store.index_from_line(5000) + 4, "x");
+    EXPECT_EQ(sty.relexed_lines(), 1);
+    EXPECT_EQ(styled(sty, 5000).front(), "5000");
+
+    // a new line relexes the two lines it produced.
+    type(sty, store.index_from_line(5000) + 4, "\n");
+    EXPECT_EQ(sty.relexed_lines(), 2);
+    EXPECT_EQ(styled(sty, 5000).size(), 0);
+    EXPECT_EQ(styled(sty, 5001).front(), "5000");
+    EXPECT_EQ(styled(sty, 5002).front(), "int");
+}
+
+TEST_F(CStylerTests, CaretsFarApartAreRestyledSeparately)
+{
+    std::string text;
+    for (int i = 0; i != 10'000; ++i)
+        text += "    int value = compute(" + std::to_string(i) + "); /* comment */\n";
+    store.utf8_string(text);
+
+    nana_source_view::styles::c_style sty{&store};
+    sty.initialize();
+    forwarder forward{&sty};
+    store.add_observer(&forward);
+
+    store.replace_all({
+        {store.index_from_line(100) + 4, 0, "\n"},
+        {store.index_from_line(9000) + 4, 0, "\n"}
+    });
+    store.remove_observer(&forward);
+
+    // the second group is in new line numbers, behind the line the first one inserted.
+    EXPECT_EQ(forward.restyled, (std::vector <std::pair <index_type, index_type>>{{100, 102}, {9001, 9003}}));
+    EXPECT_EQ(sty.relexed_lines(), 2);
+    EXPECT_EQ(styled(sty, 101).front(), "int");
+    EXPECT_EQ(styled(sty, 9002).front(), "int");
+}
+
+TEST_F(CStylerTests, GroupRelexStopsAtTheNextGroup)
+{
+    nana_source_view::styles::c_style sty{&store};
+    sty.initialize();
+    forwarder forward{&sty};
+    store.add_observer(&forward);
+
+    // the comment opened by the first caret reaches the second one, which goes on from there.
+    store.replace_all({
+        {store.index_from_line(1), 0, "/*"},
+        {store.index_from_line(4), 0, "/*"}
+    });
+    EXPECT_EQ(forward.restyled, (std::vector <std::pair <index_type, index_type>>{{1, 4}, {4, 7}}));
+    expect_fresh(sty);
+
+    // closing both again, with a line inserted in front of the second.
+    store.replace_all({
+        {store.index_from_line(2), 0, "*/"},
+        {store.index_from_line(4), 0, "\n*/"}
+    });
+    expect_fresh(sty);
+
+    store.remove_observer(&forward);
+}
+
+TEST_F(CStylerTests, RawStringDelimitersAreInternedOnce)
+{
+    store.utf8_string(
+        "R\"ab(\n"
+        ")ab\";\n"
+        "R\"cd(\n"
+        ")cd\";\n"
+        "R\"ab(\n"
+        ")ab\";\n"
+    );
+
+    nana_source_view::styles::c_style sty{&store};
+    sty.initialize();
+
+    EXPECT_NE(sty.state_at(1).delimiter, 0);
+    EXPECT_NE(sty.state_at(3).delimiter, sty.state_at(1).delimiter);
+    EXPECT_EQ(sty.state_at(5).delimiter, sty.state_at(1).delimiter);
+
+    // a new text starts over.
+    store.utf8_string("R\"cd(\n)cd\";\n");
+    sty.initialize();
+    EXPECT_EQ(sty.state_at(1).delimiter, 1);
+}
+
+TEST_F(CStylerTests, TooManyRawStringDelimitersThrow)
+{
+    // every delimiter of a raw string that spans lines is interned, they do not fit into a line state anymore.
+    std::string text;
+    for (int i = 0; i != 65'536; ++i)
+    {
+        auto const delimiter = std::to_string(i);
+        text += "R\"" + delimiter + "(\n)" + delimiter + "\"\n";
+    }
+    store.utf8_string(text);
+
+    nana_source_view::styles::c_style sty{&store};
+    EXPECT_THROW(sty.initialize(), std::length_error);
+}
+
+TEST_F(CStylerTests, MultiLineConstructs)
+{
+    store.utf8_string(
+        "auto raw = R\"x(first\n"
+        ")\" still)x\";\n"
+        "#define MAX(a, b) \\\n"
+        "    ((a) > (b) ? (a) : (b))\n"
+        "int after;\n"
+    );
+
+    nana_source_view::styles::c_style sty{&store};
+    sty.initialize();
+
+    EXPECT_EQ(sty.state_at(1).ctx, line_state::context::raw_string);
+    EXPECT_EQ(styled(sty, 1), (std::vector <std::string>{")\" still)x\""}));
+
+    EXPECT_TRUE(sty.state_at(3).preprocessor);
+    EXPECT_EQ(styled(sty, 3).size(), 1);
+    EXPECT_FALSE(sty.state_at(4).preprocessor);
+    EXPECT_EQ(styled(sty, 4), (std::vector <std::string>{"int"}));
+}
@@ -37,7 +37,7 @@ TEST_F(DataStoreTests, AddCaret)
 
     EXPECT_EQ(store.caret_count(), 2);
 
-    std::set <caret_type> expectedCarets = {
+    caret_container_type expectedCarets = {
         {0, 0},
         {static_cast <index_type> (store.size()), 0}
     };
@@ -54,3 +54,212 @@ TEST_F(DataStoreTests, Clear)
     EXPECT_EQ(store.caret_begin()->offset, store.size());
     EXPECT_EQ(store.caret_begin()->range, 0);
 }
+
+TEST_F(DataStoreTests, LineIndex)
+{
+    EXPECT_EQ(store.line_count(), 34);
+    EXPECT_EQ(store.index_from_line(0), 0);
+    EXPECT_EQ(store.index_from_line(1), 1);
+    EXPECT_EQ(store.index_from_line(2), 21);
+
+    EXPECT_EQ(store.line_from_index(0), 0);
+    EXPECT_EQ(store.line_from_index(1), 1);
+    EXPECT_EQ(store.line_from_index(20), 1);
+    EXPECT_EQ(store.line_from_index(21), 2);
+    EXPECT_EQ(store.line_from_index(store.size()), 33);
+
+    auto [begin, end] = store.line(1);
+    EXPECT_EQ(std::string(begin, end), "#include <iostream>\n");
+}
+
+TEST_F(DataStoreTests, LineIndexOtherLineEndings)
+{
+    store.utf8_string("a\rb\r\n\r\nc");
+    EXPECT_EQ(store.line_count(), 3);
+
+    store.set_line_end(nana_source_view::line_end_type::CR);
+    EXPECT_EQ(store.line_count(), 4);
+    EXPECT_EQ(store.index_from_line(2), 4);
+
+    store.set_line_end(nana_source_view::line_end_type::CRLF);
+    EXPECT_EQ(store.line_count(), 3);
+    EXPECT_EQ(store.index_from_line(1), 5);
+    EXPECT_EQ(store.index_from_line(2), 7);
+}
+
+TEST_F(DataStoreTests, ClearLeavesOneLine)
+{
+    store.clear();
+
+    EXPECT_EQ(store.line_count(), 1);
+    EXPECT_EQ(store.index_from_line(0), 0);
+}
+
+TEST_F(DataStoreTests, ReplaceAllLikeSingleEdits)
+{
+    struct recorder : nana_source_view::edit_observer
+    {
+        void on_edit(std::vector <nana_source_view::edit_delta> const& deltas) override
+        {
+            ++calls;
+            for (auto const& d : deltas)
+            {
+                bytes += d.inserted - d.removed;
+                lines += d.lines_inserted - d.lines_removed;
+            }
+        }
+        int calls = 0;
+        index_type bytes = 0;
+        index_type lines = 0;
+    };
+
+    std::mt19937 rng{11};
+    for (auto const let : {nana_source_view::line_end_type::LF, nana_source_view::line_end_type::CRLF})
+    {
+        for (int round = 0; round != 50; ++round)
+        {
+            std::string text(2'000, ' ');
+            for (auto& c : text)
+                c = "ab\r\n"[rng() % 4];
+            store.utf8_string(text);
+            store.set_line_end(let);
+
+            std::vector <nana_source_view::data_store::replacement> replacements;
+            std::string expected;
+            index_type read = 0;
+            for (auto at = static_cast <index_type> (rng() % 20); at < static_cast <index_type> (text.size()); at += static_cast <index_type> (rng() % 40))
+            {
+                auto const length = std::min(static_cast <index_type> (rng() % 4), static_cast <index_type> (text.size()) - at);
+                std::string inserted(rng() % 4, ' ');
+                for (auto& c : inserted)
+                    c = "x\r\n"[rng() % 3];
+
+                expected += text.substr(static_cast <std::size_t> (read), static_cast <std::size_t> (at - read)) + inserted;
+                replacements.push_back({at, length, inserted});
+                read = at + length;
+                at += length;
+            }
+            expected += text.substr(static_cast <std::size_t> (read));
+
+            recorder observed;
+            store.add_observer(&observed);
+            auto const lines_before = static_cast <index_type> (store.line_count());
+            auto const undo = store.replace_all(replacements);
+            store.remove_observer(&observed);
+
+            ASSERT_EQ(store.utf8_string(), expected);
+            EXPECT_EQ(observed.calls, 1);
+            EXPECT_EQ(observed.bytes, static_cast <index_type> (expected.size() - text.size()));
+            EXPECT_EQ(observed.lines, static_cast <index_type> (store.line_count()) - lines_before);
+
+            nana_source_view::data_store fresh{expected};
+            fresh.set_line_end(let);
+            ASSERT_EQ(store.line_count(), fresh.line_count());
+            for (index_type line = 0; line != static_cast <index_type> (fresh.line_count()); ++line)
+                EXPECT_EQ(store.index_from_line(line), fresh.index_from_line(line));
+
+            store.replace_all(undo);
+            EXPECT_EQ(store.utf8_string(), text);
+            EXPECT_EQ(store.line_count(), static_cast <std::size_t> (lines_before));
+        }
+    }
+}
+
+TEST_F(DataStoreTests, ReplaceAllMovesCarets)
+{
+    store.utf8_string("one two one two");
+    store.replace_carets({{0, 0}, {5, 0}, {11, 4}, {15, 0}});
+
+    // "one" becomes "1", "two" becomes "three".
+    store.replace_all({{0, 3, "1"}, {4, 3, "three"}, {8, 3, "1"}, {12, 3, "three"}});
+    EXPECT_EQ(store.utf8_string(), "1 three 1 three");
+
+    caret_container_type expectedCarets = {
+        {0, 0},
+        {7, 0},
+        {9, 6},
+        {15, 0}
+    };
+    EXPECT_EQ(store.retrieve_carets(), expectedCarets);
+}
+
+TEST_F(DataStoreTests, ReplaceAllRejectsOverlaps)
+{
+    store.utf8_string("abcdef");
+
+    EXPECT_THROW(store.replace_all({{2, 2, "x"}, {3, 1, "y"}}), std::invalid_argument);
+    EXPECT_THROW(store.replace_all({{4, 0, "x"}, {1, 1, "y"}}), std::invalid_argument);
+    EXPECT_THROW(store.replace_all({{5, 2, "x"}}), std::out_of_range);
+    EXPECT_EQ(store.utf8_string(), "abcdef");
+
+    EXPECT_TRUE(store.replace_all({{3, 0, ""}}).empty());
+    EXPECT_EQ(store.replace_all({{3, 0, "x"}, {3, 1, "y"}}).size(), 2);
+    EXPECT_EQ(store.utf8_string(), "abcxyef");
+}
+
+TEST_F(DataStoreTests, EraseBackwardAtAllCarets)
+{
+    store.utf8_string("a\xC3\xA4" "b\ncd\nef");
+    store.replace_carets({{3, 0}, {4, 0}, {7, 0}, {10, 0}});
+
+    // the umlaut goes as a whole, the carets in front of and behind it meet.
+    store.erase_backward();
+    EXPECT_EQ(store.utf8_string(), "a\nc\ne");
+    caret_container_type expectedCarets = {
+        {1, 0},
+        {3, 0},
+        {5, 0}
+    };
+    EXPECT_EQ(store.retrieve_carets(), expectedCarets);
+
+    store.erase_backward();
+    store.erase_backward();
+    EXPECT_EQ(store.utf8_string(), "");
+    EXPECT_EQ(store.caret_count(), 1);
+    EXPECT_EQ(store.line_count(), 1);
+
+    store.erase_backward();
+    EXPECT_EQ(store.caret_begin()->offset, 0);
+}
+
+TEST_F(DataStoreTests, EraseForwardSelectionsAndWords)
+{
+    store.utf8_string("int value = other;");
+    store.replace_carets({{0, 0}, {9, -5}, {12, 0}});
+
+    // the word and the whitespace behind it, the selection, the word.
+    store.erase_forward(true);
+    EXPECT_EQ(store.utf8_string(), " = ;");
+    EXPECT_EQ(store.caret_count(), 2);
+
+    store.utf8_string("value = other");
+    store.erase_backward(true);
+    EXPECT_EQ(store.utf8_string(), "value = ");
+    store.erase_backward(true);
+    EXPECT_EQ(store.utf8_string(), "value ");
+}
+
+TEST_F(DataStoreTests, EraseWithManyCarets)
+{
+    std::string text;
+    for (int i = 0; i != 50'000; ++i)
+        text += "ab\n";
+    store.utf8_string(text);
+
+    std::vector <caret_type> carets;
+    for (index_type line = 0; line != 50'000; ++line)
+        carets.push_back({line * 3 + 2, 0});
+    store.replace_carets(carets);
+
+    store.erase_backward();
+    store.erase_backward();
+    EXPECT_EQ(store.size(), 50'000);
+    EXPECT_EQ(store.caret_count(), 50'000);
+    EXPECT_EQ(store.line_count(), 50'001);
+
+    // every caret removes the line break in front, they all meet at the beginning.
+    store.erase_backward();
+    EXPECT_EQ(store.utf8_string(), "\n");
+    EXPECT_EQ(store.caret_count(), 1);
+    EXPECT_EQ(store.line_count(), 2);
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/abstractions/fold_tree.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class FoldTreeTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    using fold_tree = nana_source_view::fold_tree;
+    using fold_region = nana_source_view::fold_region;
+    using index_type = fold_tree::index_type;
+    using regions = std::vector <fold_region>;
+
+    void SetUp() override
+    {
+        store.add_observer(&layout);
+        store.add_observer(&folds);
+    }
+
+    void TearDown() override
+    {
+        store.remove_observer(&folds);
+        store.remove_observer(&layout);
+    }
+
+    nana_source_view::data_store store{std::string{
+        "int main()\n"
+        "{\n"
+        "    if (x)\n"
+        "    {\n"
+        "        y();\n"
+        "    }\n"
+        "}\n"
+        "end"
+    }};
+    nana_source_view::wrap_layout layout{&store};
+    fold_tree folds{&store, &layout};
+};
+
+TEST_F(FoldTreeTests, CollapsedLinesHaveNoRows)
+{
+    folds.assign(fold_tree::from_indentation(store));
+    ASSERT_EQ(folds.regions(), (regions{{1, 5, false}, {3, 4, false}}));
+
+    EXPECT_TRUE(folds.collapse(3));
+    EXPECT_FALSE(folds.collapse(3));
+    EXPECT_TRUE(layout.hidden(4));
+    EXPECT_EQ(layout.row_count(), 7);
+
+    // lines 0, 1, 6 and 7 are left.
+    EXPECT_TRUE(folds.collapse(1));
+    EXPECT_EQ(layout.row_count(), 4);
+    EXPECT_EQ(layout.line_of_row(2), std::make_pair(index_type{6}, index_type{0}));
+    EXPECT_EQ(layout.row_of_line(6), 2);
+    EXPECT_EQ(layout.next_visible(1), 6);
+    EXPECT_EQ(layout.previous_visible(6), 1);
+
+    // the nested region stays collapsed.
+    EXPECT_TRUE(folds.expand(1));
+    EXPECT_TRUE(layout.hidden(4));
+    EXPECT_EQ(layout.row_count(), 7);
+    EXPECT_TRUE(folds.toggle(3));
+    EXPECT_EQ(layout.row_count(), 8);
+    EXPECT_FALSE(folds.toggle(0));
+
+    EXPECT_THROW(folds.assign({{1, 4, false}, {3, 6, false}}), std::invalid_argument);
+    EXPECT_THROW(folds.assign({{7, 8, false}}), std::invalid_argument);
+}
+
+TEST_F(FoldTreeTests, RegionsFromBracketsAndIndentation)
+{
+    // ( ) on line 0, 2 and 4, { on 1 and 3, } on 5 and 6.
+    nana_source_view::bracket_index brackets{8};
+    brackets.splice(0, 8, {2, 1, 2, 1, 2, 1, 1, 0}, {
+        {8, '('}, {9, ')'}, {0, '{'}, {7, '('}, {9, ')'}, {4, '{'}, {9, '('}, {10, ')'}, {4, '}'}, {0, '}'}
+    });
+    EXPECT_EQ(fold_tree::from_brackets(brackets), (regions{{1, 5, false}, {3, 4, false}}));
+
+    // blank lines do not end a region.
+    store.utf8_string("def a():\n    x = 1\n\n    y = 2\ndef b():\n    pass\n");
+    EXPECT_EQ(fold_tree::from_indentation(store), (regions{{0, 3, false}, {4, 5, false}}));
+
+    // folding all top level blocks of a large document leaves a row per block.
+    std::string text;
+    for (int i = 0; i != 100'000; ++i)
+        text += "block\n    a\n        b\n    c\n";
+    store.utf8_string(text);
+    folds.assign(fold_tree::from_indentation(store));
+    ASSERT_EQ(folds.regions().size(), 200'000);
+
+    folds.collapse_top_level();
+    EXPECT_EQ(layout.row_count(), 100'001);
+    EXPECT_EQ(layout.line_of_row(50'000), std::make_pair(index_type{200'000}, index_type{0}));
+
+    // regions found again stay collapsed.
+    folds.assign(fold_tree::from_indentation(store));
+    EXPECT_EQ(layout.row_count(), 100'001);
+    folds.expand_all();
+    EXPECT_EQ(layout.row_count(), 400'001);
+}
+
+TEST_F(FoldTreeTests, EditsShiftRegionsAndExpandTouchedOnes)
+{
+    folds.assign(fold_tree::from_indentation(store));
+    folds.collapse(1);
+
+    // lines in front move the regions, typing on a header keeps it collapsed.
+    store.replace_all({{0, 0, "// main\n"}});
+    ASSERT_EQ(folds.regions(), (regions{{2, 6, true}, {4, 5, false}}));
+    store.replace_all({{store.index_from_line(2), 0, " "}});
+    EXPECT_TRUE(folds.regions()[0].collapsed);
+    EXPECT_EQ(layout.row_count(), 5);
+
+    // an edit within a collapsed region expands it.
+    store.replace_all({{store.index_from_line(5), 0, "        z();\n"}});
+    ASSERT_EQ(folds.regions(), (regions{{2, 7, false}, {4, 6, false}}));
+    EXPECT_EQ(layout.row_count(), 10);
+
+    // a header merged into the line in front of it is gone.
+    folds.collapse(4);
+    store.replace_all({{store.index_from_line(4) - 1, 1, ""}});
+    EXPECT_EQ(folds.regions(), (regions{{2, 6, false}}));
+    EXPECT_EQ(layout.row_count(), 9);
+}
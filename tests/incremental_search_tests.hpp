@@ -0,0 +1,93 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/abstractions/incremental_search.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+class IncrementalSearchTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    using find_case = nana_source_view::find_case;
+
+    static std::vector <std::size_t> scan(std::string_view text, std::string_view query, find_case mode = find_case::exact)
+    {
+        std::vector <std::size_t> found;
+        nana_source_view::literal_finder{query, mode}.find_all(text, 0, text.size(), found);
+        return found;
+    }
+};
+
+TEST_F(IncrementalSearchTests, NarrowingFindsLikeAFullScan)
+{
+    std::mt19937 rng{21};
+    std::string text(30'000, 'a');
+    for (auto& c : text)
+        c = "aAb\n"[rng() % 4];
+
+    nana_source_view::data_store store{text};
+    nana_source_view::incremental_search search{&store};
+
+    for (auto const mode : {find_case::exact, find_case::ascii_insensitive})
+    {
+        search.reset();
+        std::string query;
+        for (int typed = 0; typed != 12; ++typed)
+        {
+            query += "aAb"[rng() % 3];
+            EXPECT_EQ(search.update(query, mode), scan(text, query, mode)) << query;
+            EXPECT_EQ(search.narrowed(), typed != 0);
+        }
+    }
+
+    // overlapping positions are kept, a longer query may match where the shorter one was skipped.
+    nana_source_view::data_store overlapping{"aaab"};
+    nana_source_view::incremental_search narrowing{&overlapping};
+    EXPECT_EQ(narrowing.update("aa"), (std::vector <std::size_t>{0}));
+    EXPECT_EQ(narrowing.update("aab"), (std::vector <std::size_t>{1}));
+    EXPECT_TRUE(narrowing.narrowed());
+}
+
+TEST_F(IncrementalSearchTests, OtherChangesScanAgain)
+{
+    nana_source_view::data_store store{"abc abd abc"};
+    nana_source_view::incremental_search search{&store};
+
+    EXPECT_EQ(search.update("abc").size(), 2);
+    EXPECT_EQ(search.update("ab").size(), 3);
+    EXPECT_FALSE(search.narrowed());
+    EXPECT_EQ(search.update("ABD", find_case::ascii_insensitive), (std::vector <std::size_t>{4}));
+    EXPECT_FALSE(search.narrowed());
+    EXPECT_TRUE(search.update("").empty());
+
+    // the first byte of a cyrillic letter differs between its cases, a partial sequence does not narrow.
+    nana_source_view::data_store cyrillic{"ѐ Ѐ"};
+    nana_source_view::incremental_search folding{&cyrillic};
+    EXPECT_EQ(folding.update("\xD0", find_case::utf8_insensitive).size(), 1);
+    EXPECT_EQ(folding.update("Ѐ", find_case::utf8_insensitive).size(), 2);
+    EXPECT_FALSE(folding.narrowed());
+}
+
+TEST_F(IncrementalSearchTests, EditsScanAgain)
+{
+    nana_source_view::data_store store{"one"};
+    nana_source_view::incremental_search search{&store};
+    store.add_observer(&search);
+
+    EXPECT_EQ(search.update("on").size(), 1);
+    store.insert_byte('n');
+    EXPECT_EQ(search.update("on").size(), 1);
+    EXPECT_EQ(search.update("onen"), (std::vector <std::size_t>{0}));
+    EXPECT_TRUE(search.narrowed());
+
+    store.insert_byte('o');
+    store.insert_byte('n');
+    EXPECT_EQ(search.update("on"), (std::vector <std::size_t>{0, 4}));
+    EXPECT_FALSE(search.narrowed());
+    store.remove_observer(&search);
+}
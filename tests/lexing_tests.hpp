@@ -0,0 +1,69 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/lexing/dfa.hpp>
+#include <nana-source-view/lexing/keyword_set.hpp>
+#include <nana-source-view/lexing/scan.hpp>
+
+#include <string>
+
+class LexingTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    static constexpr std::string_view words[] = {"if", "else", "for", "while", "return", "static_assert"};
+};
+
+TEST_F(LexingTests, KeywordSetFindsExactlyItsWords)
+{
+    constexpr auto keywords = nana_source_view::lexing::make_keyword_set(words);
+    static_assert(keywords.contains("while"));
+
+    for (std::size_t i = 0; i != std::size(words); ++i)
+        EXPECT_EQ(keywords.find(words[i]), i);
+
+    EXPECT_FALSE(keywords.contains(""));
+    EXPECT_FALSE(keywords.contains("i"));
+    EXPECT_FALSE(keywords.contains("iff"));
+    EXPECT_FALSE(keywords.contains("retur"));
+    EXPECT_FALSE(keywords.contains("static_asserts"));
+}
+
+TEST_F(LexingTests, ScansCrossBlockBoundaries)
+{
+    using namespace nana_source_view::lexing;
+
+    // longer than two SIMD blocks, so the vector and the scalar part are both used.
+    std::string text = std::string(37, 'a') + "\xC3\xA4_9 \t\t  x\"\\";
+    EXPECT_EQ(skip_identifier(text, 0), 41u);
+    EXPECT_EQ(skip_identifier(text, 41), 41u);
+    EXPECT_EQ(skip_blanks(text, 41), 46u);
+    EXPECT_EQ(find_either(text, 0, '\\', '"'), 47u);
+    EXPECT_EQ(find_either(text, 0, '#', '$'), text.size());
+}
+
+TEST_F(LexingTests, AutomatonTakesTheLongestMatch)
+{
+    using namespace nana_source_view::lexing;
+
+    // "-" and "->" are tokens, "-" followed by ">" must not stop at the shorter one.
+    constexpr auto automaton = []
+    {
+        dfa <4, 3> a{};
+        a.classify("-", 1);
+        a.classify(">", 2);
+        a.transition(1, {1}, 2);
+        a.transition(2, {2}, 3);
+        a.accepts[2] = 1;
+        a.accepts[3] = 2;
+        return a;
+    }();
+
+    EXPECT_EQ(automaton.longest_match("->x", 0, 1).end, 2u);
+    EXPECT_EQ(automaton.longest_match("->x", 0, 1).token, 2);
+    EXPECT_EQ(automaton.longest_match("-x", 0, 1).end, 1u);
+    EXPECT_EQ(automaton.longest_match("-x", 0, 1).token, 1);
+    EXPECT_EQ(automaton.longest_match(">", 0, 1).token, automaton.no_token);
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/abstractions/line_operations.hpp>
+#include <nana-source-view/abstractions/detail/parallel_sort.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+class LineOperationsTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    nana_source_view::data_store store{"pear\napple\npear\nfig"};
+    nana_source_view::line_operations lines{&store};
+};
+
+TEST_F(LineOperationsTests, SortUniqueReverse)
+{
+    // behind the "l" of "apple", the caret goes along.
+    store.replace_carets({{9, 0}});
+
+    auto const undo = lines.sort(0, 3);
+    EXPECT_EQ(store.utf8_string(), "apple\nfig\npear\npear");
+    EXPECT_EQ(store.caret_begin()->offset, 4);
+    EXPECT_EQ(store.line_count(), 4);
+
+    lines.unique(0, 3);
+    EXPECT_EQ(store.utf8_string(), "apple\nfig\npear");
+
+    lines.sort(0, 2, true);
+    EXPECT_EQ(store.utf8_string(), "pear\nfig\napple");
+    lines.reverse(1, 2);
+    EXPECT_EQ(store.utf8_string(), "pear\napple\nfig");
+    EXPECT_EQ(store.caret_begin()->offset, 9);
+
+    EXPECT_TRUE(lines.sort(1, 2).empty());
+    EXPECT_THROW(lines.sort(2, 3), std::out_of_range);
+
+    store.replace_all(lines.unique(0, 0));
+    EXPECT_EQ(store.utf8_string(), "pear\napple\nfig");
+    EXPECT_EQ(undo.size(), 1);
+}
+
+TEST_F(LineOperationsTests, MoveAndDuplicate)
+{
+    // a selection of "apple\npe" touches two lines.
+    store.replace_carets({{13, -8}});
+    auto [first, last] = lines.caret_lines();
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(last, 2);
+
+    lines.move_down(first, last);
+    EXPECT_EQ(store.utf8_string(), "pear\nfig\napple\npear");
+    EXPECT_EQ(store.caret_begin()->offset, 17);
+    EXPECT_EQ(store.caret_begin()->range, -8);
+
+    EXPECT_TRUE(lines.move_down(2, 3).empty());
+    lines.move_up(2, 3);
+    lines.move_up(1, 2);
+    EXPECT_EQ(store.utf8_string(), "apple\npear\npear\nfig");
+    EXPECT_TRUE(lines.move_up(0, 1).empty());
+
+    store.replace_carets({{19, 0}});
+    lines.duplicate(3, 3);
+    EXPECT_EQ(store.utf8_string(), "apple\npear\npear\nfig\nfig");
+    EXPECT_EQ(store.caret_begin()->offset, 23);
+    EXPECT_EQ(store.line_count(), 5);
+}
+
+TEST_F(LineOperationsTests, SortsLikeStdSort)
+{
+    std::mt19937 rng{17};
+    std::vector <std::pair <std::string, int>> values(200'000);
+    for (auto& [text, id] : values)
+    {
+        text = std::string(1 + rng() % 3, static_cast <char> ('a' + rng() % 4));
+        id = static_cast <int> (rng() % 1000);
+    }
+    auto expected = values;
+    std::sort(std::begin(expected), std::end(expected));
+
+    for (std::size_t threads : {1, 2, 3, 8})
+    {
+        auto sorted = values;
+        nana_source_view::detail::parallel_sort(sorted, std::less <> {}, threads);
+        EXPECT_EQ(sorted, expected);
+    }
+
+    std::string text;
+    for (int i = 0; i != 100'000; ++i)
+        text += std::to_string(rng() % 1000) + "\n";
+    store.utf8_string(text);
+    lines.sort(0, static_cast <index_type> (store.line_count()) - 1);
+    auto const sorted = store.view();
+    EXPECT_EQ(sorted.substr(0, 7), "\n0\n0\n0\n");
+    EXPECT_EQ(std::count(std::begin(sorted), std::end(sorted), '\n'), 100'000);
+}
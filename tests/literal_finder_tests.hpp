@@ -0,0 +1,94 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/abstractions/literal_finder.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+class LiteralFinderTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    using finder = nana_source_view::literal_finder;
+    using find_case = nana_source_view::find_case;
+
+    /**
+     *  Non overlapping matches, the straightforward way.
+     */
+    static std::vector <std::size_t> naive_find(std::string const& text, std::string const& needle)
+    {
+        std::vector <std::size_t> result;
+        for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + needle.size()))
+            result.push_back(pos);
+        return result;
+    }
+
+    static std::vector <std::size_t> find_all(finder const& f, std::string_view text)
+    {
+        std::vector <std::size_t> found;
+        f.find_all(text, 0, text.size(), found);
+        return found;
+    }
+};
+
+TEST_F(LiteralFinderTests, FindsLikeStringFind)
+{
+    std::mt19937 rng{5};
+    std::string text(20'000, 'a');
+    for (auto& c : text)
+        c = "aab\n"[rng() % 4];
+
+    for (std::size_t length = 1; length != 24; ++length)
+    {
+        auto const at = rng() % (text.size() - length);
+        auto const needle = text.substr(at, length);
+        EXPECT_EQ(find_all(finder{needle}, text), naive_find(text, needle)) << needle;
+    }
+
+    EXPECT_EQ(find_all(finder{"aa"}, "aaaaa"), (std::vector <std::size_t>{0, 2}));
+    EXPECT_EQ(finder{"b"}.find_next("aaab", 1), 3);
+    EXPECT_EQ(finder{"b"}.find_next("aaa", 0), finder::npos);
+    EXPECT_THROW(finder{""}, std::invalid_argument);
+}
+
+TEST_F(LiteralFinderTests, SlicesFindTheSameMatches)
+{
+    std::mt19937 rng{9};
+    std::string text(50'000, 'x');
+    for (auto& c : text)
+        c = "xyz"[rng() % 3];
+
+    finder const f{"xyzx"};
+    auto const whole = find_all(f, text);
+
+    std::vector <std::size_t> sliced;
+    std::size_t from = 0;
+    for (std::size_t to = 0; to < text.size();)
+    {
+        to = std::min(text.size(), to + 1 + rng() % 700);
+        from = f.find_all(text, from, to, sliced);
+    }
+    EXPECT_EQ(sliced, whole);
+    EXPECT_GT(whole.size(), 100u);
+}
+
+TEST_F(LiteralFinderTests, IgnoresCase)
+{
+    std::string const text = "Return RETURN return Ärger ÄRGER ärger Привет ПРИВЕТ";
+
+    EXPECT_EQ(find_all(finder{"return"}, text).size(), 1);
+    EXPECT_EQ(find_all(finder{"return", find_case::ascii_insensitive}, text).size(), 3);
+    EXPECT_EQ(find_all(finder{"ärger", find_case::ascii_insensitive}, text).size(), 1);
+    EXPECT_EQ(find_all(finder{"ärger", find_case::utf8_insensitive}, text).size(), 3);
+    EXPECT_EQ(find_all(finder{"пРИВЕТ", find_case::utf8_insensitive}, text).size(), 2);
+
+    nana_source_view::data_store store{text};
+    store.replace_carets(finder{"RETURN", find_case::ascii_insensitive}.select_all(store));
+    ASSERT_EQ(store.caret_count(), 3);
+    EXPECT_EQ(store.caret_begin()->offset, 6);
+    EXPECT_EQ(store.caret_begin()->selection_begin(), 0);
+}
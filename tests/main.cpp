@@ -5,6 +5,21 @@
 // following headers expect to be included after gtest headers and source_view
 #include "data_store_tests.hpp"
 #include "navigation_tests.hpp"
+#include "render_tests.hpp"
+#include "style_store_tests.hpp"
+#include "lexing_tests.hpp"
+#include "c_styler_tests.hpp"
+#include "rule_styler_tests.hpp"
+#include "bracket_index_tests.hpp"
+#include "occurrence_index_tests.hpp"
+#include "word_trie_tests.hpp"
+#include "anchor_set_tests.hpp"
+#include "literal_finder_tests.hpp"
+#include "background_search_tests.hpp"
+#include "incremental_search_tests.hpp"
+#include "line_operations_tests.hpp"
+#include "wrap_layout_tests.hpp"
+#include "fold_tree_tests.hpp"
 
 int main(int argc, char** argv)
 {
@@ -184,3 +184,140 @@ TEST_F(NavigationTests, LeftArrowCtrl)
     navi.arrow_left(false, true);
     EXPECT_EQ(store.caret_begin()->offset, 156);
 }
+
+TEST_F(NavigationTests, BoxSelection)
+{
+    store.utf8_string("abcdef\nab\n\xC3\xA4\xC3\xB6\xC3\xBC" "def\n");
+    navi.select_box(0, 1, 3, 4);
+
+    // short lines get a caret at their end, umlauts count as one column.
+    caret_container_type expectedCarets = {
+        {4, -3},
+        {9, -1},
+        {17, -5},
+        {20, 0}
+    };
+    EXPECT_EQ(store.retrieve_carets(), expectedCarets);
+
+    // dragging to the left and upwards keeps the anchor at the other end.
+    navi.select_box(2, 5, 0, 2);
+    expectedCarets = {
+        {2, 3},
+        {9, 0},
+        {14, 4}
+    };
+    EXPECT_EQ(store.retrieve_carets(), expectedCarets);
+
+    EXPECT_THROW(navi.select_box(0, 0, 4, 0), std::out_of_range);
+}
+
+TEST_F(NavigationTests, BoxSelectionCollapsed)
+{
+    store.utf8_string("a\r\nbc\r\ndef");
+    store.set_line_end(nana_source_view::line_end_type::CRLF);
+    navi.select_box(2, 2, 0, 2);
+
+    caret_container_type expectedCarets = {
+        {1, 0},
+        {5, 0},
+        {9, 0}
+    };
+    EXPECT_EQ(store.retrieve_carets(), expectedCarets);
+
+    navi.arrow_left(false, false);
+    EXPECT_EQ(store.caret_begin()->offset, 0);
+    EXPECT_EQ(store.caret_count(), 3);
+}
+
+TEST_F(NavigationTests, UpDownArrowsKeepColumns)
+{
+    store.utf8_string("abcdef\nab\n\xC3\xA4\xC3\xB6\xC3\xBC" "def\n");
+    store.replace_carets({{4, 0}});
+
+    // a short line is gone to its end, umlauts count as one column.
+    navi.arrow_down(false, false);
+    EXPECT_EQ(store.caret_begin()->offset, 9);
+    navi.arrow_down(false, false);
+    EXPECT_EQ(store.caret_begin()->offset, 14);
+    navi.arrow_up(true, false);
+    caret_container_type expectedCarets = {{9, 5}};
+    EXPECT_EQ(store.retrieve_carets(), expectedCarets);
+
+    navi.arrow_up(false, false);
+    navi.arrow_up(false, false);
+    EXPECT_EQ(store.caret_begin()->offset, 0);
+}
+
+TEST_F(NavigationTests, UpDownArrowsGoByRows)
+{
+    // "this " "line is " "wrapped"
+    store.utf8_string("short\nthis line is wrapped\nfolded\n    away\nend");
+    nana_source_view::wrap_layout layout{&store};
+    layout.columns(8);
+    layout.refresh_all(1);
+    layout.hide(3, 4, true);
+    navi.row_layout(&layout);
+
+    store.replace_carets({{2, 0}});
+    navi.arrow_down(false, false);
+    EXPECT_EQ(store.caret_begin()->offset, 8);
+    navi.arrow_down(false, false);
+    EXPECT_EQ(store.caret_begin()->offset, 13);
+    navi.arrow_down(false, false);
+    EXPECT_EQ(store.caret_begin()->offset, 21);
+
+    // the hidden line is skipped.
+    navi.arrow_down(false, false);
+    EXPECT_EQ(store.caret_begin()->offset, 29);
+    navi.arrow_down(false, false);
+    EXPECT_EQ(store.caret_begin()->offset, 45);
+    navi.arrow_up(false, false);
+    EXPECT_EQ(store.caret_begin()->offset, 29);
+}
+
+TEST_F(NavigationTests, BoxSelectionManyLines)
+{
+    std::string csv;
+    for (int i = 0; i != 200'000; ++i)
+        csv += "2024-01-01,some name," + std::to_string(i) + ",42.5\n";
+    store.utf8_string(csv);
+
+    navi.select_box(0, 11, 199'999, 20);
+    EXPECT_EQ(store.caret_count(), 200'000);
+    for (std::size_t i = 0; i < store.caret_count(); i += 9'999)
+    {
+        auto const iter = std::next(store.caret_begin(), static_cast <std::ptrdiff_t> (i));
+        EXPECT_EQ(std::string(store.begin() + iter->selection_begin(), store.begin() + iter->selection_end()), "some name");
+    }
+
+    navi.arrow_right(false, false);
+    EXPECT_EQ(store.caret_count(), 200'000);
+    EXPECT_EQ(store.caret_begin()->offset, 21);
+}
+
+TEST_F(NavigationTests, SelectWordAtOffset)
+{
+    store.utf8_string("int main_loop(x);\n\nend");
+    auto const selection = [this]
+    {
+        auto const caret = *store.caret_begin();
+        return std::string(store.begin() + caret.selection_begin(), store.begin() + caret.selection_end());
+    };
+
+    navi.select_word(6);
+    EXPECT_EQ(selection(), "main_loop");
+    EXPECT_EQ(store.caret_begin()->offset, 13);
+
+    // at the end of a line, the word in front of it.
+    navi.select_word(15);
+    EXPECT_EQ(selection(), ");");
+    navi.select_word(17);
+    EXPECT_EQ(selection(), ");");
+
+    // an empty line has no word, the end of the text has the last one.
+    navi.select_word(18);
+    EXPECT_EQ(store.caret_begin()->offset, 18);
+    EXPECT_EQ(store.caret_begin()->range, 0);
+    navi.select_word(static_cast <int> (store.size()));
+    EXPECT_EQ(selection(), "end");
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/abstractions/occurrence_index.hpp>
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+class OccurrenceIndexTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    /**
+     *  All identifiers of text with their offsets, the straightforward way.
+     */
+    static std::map <std::string, std::vector <index_type>> naive_index(std::string const& text)
+    {
+        using nana_source_view::basic_navigator;
+
+        std::map <std::string, std::vector <index_type>> result;
+        for (std::size_t pos = 0; pos < text.size();)
+        {
+            auto const begin = pos;
+            while (pos < text.size() && basic_navigator::classify(text[pos]) == basic_navigator::basic_character_classes::identifier)
+                ++pos;
+            if (pos == begin)
+                ++pos;
+            else
+                result[text.substr(begin, pos - begin)].push_back(static_cast <index_type> (begin));
+        }
+        return result;
+    }
+};
+
+TEST_F(OccurrenceIndexTests, FindsWholeIdentifiersOnly)
+{
+    nana_source_view::data_store store{
+        "int id = 0;\n"
+        "int identifier = id + id_2;\n"
+        "\n"
+        "return id;"
+    };
+    nana_source_view::occurrence_index index{&store};
+
+    EXPECT_EQ(index.occurrences("id"), (std::vector <index_type>{4, 29, 48}));
+    EXPECT_EQ(index.occurrences("int"), (std::vector <index_type>{0, 12}));
+    EXPECT_EQ(index.count("id_2"), 1);
+    EXPECT_TRUE(index.occurrences("ident").empty());
+
+    EXPECT_EQ(index.word_at(16), "identifier");
+    EXPECT_EQ(index.word_at(6), "id");
+    EXPECT_EQ(index.word_at(7), "");
+}
+
+TEST_F(OccurrenceIndexTests, FollowsEditsLikeARescan)
+{
+    std::mt19937 rng{7};
+    static constexpr char alphabet[] = "ab_ \n.";
+
+    std::string initial;
+    for (int i = 0; i != 2000; ++i)
+        initial.push_back(alphabet[rng() % 6]);
+
+    nana_source_view::data_store store{initial};
+    nana_source_view::occurrence_index index{&store};
+    store.add_observer(&index);
+
+    // several carets at once, some of them ranges, so edits consist of several deltas.
+    for (int round = 0; round != 300; ++round)
+    {
+        auto const size = static_cast <index_type> (store.size());
+        std::vector <caret_type> carets;
+        for (index_type offset = static_cast <index_type> (rng() % 50); offset < size; offset += 50 + static_cast <index_type> (rng() % 400))
+            carets.push_back({offset, std::min <index_type> (static_cast <index_type> (rng() % 4), size - offset)});
+        if (carets.empty())
+            carets.push_back({size, 0});
+
+        store.replace_carets(carets);
+        store.insert_byte(static_cast <std::uint8_t> (alphabet[rng() % 6]));
+    }
+    store.remove_observer(&index);
+
+    auto const expected = naive_index(store.utf8_string());
+    EXPECT_EQ(index.distinct_words(), expected.size());
+    for (auto const& [word, offsets] : expected)
+        EXPECT_EQ(index.occurrences(word), offsets) << word;
+}
+
+TEST_F(OccurrenceIndexTests, SelectsAllOccurrencesAtOnce)
+{
+    nana_source_view::data_store store{"foo(x); bar(foo);\nfoo = foobar;\n"};
+    nana_source_view::occurrence_index index{&store};
+
+    std::vector <caret_type> carets;
+    for (auto offset : index.occurrences("foo"))
+        carets.push_back({offset + 3, -3});
+    store.replace_carets(carets);
+
+    ASSERT_EQ(store.caret_count(), 3);
+    for (auto iter = store.caret_begin(); iter != store.caret_end(); ++iter)
+    {
+        auto const text = store.utf8_string().substr(static_cast <std::size_t> (iter->selection_begin()), 3);
+        EXPECT_EQ(text, "foo");
+    }
+    EXPECT_EQ(store.caret_begin()->offset, 3);
+}
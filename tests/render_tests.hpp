@@ -0,0 +1,577 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/skeleton/text_renderer.hpp>
+#include <nana-source-view/skeleton/paint_sink.hpp>
+#include <nana-source-view/skeleton/sidebar.hpp>
+#include <nana-source-view/skeleton/minimap.hpp>
+#include <nana-source-view/skeleton/caret_blinker.hpp>
+#include <nana-source-view/interfaces/styler.hpp>
+
+/**
+ *  Styles "#include" and every '<' or '>' on lines that start with "#include".
+ */
+class include_styler : public nana_source_view::styler
+{
+public:
+    include_styler(nana_source_view::data_store const* store)
+        : styler{store}
+    {
+    }
+
+    void initialize() override
+    {
+        directive = palette.intern({nana::colors::red, nana::colors::black, nana_source_view::font_flags::bold});
+        bracket = palette.intern({nana::colors::white, nana::colors::black, nana_source_view::font_flags::nothing});
+
+        styles.reset(store->line_count());
+        on_multi_line_change(0, static_cast <index_type> (store->line_count()));
+    }
+
+    void on_multi_line_change(index_type begin, index_type end) override
+    {
+        for (auto line = begin; line != end; ++line)
+        {
+            auto [first, last] = store->line(line);
+            std::string text{first, last};
+
+            std::vector <nana_source_view::style_range> ranges;
+            if (text.rfind("#include", 0) == 0)
+            {
+                ranges.push_back({0, 8, directive});
+                for (std::uint32_t i = 8; i != text.size(); ++i)
+                    if (text[i] == '<' || text[i] == '>')
+                        ranges.push_back({i, 1, bracket});
+            }
+            styles.assign_line(static_cast <std::size_t> (line), std::begin(ranges), std::end(ranges));
+        }
+    }
+
+    nana_source_view::style_id directive = 0;
+    nana_source_view::style_id bracket = 0;
+};
+
+class RenderTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    std::string testData =
+#       include "test_data/data1.txt"
+    ;
+    nana_source_view::data_store store{testData};
+    nana_source_view::skeletons::text_renderer renderer{&store};
+    nana_source_view::skeletons::recording_paint_sink sink{{8, 16}, true};
+};
+
+TEST_F(RenderTests, RendersVisibleLinesOnly)
+{
+    renderer.text_area({0, 0, 800, 16 * 5});
+    renderer.render(sink);
+
+    // line 0 is empty, lines 1 - 4 are includes.
+    EXPECT_EQ(sink.stats().text_runs, 4);
+    ASSERT_EQ(sink.commands().size(), 4);
+    EXPECT_EQ(sink.commands()[0].text, "#include <iostream>");
+    EXPECT_EQ(sink.commands()[0].area.y, 16);
+    EXPECT_EQ(sink.commands()[0].area.width, 19 * 8);
+}
+
+TEST_F(RenderTests, ScrolledRender)
+{
+    renderer.text_area({0, 0, 800, 16 * 2});
+    renderer.update_scroll(6);
+    renderer.render(sink);
+
+    ASSERT_EQ(sink.commands().size(), 2);
+    EXPECT_EQ(sink.commands()[0].text, "int main()");
+    EXPECT_EQ(sink.commands()[0].area.y, 0);
+    EXPECT_EQ(sink.commands()[1].text, "{");
+}
+
+TEST_F(RenderTests, ScrolledPastEnd)
+{
+    renderer.text_area({0, 0, 800, 600});
+    renderer.update_scroll(1000);
+    renderer.render(sink);
+
+    EXPECT_EQ(sink.stats().text_runs, 0);
+}
+
+TEST_F(RenderTests, WrappedLinesAreDrawnInRows)
+{
+    nana_source_view::wrap_layout layout{&store};
+    store.add_observer(&layout);
+
+    // 10 columns: "#include " "<iostream>"
+    renderer.text_area({0, 0, 80, 16 * 3});
+    renderer.row_layout(&layout);
+    renderer.word_wrap(true);
+    renderer.render(sink);
+
+    ASSERT_EQ(sink.commands().size(), 2);
+    EXPECT_EQ(sink.commands()[0].text, "#include ");
+    EXPECT_EQ(sink.commands()[0].area.y, 16);
+    EXPECT_EQ(sink.commands()[1].text, "<iostream>");
+    EXPECT_EQ(sink.commands()[1].area.y, 32);
+    EXPECT_EQ(renderer.visible_lines(), std::make_pair(nana_source_view::data_store::index_type{0}, nana_source_view::data_store::index_type{2}));
+
+    // scrolled into the second row of a line, which sticks to the line.
+    renderer.update_scroll(2);
+    EXPECT_EQ(renderer.scroll_top(), 2);
+    EXPECT_EQ(renderer.line_top(1), -16);
+
+    sink.reset();
+    renderer.render(sink);
+    ASSERT_FALSE(sink.commands().empty());
+    EXPECT_EQ(sink.commands()[0].text, "<iostream>");
+    EXPECT_EQ(sink.commands()[0].area.y, 0);
+
+    store.remove_observer(&layout);
+}
+
+TEST_F(RenderTests, HitTestMapsPixelsToOffsets)
+{
+    using index_type = nana_source_view::data_store::index_type;
+    renderer.text_area({0, 0, 800, 16 * 5});
+    renderer.render(sink);
+    auto const line = store.index_from_line(1);
+
+    // a glyph is passed once the point is right of its middle.
+    EXPECT_EQ(renderer.hit_test(sink, {3, 16}), line);
+    EXPECT_EQ(renderer.hit_test(sink, {4, 20}), line + 1);
+    EXPECT_EQ(renderer.hit_test(sink, {9 * 8 + 5, 31}), line + 10);
+
+    // right of a line is its end, above and below the text its beginning and end.
+    EXPECT_EQ(renderer.hit_test(sink, {700, 16}), line + 19);
+    EXPECT_EQ(renderer.hit_test(sink, {10, -20}), 0);
+    renderer.update_scroll(static_cast <index_type> (store.line_count()) - 1);
+    EXPECT_EQ(renderer.hit_test(sink, {10, 16 * 4}), static_cast <index_type> (store.size()));
+}
+
+TEST_F(RenderTests, HitTestFindsRowsThroughLayout)
+{
+    nana_source_view::wrap_layout layout{&store};
+    store.add_observer(&layout);
+
+    // 10 columns: "#include " "<iostream>", lines 2 and 3 are hidden.
+    renderer.text_area({0, 0, 80, 16 * 5});
+    renderer.row_layout(&layout);
+    renderer.word_wrap(true);
+    layout.hide(2, 4, true);
+    renderer.render(sink);
+    auto const line = store.index_from_line(1);
+
+    EXPECT_EQ(renderer.hit_test(sink, {0, 32}), line + 9);
+    EXPECT_EQ(renderer.hit_test(sink, {5, 32}), line + 10);
+
+    // the end of a wrapped row stays in front of its last glyph.
+    EXPECT_EQ(renderer.hit_test(sink, {700, 16}), line + 8);
+    EXPECT_EQ(renderer.hit_test(sink, {0, 48}), store.index_from_line(4));
+
+    store.remove_observer(&layout);
+}
+
+TEST_F(RenderTests, HitTestOnHugeLineMeasuresVisibleGlyphsOnly)
+{
+    store.utf8_string(std::string(1'000'000, 'x'));
+    renderer.text_area({0, 0, 800, 16 * 5});
+    renderer.render(sink);
+    sink.reset();
+
+    // dragging far right of the area stops at its edge, advances are cached.
+    EXPECT_EQ(renderer.hit_test(sink, {100'000, 0}), 100);
+    EXPECT_EQ(renderer.hit_test(sink, {404, 0}), 51);
+    EXPECT_GE(renderer.position(sink, 0, 500'000).x, 800);
+    EXPECT_LE(sink.stats().measurements, 1);
+}
+
+TEST_F(RenderTests, RowsAreClippedToTheTextArea)
+{
+    store.utf8_string(std::string(1'000'000, 'x') + "\nshort\n");
+    renderer.text_area({0, 0, 804, 16 * 5});
+    renderer.render(sink);
+
+    // the glyph cut by the right border is drawn, none behind it.
+    ASSERT_EQ(sink.commands().size(), 2);
+    EXPECT_EQ(sink.commands()[0].text, std::string(101, 'x'));
+    EXPECT_EQ(sink.commands()[1].text, "short");
+}
+
+TEST_F(RenderTests, StyledRunsAreClippedToTheTextArea)
+{
+    store.utf8_string("#include <" + std::string(200, 'a') + ">\n");
+    auto* sty = renderer.replace_styler <include_styler> ();
+    sty->initialize();
+
+    renderer.text_area({0, 0, 8 * 12, 16 * 2});
+    renderer.render(sink);
+
+    // the closing bracket right of the border is not drawn.
+    ASSERT_EQ(sink.commands().size(), 4);
+    EXPECT_EQ(sink.commands()[0].text, "#include");
+    EXPECT_EQ(sink.commands()[1].text, " ");
+    EXPECT_EQ(sink.commands()[2].text, "<");
+    EXPECT_EQ(sink.commands()[3].text, "aa");
+}
+
+TEST_F(RenderTests, GutterComposesDigitsFromAtlas)
+{
+    nana_source_view::skeletons::sidebar gutter{&store};
+
+    // 34 lines, 2 digits + padding
+    auto width = gutter.width(sink);
+    EXPECT_EQ(width, 2 * 8 + 12);
+
+    gutter.render(sink, {0, 0, width, 16 * 3}, {8, 11}, 16);
+
+    EXPECT_EQ(sink.stats().atlases_made, 1);
+    EXPECT_EQ(sink.stats().text_runs, 0);
+    EXPECT_EQ(sink.stats().blits, 1 + 2 + 2);
+
+    std::string digits;
+    for (auto const& command : sink.commands())
+        if (command.kind == nana_source_view::skeletons::recording_paint_sink::command_kind::blit)
+            digits += command.text;
+
+    // digits are composed right to left.
+    EXPECT_EQ(digits, "90111");
+}
+
+TEST_F(RenderTests, GutterWidthOnlyChangesWithDigitCount)
+{
+    nana_source_view::skeletons::sidebar gutter{&store};
+
+    auto width = gutter.width(sink);
+    gutter.render(sink, {0, 0, width, 16 * 10}, {20, 30}, 16);
+    EXPECT_EQ(gutter.width(sink), width);
+    EXPECT_EQ(sink.stats().atlases_made, 1);
+
+    std::string longer;
+    for (int i = 0; i != 200; ++i)
+        longer += "\n";
+    store.utf8_string(longer);
+
+    EXPECT_EQ(gutter.width(sink), 3 * 8 + 12);
+    EXPECT_EQ(sink.stats().atlases_made, 1);
+}
+
+TEST_F(RenderTests, GutterReleasesItsAtlas)
+{
+    nana_source_view::skeletons::recording_paint_sink other{{8, 16}, false};
+    {
+        nana_source_view::skeletons::sidebar gutter{&store};
+        gutter.width(sink);
+
+        // a color change rebuilds the atlas, drawing to another sink moves it there.
+        gutter.colors(nana::colors::white, nana::colors::black);
+        gutter.width(sink);
+        EXPECT_EQ(sink.stats().atlases_made, 2);
+        EXPECT_EQ(sink.stats().atlases_released, 1);
+
+        gutter.width(other);
+        EXPECT_EQ(sink.stats().atlases_released, 2);
+        EXPECT_EQ(other.stats().atlases_made, 1);
+    }
+    EXPECT_EQ(other.stats().atlases_released, 1);
+}
+
+TEST_F(RenderTests, RecordingSinkReusesReleasedSlots)
+{
+    auto const first = sink.make_atlas("0123", nana::colors::black, nana::colors::white);
+    auto const second = sink.make_atlas("abc", nana::colors::black, nana::colors::white);
+    sink.release_atlas(first);
+
+    // a rebuilt atlas takes the freed slot and draws its own glyphs.
+    auto const rebuilt = sink.make_atlas("xyz", nana::colors::black, nana::colors::white);
+    EXPECT_EQ(rebuilt.id, first.id);
+    EXPECT_NE(rebuilt.id, second.id);
+    sink.blit_glyph(rebuilt, 1, {0, 0});
+    EXPECT_EQ(sink.commands().back().text, "y");
+
+    auto const saved = sink.save_areas({{0, 0, 2, 16}});
+    sink.release_areas(saved);
+    auto const again = sink.save_areas({{8, 16, 2, 16}, {16, 16, 2, 16}});
+    EXPECT_EQ(again, saved);
+    sink.restore_areas(again);
+    EXPECT_EQ(sink.stats().areas_restored, 2);
+    EXPECT_EQ(sink.commands().back().area, (nana::rectangle{16, 16, 2, 16}));
+}
+
+TEST_F(RenderTests, MinimapFollowsEdits)
+{
+    nana_source_view::skeletons::minimap overview{&store};
+    store.add_observer(&overview);
+
+    EXPECT_EQ(overview.summary(9).indent, 4);
+    EXPECT_EQ(overview.summary(9).length, 8);
+
+    // break "    form fm;" into two lines.
+    store.remove_caret(store.caret_begin());
+    store.add_caret(store.index_from_line(9) + 8);
+    store.insert_byte('\n');
+
+    EXPECT_EQ(store.line_count(), 35);
+    EXPECT_EQ(overview.summary(9).indent, 4);
+    EXPECT_EQ(overview.summary(9).length, 4);
+    EXPECT_EQ(overview.summary(10).indent, 1);
+    EXPECT_EQ(overview.summary(10).length, 3);
+    EXPECT_EQ(overview.summary(34).length, 0);
+
+    store.insert_byte(' ');
+    EXPECT_EQ(overview.summary(10).indent, 2);
+
+    store.remove_observer(&overview);
+}
+
+TEST_F(RenderTests, MinimapDownsamplesRows)
+{
+    nana_source_view::skeletons::minimap overview{&store};
+
+    // 34 lines into 8 rows of 2 pixels, 5 lines per row.
+    overview.render(sink, {0, 0, 100, 16}, {0, 10});
+
+    // background + 7 filled rows + viewport frame.
+    EXPECT_EQ(sink.stats().rectangles, 1 + 7 + 1);
+    EXPECT_EQ(sink.stats().text_runs, 0);
+}
+
+TEST_F(RenderTests, MinimapRowsFollowInsertedLines)
+{
+    std::string text;
+    for (int i = 0; i != 20'000; ++i)
+        text += std::string(static_cast <std::size_t> (i % 7), ' ') + std::string(static_cast <std::size_t> (i % 13), 'x') + "\n";
+    store.utf8_string(text);
+
+    nana_source_view::skeletons::minimap overview{&store};
+    store.add_observer(&overview);
+    overview.render(sink, {0, 0, 100, 600}, {0, 10});
+
+    // lines inserted and removed near the top move the lines of all rows behind.
+    store.remove_caret(store.caret_begin());
+    store.add_caret(store.index_from_line(3) + 2);
+    store.insert_byte('\n');
+    store.add_caret(store.index_from_line(40));
+    store.erase_backward(false);
+
+    nana_source_view::skeletons::recording_paint_sink fresh_sink{{8, 16}, true};
+    nana_source_view::skeletons::minimap fresh{&store};
+    sink.reset();
+    overview.render(sink, {0, 0, 100, 600}, {0, 10});
+    fresh.render(fresh_sink, {0, 0, 100, 600}, {0, 10});
+
+    ASSERT_EQ(sink.commands().size(), fresh_sink.commands().size());
+    for (std::size_t i = 0; i != sink.commands().size(); ++i)
+    {
+        EXPECT_EQ(sink.commands()[i].area, fresh_sink.commands()[i].area);
+        EXPECT_EQ(sink.commands()[i].color, fresh_sink.commands()[i].color);
+    }
+    store.remove_observer(&overview);
+}
+
+TEST_F(RenderTests, AdjacentSelectionsMergeIntoOneSpan)
+{
+    renderer.text_area({0, 0, 800, 16 * 5});
+
+    // every character of "#include <iostream>" is selected by its own caret.
+    store.remove_caret(store.caret_begin());
+    for (int i = 0; i != 19; ++i)
+        store.add_caret(store.index_from_line(1) + i, 1);
+
+    renderer.render(sink);
+
+    ASSERT_EQ(sink.commands().size(), 1 + 4);
+    EXPECT_EQ(sink.commands()[0].kind, nana_source_view::skeletons::recording_paint_sink::command_kind::rectangle);
+    EXPECT_EQ(sink.commands()[0].area, (nana::rectangle{0, 16, 19 * 8, 16}));
+}
+
+TEST_F(RenderTests, SelectionAcrossLinesIncludesLineBreaks)
+{
+    renderer.text_area({0, 0, 800, 16 * 5});
+
+    // from "<iostream>" on line 1 to "#include" on line 3, backwards.
+    store.remove_caret(store.caret_begin());
+    auto const begin = store.index_from_line(1) + 9;
+    auto const end = store.index_from_line(3) + 8;
+    store.add_caret(end, begin - end);
+
+    renderer.render(sink);
+
+    std::vector <nana::rectangle> spans;
+    for (auto const& command : sink.commands())
+        if (command.kind == nana_source_view::skeletons::recording_paint_sink::command_kind::rectangle)
+            spans.push_back(command.area);
+
+    ASSERT_EQ(spans.size(), 3);
+    EXPECT_EQ(spans[0], (nana::rectangle{9 * 8, 16, (19 - 9 + 1) * 8, 16}));
+    EXPECT_EQ(spans[1], (nana::rectangle{0, 32, (23 + 1) * 8, 16}));
+    EXPECT_EQ(spans[2], (nana::rectangle{0, 48, 8 * 8, 16}));
+}
+
+TEST_F(RenderTests, OnlyVisibleSelectionsAreSwept)
+{
+    renderer.text_area({0, 0, 800, 16 * 2});
+    renderer.update_scroll(6);
+
+    // a caret above the view selecting into it, one inside and many below.
+    store.remove_caret(store.caret_begin());
+    store.add_caret(store.index_from_line(5), store.index_from_line(6) + 3 - store.index_from_line(5));
+    store.add_caret(store.index_from_line(7), 1);
+    for (int line = 8; line != 30; ++line)
+        store.add_caret(store.index_from_line(line), 1);
+
+    renderer.render(sink);
+
+    EXPECT_EQ(sink.stats().rectangles, 2);
+    EXPECT_EQ(sink.commands()[0].area, (nana::rectangle{0, 0, 3 * 8, 16}));
+    EXPECT_EQ(sink.commands()[1].area, (nana::rectangle{0, 16, 8, 16}));
+}
+
+TEST_F(RenderTests, HighlightsFrameVisibleRangesOnly)
+{
+    renderer.text_area({0, 0, 800, 16 * 5});
+
+    // "#include" on line 1, "<iostream>" into line 2 and a hit far below the view.
+    nana_source_view::anchor_set hits;
+    hits.insert({store.index_from_line(1), store.index_from_line(1) + 8, 0});
+    hits.insert({store.index_from_line(1) + 9, store.index_from_line(2) + 2, 0});
+    hits.insert({store.index_from_line(20), store.index_from_line(20) + 4, 0});
+    renderer.highlight(&hits, nana::colors::orange);
+
+    renderer.render(sink);
+
+    std::vector <nana::rectangle> frames;
+    for (auto const& command : sink.commands())
+        if (command.kind == nana_source_view::skeletons::recording_paint_sink::command_kind::rectangle &&
+            command.color == nana::color{nana::colors::orange})
+            frames.push_back(command.area);
+
+    ASSERT_EQ(frames.size(), 3);
+    EXPECT_EQ(frames[0], (nana::rectangle{0, 16, 8 * 8, 16}));
+    EXPECT_EQ(frames[1], (nana::rectangle{9 * 8, 16, (19 - 9 + 1) * 8, 16}));
+    EXPECT_EQ(frames[2], (nana::rectangle{0, 32, 2 * 8, 16}));
+}
+
+TEST_F(RenderTests, HighlightAgainChangesTheColor)
+{
+    renderer.text_area({0, 0, 800, 16 * 5});
+
+    nana_source_view::anchor_set hits;
+    hits.insert({store.index_from_line(1), store.index_from_line(1) + 8, 0});
+    renderer.highlight(&hits, nana::colors::orange);
+    renderer.highlight(&hits, nana::colors::green);
+
+    renderer.render(sink);
+
+    std::size_t orange = 0;
+    std::size_t green = 0;
+    for (auto const& command : sink.commands())
+    {
+        if (command.kind != nana_source_view::skeletons::recording_paint_sink::command_kind::rectangle)
+            continue;
+        orange += command.color == nana::color{nana::colors::orange};
+        green += command.color == nana::color{nana::colors::green};
+    }
+    EXPECT_EQ(orange, 0);
+    EXPECT_EQ(green, 1);
+}
+
+TEST_F(RenderTests, CaretBlinkOnlyTouchesCaretAreas)
+{
+    using namespace std::chrono_literals;
+    using nana_source_view::skeletons::caret_blinker;
+
+    renderer.text_area({0, 0, 800, 16 * 5});
+    renderer.render(sink);
+
+    // two visible carets on line 1, one far below the view.
+    store.remove_caret(store.caret_begin());
+    store.add_caret(store.index_from_line(1));
+    store.add_caret(store.index_from_line(1) + 9);
+    store.add_caret(store.index_from_line(30));
+
+    caret_blinker carets{&store};
+    auto now = caret_blinker::clock_type::time_point{} + 1h;
+    carets.activity(sink, now);
+    carets.render(renderer, sink, true, now);
+
+    ASSERT_EQ(carets.areas().size(), 2);
+    EXPECT_EQ(carets.areas()[1], (nana::rectangle{9 * 8, 16, 2, 16}));
+    EXPECT_EQ(sink.stats().areas_saved, 2);
+
+    sink.reset();
+
+    // typing keeps the carets solid.
+    EXPECT_FALSE(carets.tick(sink, now + 100ms));
+    EXPECT_TRUE(carets.blinking(now + 100ms));
+
+    EXPECT_TRUE(carets.tick(sink, now + 1s));
+    EXPECT_FALSE(carets.shown());
+    EXPECT_EQ(sink.stats().areas_restored, 2);
+
+    EXPECT_TRUE(carets.tick(sink, now + 1500ms));
+    EXPECT_TRUE(carets.shown());
+
+    // nothing but the carets was drawn.
+    EXPECT_EQ(sink.stats().draw_calls, 2 + 2);
+    EXPECT_EQ(sink.stats().text_runs, 0);
+
+    // an idle editor stops blinking with visible carets.
+    EXPECT_TRUE(carets.tick(sink, now + 2s));
+    EXPECT_TRUE(carets.tick(sink, now + 1min));
+    EXPECT_TRUE(carets.shown());
+    EXPECT_FALSE(carets.blinking(now + 1min));
+}
+
+TEST_F(RenderTests, UnfocusedEditorHasNoCarets)
+{
+    using nana_source_view::skeletons::caret_blinker;
+
+    renderer.text_area({0, 0, 800, 16 * 5});
+    store.remove_caret(store.caret_begin());
+    store.add_caret(store.index_from_line(1));
+
+    caret_blinker carets{&store};
+    carets.render(renderer, sink, false, caret_blinker::clock_type::now());
+
+    EXPECT_TRUE(carets.areas().empty());
+    EXPECT_FALSE(carets.blinking(caret_blinker::clock_type::now()));
+    EXPECT_EQ(sink.stats().rectangles, 0);
+}
+
+TEST_F(RenderTests, PaletteInternsEqualStyles)
+{
+    nana_source_view::style_palette palette;
+    EXPECT_EQ(palette.size(), 1);
+
+    auto red = palette.intern({nana::colors::red, nana::colors::black, nana_source_view::font_flags::nothing});
+    auto bold_red = palette.intern({nana::colors::red, nana::colors::black, nana_source_view::font_flags::bold});
+    EXPECT_NE(red, nana_source_view::style_palette::default_id);
+    EXPECT_NE(red, bold_red);
+    EXPECT_EQ(palette.intern({nana::colors::red, nana::colors::black, nana_source_view::font_flags::nothing}), red);
+    EXPECT_EQ(palette[bold_red].font_mods, nana_source_view::font_flags::bold);
+    EXPECT_EQ(palette.size(), 3);
+
+    EXPECT_LE(sizeof(nana_source_view::style_range), 12);
+}
+
+TEST_F(RenderTests, StyledLinesAreDrawnInRuns)
+{
+    auto* sty = renderer.replace_styler <include_styler> ();
+    sty->initialize();
+
+    renderer.text_area({0, 0, 800, 16 * 2});
+    renderer.render(sink);
+
+    // the brackets share a style, but are not neighbours.
+    ASSERT_EQ(sink.commands().size(), 5);
+    EXPECT_EQ(sink.commands()[0].text, "#include");
+    EXPECT_EQ(sink.commands()[0].color, nana::color{nana::colors::red});
+    EXPECT_EQ(sink.commands()[1].text, " ");
+    EXPECT_EQ(sink.commands()[2].text, "<");
+    EXPECT_EQ(sink.commands()[2].area.x, 9 * 8);
+    EXPECT_EQ(sink.commands()[3].text, "iostream");
+    EXPECT_EQ(sink.commands()[3].area.x, 10 * 8);
+    EXPECT_EQ(sink.commands()[4].text, ">");
+}
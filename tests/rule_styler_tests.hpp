@@ -0,0 +1,117 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/rule_styler.hpp>
+
+#include <string>
+#include <vector>
+
+class RuleStylerTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    using rule_style = nana_source_view::styles::rule_style;
+
+    static nana_source_view::style make_style(unsigned rgb)
+    {
+        return {static_cast <nana::color_rgb> (rgb), static_cast <nana::color_rgb> (0x303030), 0};
+    }
+
+    /**
+     *  A small C like language.
+     */
+    static nana_source_view::styles::rule_set c_like()
+    {
+        return {
+            {
+                {"if|else|return", make_style(0x569CD6)},
+                {"[A-Za-z_]\\w*", std::nullopt},
+                {"\\d+(\\.\\d+)?", make_style(0xB5CEA8)}
+            },
+            {
+                {"/\\*", "\\*/", make_style(0x6A9955), {}},
+                {"//", "", make_style(0x6A9955), {}},
+                {"\"", "\"", make_style(0xCE9178), {{"\\\\.", make_style(0xD7BA7D)}}, true}
+            }
+        };
+    }
+
+    std::vector <std::string> styled(rule_style& sty, index_type line)
+    {
+        auto [begin, end] = store.line(line);
+        std::string text{begin, end};
+
+        std::vector <std::string> result;
+        for (auto const& range : sty.styles_on_line(line))
+            result.push_back(text.substr(range.start, range.length));
+        return result;
+    }
+
+    void type(rule_style& sty, index_type offset, std::string const& text)
+    {
+        store.remove_caret(store.caret_begin());
+        store.add_caret(offset);
+
+        auto const line = store.line_from_index(offset);
+        for (auto c : text)
+            store.insert_byte(c);
+        sty.on_multi_line_change(line, line + 1);
+    }
+
+    nana_source_view::data_store store{
+        "if (iffy == 4.5) return \"a\\\"b\"; // done\n"
+        "x = 1;\n"
+        "y = 2;\n"
+        "z = 3;\n"
+    };
+};
+
+TEST_F(RuleStylerTests, StylesTokensAndScopes)
+{
+    rule_style sty{&store, c_like()};
+    sty.initialize();
+
+    // the identifier rule keeps "if" from matching within "iffy", the escape splits the string.
+    EXPECT_EQ(styled(sty, 0), (std::vector <std::string>{"if", "4.5", "return", "\"a", "\\\"", "b\"", "// done"}));
+    EXPECT_EQ(styled(sty, 1), (std::vector <std::string>{"1"}));
+    EXPECT_EQ(sty.scope_at(1), 0);
+    EXPECT_EQ(sty.get_palette().size(), 6);
+}
+
+TEST_F(RuleStylerTests, ScopesSpanLinesAndRestyleIncrementally)
+{
+    rule_style sty{&store, c_like()};
+    sty.initialize();
+
+    type(sty, store.index_from_line(1), "/*");
+    EXPECT_EQ(sty.relexed_lines(), 4);
+    EXPECT_EQ(sty.scope_at(3), 1);
+    EXPECT_EQ(styled(sty, 2), (std::vector <std::string>{"y = 2;"}));
+
+    type(sty, store.index_from_line(2) + 1, "*/");
+    EXPECT_EQ(styled(sty, 2), (std::vector <std::string>{"y*/", "2"}));
+    EXPECT_EQ(sty.scope_at(3), 0);
+
+    // typing within a line that keeps its scopes only relexes that line.
+    type(sty, store.index_from_line(3) + 4, "7");
+    EXPECT_EQ(sty.relexed_lines(), 1);
+    EXPECT_EQ(styled(sty, 3), (std::vector <std::string>{"73"}));
+}
+
+TEST_F(RuleStylerTests, MalformedRulesAreRejected)
+{
+    auto rules_with = [](std::string const& pattern)
+    {
+        nana_source_view::styles::rule_set rules;
+        rules.tokens.push_back({pattern, std::nullopt});
+        return rules;
+    };
+
+    EXPECT_THROW((rule_style{&store, rules_with("(a")}), std::invalid_argument);
+    EXPECT_THROW((rule_style{&store, rules_with("[a-")}), std::invalid_argument);
+    EXPECT_THROW((rule_style{&store, rules_with("*")}), std::invalid_argument);
+    EXPECT_THROW((rule_style{&store, rules_with("a*")}), std::invalid_argument);
+    EXPECT_NO_THROW((rule_style{&store, rules_with("a+|[^a]")}));
+}
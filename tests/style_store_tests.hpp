@@ -0,0 +1,146 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/abstractions/detail/line_arena.hpp>
+
+#include <numeric>
+#include <random>
+#include <vector>
+
+class StyleStoreTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    using arena_type = nana_source_view::detail::line_arena <int>;
+
+    static std::vector <int> values(arena_type::lines_view const& view)
+    {
+        return {std::begin(view), std::end(view)};
+    }
+
+    /**
+     *  3 lines: {1, 2}, {}, {3, 4, 5}
+     */
+    arena_type make_arena()
+    {
+        arena_type arena{3};
+        std::vector <int> v{1, 2, 3, 4, 5};
+        arena.splice(0, 3, {2, 0, 3}, std::begin(v), std::end(v));
+        return arena;
+    }
+};
+
+TEST_F(StyleStoreTests, LinesAreContiguous)
+{
+    auto arena = make_arena();
+
+    EXPECT_EQ(arena.line_count(), 3);
+    EXPECT_EQ(values(arena.lines(0, 3)), (std::vector <int>{1, 2, 3, 4, 5}));
+    EXPECT_EQ(values(arena.lines(1, 3)), (std::vector <int>{3, 4, 5}));
+    EXPECT_TRUE(arena.line(1).empty());
+    EXPECT_EQ(values(arena.lines(0, 3).line(2)), (std::vector <int>{3, 4, 5}));
+
+    // clamped
+    EXPECT_EQ(values(arena.lines(2, 100)), (std::vector <int>{3, 4, 5}));
+    EXPECT_TRUE(arena.lines(50, 100).empty());
+}
+
+TEST_F(StyleStoreTests, AssignLineOnlyTouchesThatLine)
+{
+    auto arena = make_arena();
+
+    std::vector <int> v{7, 8, 9};
+    arena.assign_line(1, std::begin(v), std::end(v));
+    EXPECT_EQ(values(arena.lines(0, 3)), (std::vector <int>{1, 2, 7, 8, 9, 3, 4, 5}));
+
+    arena.assign_line(0, std::end(v), std::end(v));
+    EXPECT_EQ(values(arena.line(0)), (std::vector <int>{}));
+    EXPECT_EQ(values(arena.line(1)), (std::vector <int>{7, 8, 9}));
+    EXPECT_EQ(values(arena.line(2)), (std::vector <int>{3, 4, 5}));
+}
+
+TEST_F(StyleStoreTests, SpliceChangesLineCount)
+{
+    auto arena = make_arena();
+
+    // line 1 splits into 3 lines.
+    std::vector <int> v{6, 7};
+    arena.splice(1, 2, {1, 0, 1}, std::begin(v), std::end(v));
+    EXPECT_EQ(arena.line_count(), 5);
+    EXPECT_EQ(values(arena.line(1)), (std::vector <int>{6}));
+    EXPECT_TRUE(arena.line(2).empty());
+    EXPECT_EQ(values(arena.line(3)), (std::vector <int>{7}));
+    EXPECT_EQ(values(arena.line(4)), (std::vector <int>{3, 4, 5}));
+
+    // lines 0 - 3 join into one.
+    arena.splice(0, 4, {1}, std::begin(v), std::begin(v) + 1);
+    EXPECT_EQ(arena.line_count(), 2);
+    EXPECT_EQ(values(arena.line(0)), (std::vector <int>{6}));
+    EXPECT_EQ(values(arena.line(1)), (std::vector <int>{3, 4, 5}));
+    EXPECT_EQ(arena.size(), 4);
+}
+
+TEST_F(StyleStoreTests, SplicesAcrossBlocksMatchPlainLines)
+{
+    // lines spread over many blocks, spliced at random, compared to one vector per line.
+    std::mt19937 rng{5};
+    std::vector <std::vector <int>> expected(1'000);
+    arena_type arena{expected.size()};
+
+    int next = 0;
+    for (int round = 0; round != 2'000; ++round)
+    {
+        auto const begin = rng() % (expected.size() + 1);
+        auto const end = std::min <std::size_t> (expected.size(), begin + rng() % (round % 50 == 0 ? 300 : 4));
+
+        std::vector <std::size_t> sizes(rng() % 5);
+        std::vector <int> v;
+        std::vector <std::vector <int>> lines;
+        for (auto& size : sizes)
+        {
+            size = rng() % 4;
+            lines.emplace_back();
+            for (std::size_t i = 0; i != size; ++i)
+            {
+                v.push_back(next);
+                lines.back().push_back(next++);
+            }
+        }
+        arena.splice(begin, end, sizes, std::begin(v), std::end(v));
+        expected.erase(std::begin(expected) + static_cast <std::ptrdiff_t> (begin), std::begin(expected) + static_cast <std::ptrdiff_t> (end));
+        expected.insert(std::begin(expected) + static_cast <std::ptrdiff_t> (begin), std::begin(lines), std::end(lines));
+    }
+
+    ASSERT_EQ(arena.line_count(), expected.size());
+    std::vector <int> all;
+    for (std::size_t line = 0; line != expected.size(); ++line)
+    {
+        EXPECT_EQ(values(arena.line(line)), expected[line]) << "line " << line;
+        all.insert(std::end(all), std::begin(expected[line]), std::end(expected[line]));
+    }
+    EXPECT_EQ(values(arena.lines(0, expected.size())), all);
+    EXPECT_EQ(arena.size(), all.size());
+    EXPECT_EQ(arena.lines(0, expected.size()).size(), all.size());
+}
+
+TEST_F(StyleStoreTests, LineIteratorsAreRandomAccess)
+{
+    std::vector <int> v(200);
+    std::iota(std::begin(v), std::end(v), 0);
+    arena_type arena{100};
+    arena.splice(0, 100, std::vector <std::size_t> (100, 2), std::begin(v), std::end(v));
+
+    // a view over many blocks walks backwards and jumps.
+    auto const view = arena.lines(10, 90);
+    EXPECT_EQ(std::end(view) - std::begin(view), 160);
+    EXPECT_EQ(*(std::begin(view) + 150), 170);
+    EXPECT_EQ(*std::prev(std::end(view)), 179);
+    EXPECT_EQ(*std::lower_bound(std::begin(view), std::end(view), 99), 99);
+
+    std::vector <int> reversed{std::make_reverse_iterator(std::end(view)), std::make_reverse_iterator(std::begin(view))};
+    EXPECT_EQ(reversed.size(), 160);
+    EXPECT_EQ(reversed.front(), 179);
+    EXPECT_EQ(reversed.back(), 20);
+}
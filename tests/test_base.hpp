@@ -11,6 +11,7 @@ class TestBase
 public:
     using caret_type = nana_source_view::data_store::caret_type;
     using index_type = caret_type::index_type;
+    using caret_container_type = nana_source_view::data_store::caret_container_type;
 
 protected:
     std::default_random_engine gen;
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/abstractions/word_trie.hpp>
+#include <nana-source-view/abstractions/occurrence_index.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+class WordTrieTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    using candidates = std::vector <nana_source_view::word_trie::candidate>;
+};
+
+TEST_F(WordTrieTests, CompletesMostFrequentFirst)
+{
+    nana_source_view::word_trie trie;
+    trie.add("index", 5);
+    trie.add("indent", 2);
+    trie.add("in", 7);
+    trie.add("int", 2);
+    trie.add("out", 9);
+
+    EXPECT_EQ(trie.complete("ind", 5), (candidates{{"index", 5}, {"indent", 2}}));
+    EXPECT_EQ(trie.complete("in", 3), (candidates{{"in", 7}, {"index", 5}, {"indent", 2}}));
+    EXPECT_EQ(trie.complete("", 1), (candidates{{"out", 9}}));
+    EXPECT_TRUE(trie.complete("x", 3).empty());
+
+    // words vanish at 0.
+    trie.add("in", -7);
+    trie.add("index", -5);
+    EXPECT_EQ(trie.size(), 3);
+    EXPECT_EQ(trie.frequency("index"), 0);
+    EXPECT_EQ(trie.complete("in", 3), (candidates{{"indent", 2}, {"int", 2}}));
+}
+
+TEST_F(WordTrieTests, CompletesLikeSorting)
+{
+    std::mt19937 rng{3};
+    std::map <std::string, std::size_t> frequencies;
+    nana_source_view::word_trie trie;
+
+    for (int round = 0; round != 3000; ++round)
+    {
+        std::string word(1 + rng() % 4, 'a');
+        for (auto& c : word)
+            c = static_cast <char> ('a' + rng() % 3);
+
+        auto& frequency = frequencies[word];
+        auto const delta = frequency != 0 && rng() % 3 == 0 ? -static_cast <std::ptrdiff_t> (1 + rng() % frequency) : static_cast <std::ptrdiff_t> (1 + rng() % 5);
+        frequency = static_cast <std::size_t> (static_cast <std::ptrdiff_t> (frequency) + delta);
+        trie.add(word, delta);
+    }
+
+    for (auto const& prefix : {"", "a", "ab", "cca", "b"})
+    {
+        candidates expected;
+        for (auto const& [word, frequency] : frequencies)
+            if (frequency != 0 && word.compare(0, std::string{prefix}.size(), prefix) == 0)
+                expected.push_back({word, frequency});
+        std::stable_sort(std::begin(expected), std::end(expected), [](auto const& lhs, auto const& rhs)
+        {
+            return lhs.frequency > rhs.frequency;
+        });
+        expected.resize(std::min <std::size_t> (expected.size(), 10));
+
+        EXPECT_EQ(trie.complete(prefix, 10), expected) << prefix;
+    }
+}
+
+TEST_F(WordTrieTests, FollowsTheDocument)
+{
+    nana_source_view::data_store store{"value = values[0] + value;\n"};
+    nana_source_view::occurrence_index index{&store};
+    store.add_observer(&index);
+    EXPECT_EQ(index.complete("val", 5), (candidates{{"value", 2}, {"values", 1}}));
+
+    store.remove_caret(store.caret_begin());
+    store.add_caret(static_cast <index_type> (store.size()));
+    for (auto c : std::string{"values valid\n"})
+        store.insert_byte(c);
+    EXPECT_EQ(index.complete("val", 5), (candidates{{"value", 2}, {"values", 2}, {"valid", 1}}));
+
+    store.remove_observer(&index);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "test_base.hpp"
+
+#include <nana-source-view/abstractions/wrap_layout.hpp>
+
+#include <string>
+#include <vector>
+
+class WrapLayoutTests
+    : public TestBase
+    , public ::testing::Test
+{
+protected:
+    using wrap_layout = nana_source_view::wrap_layout;
+    using points = std::vector <wrap_layout::index_type>;
+
+    nana_source_view::data_store store{std::string{"short\nthis line is wrapped\n\nend"}};
+    wrap_layout layout{&store};
+};
+
+TEST_F(WrapLayoutTests, WrapsBehindBlanksOrWithinWords)
+{
+    EXPECT_EQ(wrap_layout::wrap("hello world foo", 6), (points{6, 12}));
+    EXPECT_EQ(wrap_layout::wrap("abcdefgh", 3), (points{3, 6}));
+    EXPECT_EQ(wrap_layout::wrap("abc", 3), points{});
+    EXPECT_EQ(wrap_layout::wrap("abc", 0), points{});
+
+    // columns are code points.
+    EXPECT_EQ(wrap_layout::wrap("\xC3\xA4\xC3\xB6\xC3\xBC", 2), points{4});
+}
+
+TEST_F(WrapLayoutTests, RowsMapToLines)
+{
+    layout.columns(8);
+    EXPECT_TRUE(layout.stale());
+    EXPECT_EQ(layout.row_count(), 4);
+
+    // "this " "line is " "wrapped"
+    layout.refresh_all(1);
+    EXPECT_FALSE(layout.stale());
+    EXPECT_EQ(layout.wrap_points(1), (points{5, 13}));
+    EXPECT_EQ(layout.rows(1), 3);
+    EXPECT_EQ(layout.row_count(), 6);
+
+    EXPECT_EQ(layout.row_of_line(2), 4);
+    EXPECT_EQ(layout.row_of_line(4), 6);
+    EXPECT_EQ(layout.line_of_row(0), std::make_pair(wrap_layout::index_type{0}, wrap_layout::index_type{0}));
+    EXPECT_EQ(layout.line_of_row(3), std::make_pair(wrap_layout::index_type{1}, wrap_layout::index_type{2}));
+    EXPECT_EQ(layout.line_of_row(5), std::make_pair(wrap_layout::index_type{3}, wrap_layout::index_type{0}));
+    EXPECT_EQ(layout.line_of_row(6), std::make_pair(wrap_layout::index_type{4}, wrap_layout::index_type{0}));
+
+    // visible lines can be wrapped before the others.
+    layout.columns(6);
+    EXPECT_TRUE(layout.refresh(1, 2));
+    EXPECT_FALSE(layout.refresh(1, 2));
+    EXPECT_TRUE(layout.stale());
+    layout.refresh_all(1);
+    EXPECT_FALSE(layout.stale());
+
+    layout.columns(0);
+    EXPECT_FALSE(layout.enabled());
+    EXPECT_EQ(layout.row_count(), 4);
+    EXPECT_EQ(layout.line_of_row(2), std::make_pair(wrap_layout::index_type{2}, wrap_layout::index_type{0}));
+}
+
+TEST_F(WrapLayoutTests, EditsRewrapTouchedLines)
+{
+    store.add_observer(&layout);
+    layout.columns(8);
+    layout.refresh_all(1);
+
+    store.replace_carets({{5, 0}});
+    store.replace_all({{5, 0, " and now much longer\nnew"}});
+    ASSERT_EQ(store.line_count(), 5);
+
+    // only the touched lines were wrapped, the others stay stale after a change of columns.
+    EXPECT_FALSE(layout.stale());
+    EXPECT_EQ(layout.rows(0), static_cast <wrap_layout::index_type> (wrap_layout::wrap("short and now much longer", 8).size() + 1));
+    EXPECT_EQ(layout.rows(1), 1);
+    EXPECT_EQ(layout.rows(2), 3);
+    EXPECT_EQ(layout.row_count(), layout.rows(0) + 1 + 3 + 1 + 1);
+
+    store.replace_all({{0, static_cast <wrap_layout::index_type> (store.size()), "x"}});
+    EXPECT_EQ(layout.row_count(), 1);
+    store.remove_observer(&layout);
+}